@@ -0,0 +1,148 @@
+// Benchmark: std::map<std::string, DeviceInfo> vs. MacHashTable<DeviceInfo>
+//
+// Misst pro Advertisement das Nachschlagen/Anlegen eines Geraets und einen
+// vollstaendigen Durchlauf ueber alle Eintraege (wie loop() und
+// findAndTrackClosestBeacon), jeweils bei 10, 1.000 und 10.000 Geraeten.
+//
+// Build und Aufruf auf dem Host:
+//   g++ -std=gnu++17 -O2 -Isrc bench/device_table_bench.cpp -o device_table_bench
+//   ./device_table_bench
+//
+// Ausgabe: eine Zeile pro Messung, "key=value" getrennt durch Leerzeichen.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+#include "MacHashTable.h"
+
+namespace {
+
+unsigned long allocationCount = 0;
+
+// Gleiche Groesse und Heap-Struktur wie DeviceInfo (vier Strings, zwei Vektoren)
+struct BenchDeviceInfo {
+  int rssi = 0;
+  float rawDistance = 0;
+  float filteredDistance = 0;
+  float avgRssi = 0;
+  float avgDistance = 0;
+  std::string name;
+  std::string manufacturerId;
+  std::string manufacturerName;
+  std::string serviceUUID;
+  unsigned long lastSeen = 0;
+  float kalman[5] = {0};
+  std::vector<float> rssiWindow = std::vector<float>(5, 0);
+  std::vector<float> distanceWindow = std::vector<float>(5, 0);
+};
+
+typedef std::chrono::steady_clock Clock;
+
+double nsPerOp(Clock::time_point start, Clock::time_point end, unsigned long ops) {
+  return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+std::vector<MacAddress> makeAddresses(size_t count) {
+  std::vector<MacAddress> addresses;
+  uint64_t x = 0x2545F4914F6CDD1DULL;
+  for (size_t i = 0; i < count; i++) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    addresses.push_back(x & 0xFFFFFFFFFFFFULL);
+  }
+  return addresses;
+}
+
+void report(const char* impl, const char* op, size_t devices, double ns, double allocs) {
+  printf("bench=device_table impl=%s op=%s devices=%zu ns_per_op=%.1f allocs_per_op=%.3f\n",
+         impl, op, devices, ns, allocs);
+}
+
+void benchMap(const std::vector<MacAddress>& addresses, unsigned long advertisements) {
+  std::map<std::string, BenchDeviceInfo> map;
+  size_t n = addresses.size();
+
+  // Wie onResult: Adresse als String erzeugen, dann map[...]
+  unsigned long allocsBefore = allocationCount;
+  auto start = Clock::now();
+  for (unsigned long i = 0; i < advertisements; i++) {
+    std::string key = macToString(addresses[i % n]).text;
+    BenchDeviceInfo& device = map[key];
+    device.rssi = (int)i;
+    device.lastSeen = i;
+  }
+  auto end = Clock::now();
+  report("std_map", "lookup_insert", n, nsPerOp(start, end, advertisements),
+         (double)(allocationCount - allocsBefore) / advertisements);
+
+  // Wie loop(): alle Eintraege durchlaufen
+  unsigned long passes = 1 + 1000000 / n;
+  volatile int sink = 0;
+  start = Clock::now();
+  for (unsigned long p = 0; p < passes; p++) {
+    for (auto const& pair : map) {
+      if (pair.second.filteredDistance <= 1.0f) sink = sink + 1;
+    }
+  }
+  end = Clock::now();
+  report("std_map", "iterate_entry", n, nsPerOp(start, end, passes * n), 0);
+}
+
+void benchTable(const std::vector<MacAddress>& addresses, unsigned long advertisements) {
+  size_t n = addresses.size();
+  unsigned long allocsBefore = allocationCount;
+  MacHashTable<BenchDeviceInfo> table(n);
+  unsigned long setupAllocs = allocationCount - allocsBefore;
+
+  allocsBefore = allocationCount;
+  auto start = Clock::now();
+  for (unsigned long i = 0; i < advertisements; i++) {
+    BenchDeviceInfo& device = table.findOrInsert(addresses[i % n], (uint32_t)i);
+    device.rssi = (int)i;
+    device.lastSeen = i;
+  }
+  auto end = Clock::now();
+  report("mac_table", "lookup_insert", n, nsPerOp(start, end, advertisements),
+         (double)(allocationCount - allocsBefore) / advertisements);
+
+  unsigned long passes = 1 + 1000000 / n;
+  volatile int sink = 0;
+  start = Clock::now();
+  for (unsigned long p = 0; p < passes; p++) {
+    table.forEach([&](MacAddress, BenchDeviceInfo& device) {
+      if (device.filteredDistance <= 1.0f) sink = sink + 1;
+    });
+  }
+  end = Clock::now();
+  report("mac_table", "iterate_entry", n, nsPerOp(start, end, passes * n), 0);
+  printf("bench=device_table impl=mac_table op=setup devices=%zu slots=%zu allocs=%lu\n",
+         n, table.slotCount(), setupAllocs);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  allocationCount++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+int main() {
+  const size_t populations[] = {10, 1000, 10000};
+  const unsigned long advertisements = 2000000;
+  for (size_t devices : populations) {
+    std::vector<MacAddress> addresses = makeAddresses(devices);
+    benchMap(addresses, advertisements);
+    benchTable(addresses, advertisements);
+  }
+  return 0;
+}
@@ -0,0 +1,561 @@
+// Benchmark: Kosten pro Advertisement, Stufe fuer Stufe
+//
+// Misst ns/op und Allokationen/op fuer die Stationen eines Advertisements
+// durch die Firmware: rssiToMeters, isDeviceInFilter, KalmanFilter::update,
+// MovingAverageFilter::update, Nachschlagen/Anlegen in der Geraetetabelle,
+// das Dekodieren in onResult, processAdvertisement (auch das Verwerfen
+// unbekannter Geraete ausserhalb des Schwellenwerts), generateBeaconJSON,
+// countDevicesInRange, generateDevicesJSON (in einen Puffer und als Stream)
+// und den gesamten Weg ab onResult. Tabellen- und filterabhaengige Stufen
+// laufen bei mehreren Geraete- bzw. Filtergroessen.
+//
+// filter_scalar und filter_bank vergleichen die Filter pro Messung: einzeln
+// in Objekten pro Geraet bzw. gesammelt in der FilterBank, die einmal pro
+// Tracking-Durchlauf rechnet (Kosten von update anteilig enthalten).
+// filter_bank_check gibt die groesste Abweichung zwischen beiden aus. Mit
+// -DFILTER_BANK=1 gebaut (pio run -e bench_filter_bank) laufen auch
+// process_advertisement und advertisement_total ueber die FilterBank.
+//
+// device_record gibt den Speicher pro Geraet aus: den Eintrag in deviceTable
+// (Slot samt Schluessel und Zeitstempel, anteilig fuer die freien Slots), den
+// Anteil am Namensvorrat und den Heap, den processAdvertisement fuer neue
+// Geraete mit langen Namen und 128-Bit-Service-UUID anfordert. Die Werte
+// gelten fuer den Host (64 Bit); auf dem ESP32 gibt setup() die Groessen aus.
+//
+// scan_window laesst ein Scan-Fenster ueber den Schein-Scanner von NativeHAL
+// laufen (jede Adresse mehrfach, wie mit Duplikaten) und gibt aus, wie viele
+// Ergebnisse NimBLE behaelt, wie weit der Heap waehrend des Fensters ueber den
+// Stand bei Fensterbeginn steigt und welche Geraeteanzahl die Firmware meldet.
+// mode=streaming ist setMaxResults(0) wie mit STREAMING_SCAN, mode=retained
+// der fruehere Betrieb mit allen Ergebnissen bis clearResults().
+//
+// Build und Aufruf auf dem Host (gegen lib/NativeHAL, ohne src/main.cpp):
+//   pio run -e bench && .pio/build/bench/program > bench.txt
+//   tools/bench_compare.py alt.txt bench.txt
+//
+// Ausgabe: eine Zeile pro Messung, "key=value" getrennt durch Leerzeichen.
+// Allokationen zaehlen operator new; auf dem Host laeuft auch String ueber
+// operator new, auf dem ESP32 ueber malloc - die Zahl ist also eine
+// Obergrenze fuer Heap-Aufrufe. decode_advertisement liest den Payload
+// selbst (parseAdvertisingData) und haengt daher kaum von NativeHAL ab;
+// payload=long_name_uuid128 ist ein Advertisement mit langem Namen.
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <vector>
+#include "NativeHAL.h"
+#include "Config.h"
+#include "ConfigManager.h"
+#include "BLEScanner.h"
+#include "DeviceInfo.h"
+#include "Filters.h"
+#include "FilterBank.h"
+#include "JsonUtils.h"
+#include "BeaconTracker.h"
+
+namespace {
+
+unsigned long allocationCount = 0;
+unsigned long allocatedBytes = 0;
+size_t liveBytes = 0;      // Belegter Heap (malloc_usable_size, glibc)
+size_t peakLiveBytes = 0;
+volatile float floatSink;
+volatile size_t sizeSink;
+char jsonBuffer[16384];  // Reicht für eine volle Gerätetabelle
+
+// Stream-Ziel, das nur Bytes zählt
+class CountingPrint : public Print {
+public:
+  size_t write(uint8_t c) override { (void)c; bytes++; return 1; }
+  size_t write(const uint8_t* buffer, size_t size) override { (void)buffer; bytes += size; return size; }
+  size_t bytes = 0;
+};
+
+const size_t POPULATIONS[] = {10, 100, 1000};
+const size_t FILTER_SIZES[] = {16, 256, 4096};
+
+MacAddress deviceAddress(size_t i) {
+  return 0xC0FFEE000000ULL + i * 7919;
+}
+
+// Fuehrt body(i) so oft aus, dass eine Messung mindestens 50 ms dauert
+template <typename F>
+void measure(const char* stage, const std::string& params, F body) {
+  using Clock = std::chrono::steady_clock;
+  size_t ops = 256;
+  for (;;) {
+    unsigned long allocsBefore = allocationCount;
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < ops; i++) {
+      body(i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    if (ns >= 50e6 || ops >= (1u << 26)) {
+      double nsPerOp = ns / ops;
+      printf("bench=hotpath stage=%s%s%s ns_per_op=%.1f allocs_per_op=%.2f ops_per_s=%.0f\n",
+             stage, params.empty() ? "" : " ", params.c_str(), nsPerOp,
+             (double)(allocationCount - allocsBefore) / ops, 1e9 / nsPerOp);
+      fflush(stdout);
+      return;
+    }
+    ops *= 2;
+  }
+}
+
+std::string param(const char* key, size_t value) {
+  return std::string(key) + "=" + std::to_string(value);
+}
+
+void setFilter(bool enabled, size_t macs, size_t matchingDevices) {
+  filteredDevices.clear();
+  // Die ersten matchingDevices Geraete stehen in der Liste, der Rest sind fremde Adressen
+  for (size_t i = 0; i < macs; i++) {
+    filteredDevices.add(i < matchingDevices ? deviceAddress(i) : 0x5A0000000000ULL + i * 104729);
+  }
+  String command = String("{\"target\":\"") + GATEWAY_ID + "\",\"mac_enable\":" + (enabled ? "true" : "false") + "}";
+  ConfigManager::processConfigCommand(command.c_str(), command.length());
+}
+
+// Typisches Beacon-Advertisement: Flags, Name, Herstellerdaten, 16-Bit-Service-UUID
+NimBLEAdvertisedDevice makeAdvertisement(MacAddress mac, int rssi) {
+  const uint8_t payload[] = {0x02, 0x01, 0x06,
+                             0x08, 0x09, 'N', 'G', 'I', 'S', '0', '0', '4',
+                             0x05, 0xFF, 0x59, 0x00, 0x01, 0x02,
+                             0x03, 0x03, 0xAA, 0xFE};
+  uint8_t native[6];
+  for (int i = 0; i < 6; i++) {
+    native[i] = (mac >> (8 * i)) & 0xFF;
+  }
+  return NimBLEAdvertisedDevice(NimBLEAddress(native), rssi, payload, sizeof(payload));
+}
+
+// Langer Name (ueber die 15 Zeichen von std::string ohne Heap) und
+// 128-Bit-Service-UUID; number ergibt die letzten drei Ziffern des Namens
+NimBLEAdvertisedDevice makeLongNameAdvertisement(MacAddress mac, size_t number) {
+  uint8_t payload[] = {0x02, 0x01, 0x06,
+                       0x15, 0x09, 'B', 'e', 'a', 'c', 'o', 'n', '-', 'H', 'a', 'l', 'l', 'e', '-', 'O', 's', 't', '-',
+                       '0', '0', '0',
+                       0x11, 0x07, 0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80,
+                       0x00, 0x10, 0x00, 0x00, 0x34, 0x12, 0x00, 0x00};
+  payload[22] = '0' + (number / 100) % 10;
+  payload[23] = '0' + (number / 10) % 10;
+  payload[24] = '0' + number % 10;
+  uint8_t native[6];
+  for (int i = 0; i < 6; i++) {
+    native[i] = (mac >> (8 * i)) & 0xFF;
+  }
+  return NimBLEAdvertisedDevice(NimBLEAddress(native), -50, payload, sizeof(payload));
+}
+
+std::vector<NimBLEAdvertisedDevice> makeAdvertisements(size_t devices) {
+  std::vector<NimBLEAdvertisedDevice> list;
+  for (size_t i = 0; i < devices; i++) {
+    list.push_back(makeAdvertisement(deviceAddress(i), -45 - (int)(i % 10)));
+  }
+  return list;
+}
+
+void fillDeviceTable(size_t devices) {
+  deviceTable.clear();
+  inRangeIndex.clear();
+  std::vector<NimBLEAdvertisedDevice> ads = makeAdvertisements(devices);
+  for (auto& ad : ads) {
+    AdvertisementEvent event;
+    decodeAdvertisement(&ad, event);
+    processAdvertisement(event);
+  }
+  flushFilterBank();
+}
+
+void benchFilters() {
+  measure("rssi_to_meters", "", [](size_t i) {
+    floatSink = rssiToMeters(-40 - (int)(i % 60));
+  });
+
+  KalmanFilter kalman(1.0f);
+  measure("kalman_update", "", [&](size_t i) {
+    floatSink = kalman.update(1.0f + (float)(i & 7) * 0.1f);
+  });
+
+  MovingAverageFilter average(WINDOW_SIZE);
+  measure("moving_average_update", param("window", WINDOW_SIZE), [&](size_t i) {
+    floatSink = average.update((float)(i & 15));
+  });
+}
+
+// Filter eines Geraets wie in DeviceInfo ohne FILTER_BANK
+struct ScalarFilters {
+  KalmanFilter kalman;
+  VelocityKalmanFilter velocity;
+  MovingAverageFilter rssi;
+  MovingAverageFilter distance;
+  bool useVelocity = false;
+  float filteredDistance = 0;
+  float avgRssi = 0;
+  float avgDistance = 0;
+
+  ScalarFilters() : kalman(0), velocity(), rssi(), distance() {}
+  void update(int measuredRssi, float measuredDistance, uint32_t timestamp) {
+    filteredDistance = useVelocity ? velocity.update(measuredDistance, timestamp) : kalman.update(measuredDistance);
+    avgRssi = rssi.update(measuredRssi);
+    avgDistance = distance.update(filteredDistance);
+  }
+};
+
+// Reproduzierbares RSSI fuer Messung n von Geraet device
+int sampleRssi(size_t device, size_t n) {
+  uint32_t h = (uint32_t)(device * 2654435761u) ^ (uint32_t)(n * 40503u);
+  h ^= h >> 13;
+  h *= 0x5bd1e995u;
+  h ^= h >> 15;
+  return -45 - (int)(device % 30) - (int)(h % 12);
+}
+
+const size_t BANK_POPULATIONS[] = {10, 100, FilterBank::CAPACITY};
+const size_t SAMPLES_PER_TICK = 2;
+
+void benchFilterBank() {
+  for (size_t devices : BANK_POPULATIONS) {
+    std::string params = param("devices", devices) + " " + param("samples_per_tick", SAMPLES_PER_TICK);
+
+    static ScalarFilters scalar[FilterBank::CAPACITY];
+    measure("filter_scalar", params, [&](size_t i) {
+      size_t device = i % devices;
+      int rssi = sampleRssi(device, i / devices);
+      scalar[device].update(rssi, rssiToMeters(rssi), (uint32_t)i);
+      floatSink = scalar[device].avgDistance;
+    });
+
+    static FilterBank bank;
+    std::vector<uint16_t> slots(devices);
+    for (size_t device = 0; device < devices; device++) {
+      slots[device] = bank.acquire(deviceAddress(device));
+    }
+    size_t tickLength = devices * SAMPLES_PER_TICK;
+    measure("filter_bank", params, [&](size_t i) {
+      size_t device = i % devices;
+      int rssi = sampleRssi(device, i / devices);
+      if (!bank.stage(slots[device], (float)rssi, rssiToMeters(rssi), (uint32_t)i)) {
+        bank.update([](uint16_t) {});
+        bank.stage(slots[device], (float)rssi, rssiToMeters(rssi), (uint32_t)i);
+      }
+      if (i % tickLength == tickLength - 1) {
+        bank.update([&](uint16_t slot) { floatSink = bank.averageDistance(slot); });
+      }
+    });
+    bank.update([](uint16_t) {});
+    for (size_t device = 0; device < devices; device++) {
+      bank.release(slots[device]);
+    }
+  }
+
+  // Gleiche Messungen durch beide Wege, 1 bis FILTER_BANK_SAMPLES pro Geraet und
+  // Durchlauf; zwischendurch aendern sich die Fenstergroesse wie per window_size
+  // und das Filtermodell wie per tracker (Wechsel wie in applyDistanceTracker)
+  const size_t devices = FilterBank::CAPACITY;
+  const size_t ticks = 200;
+  static ScalarFilters scalar[FilterBank::CAPACITY];
+  static FilterBank bank;
+  static uint16_t slots[FilterBank::CAPACITY];
+  static size_t deviceBySlot[FilterBank::CAPACITY];
+  for (size_t device = 0; device < devices; device++) {
+    slots[device] = bank.acquire(deviceAddress(device));
+    deviceBySlot[slots[device]] = device;
+  }
+  float maxDistanceDiff = 0;
+  float maxAvgRssiDiff = 0;
+  float maxAvgDistanceDiff = 0;
+  size_t samples = 0;
+  static size_t sampleCount[FilterBank::CAPACITY] = {};
+  static uint32_t lastTime[FilterBank::CAPACITY] = {};
+  for (size_t tick = 0; tick < ticks; tick++) {
+    if (tick == ticks / 2 || tick == ticks * 3 / 4) {
+      int windowSize = tick == ticks / 2 ? MAX_WINDOW_SIZE : 3;
+      for (size_t device = 0; device < devices; device++) {
+        scalar[device].rssi.setWindowSize(windowSize);
+        scalar[device].distance.setWindowSize(windowSize);
+      }
+      bank.setWindowSize(windowSize);
+    }
+    if (tick == ticks / 4 || tick == ticks * 7 / 8) {
+      DistanceTracker tracker = tick == ticks / 4 ? TRACKER_VELOCITY : TRACKER_SCALAR;
+      for (size_t device = 0; device < devices; device++) {
+        ScalarFilters& reference = scalar[device];
+        if (tracker == TRACKER_VELOCITY) {
+          reference.velocity.seed(reference.filteredDistance, lastTime[device]);
+        } else {
+          reference.kalman.seed(reference.filteredDistance, reference.velocity.getVariance());
+        }
+        reference.useVelocity = tracker == TRACKER_VELOCITY;
+      }
+      bank.setDistanceTracker(tracker, PROCESS_NOISE, MEASUREMENT_NOISE);
+    }
+    for (size_t device = 0; device < devices; device++) {
+      size_t count = 1 + (size_t)(-sampleRssi(device, tick) % FILTER_BANK_SAMPLES);
+      for (size_t n = 0; n < count; n++) {
+        // Ein Durchlauf alle TRACKING_INTERVAL ms, Messungen darin gleichmaessig
+        uint32_t timestamp = (uint32_t)(tick * TRACKING_INTERVAL + n * TRACKING_INTERVAL / count);
+        int rssi = sampleRssi(device, sampleCount[device]++);
+        scalar[device].update(rssi, rssiToMeters(rssi), timestamp);
+        bank.stage(slots[device], (float)rssi, rssiToMeters(rssi), timestamp);
+        lastTime[device] = timestamp;
+        samples++;
+      }
+    }
+    bank.update([&](uint16_t slot) {
+      const ScalarFilters& reference = scalar[deviceBySlot[slot]];
+      maxDistanceDiff = std::max(maxDistanceDiff, std::fabs(bank.distance(slot) - reference.filteredDistance));
+      maxAvgRssiDiff = std::max(maxAvgRssiDiff, std::fabs(bank.averageRssi(slot) - reference.avgRssi));
+      maxAvgDistanceDiff = std::max(maxAvgDistanceDiff, std::fabs(bank.averageDistance(slot) - reference.avgDistance));
+    });
+  }
+  printf("bench=hotpath stage=filter_bank_check %s samples=%zu max_diff_distance=%g max_diff_avg_rssi=%g max_diff_avg_distance=%g\n",
+         param("devices", devices).c_str(), samples, maxDistanceDiff, maxAvgRssiDiff, maxAvgDistanceDiff);
+  fflush(stdout);
+}
+
+void benchDeviceFilter() {
+  setFilter(false, 0, 0);
+  measure("device_filter", "filter=off macs=0", [](size_t i) {
+    sizeSink = isDeviceInFilter(deviceAddress(i & 1023));
+  });
+  for (size_t macs : FILTER_SIZES) {
+    // Halb Treffer, halb fremde Adressen
+    setFilter(true, macs, macs / 2);
+    measure("device_filter", "filter=on " + param("macs", macs), [&](size_t i) {
+      sizeSink = isDeviceInFilter(deviceAddress(i % macs));
+    });
+  }
+  setFilter(false, 0, 0);
+}
+
+void benchDeviceRecord() {
+  std::vector<NimBLEAdvertisedDevice> ads;
+  for (size_t i = 0; i < DEVICE_TABLE_CAPACITY; i++) {
+    ads.push_back(makeLongNameAdvertisement(deviceAddress(i), i));
+  }
+  std::vector<AdvertisementEvent> events(ads.size());
+  for (size_t i = 0; i < ads.size(); i++) {
+    decodeAdvertisement(&ads[i], events[i]);
+  }
+
+  setFilter(false, 0, 0);
+  deviceTable.clear();
+  inRangeIndex.clear();
+  unsigned long bytesBefore = allocatedBytes;
+  for (const AdvertisementEvent& event : events) {
+    processAdvertisement(event);
+  }
+  flushFilterBank();
+  double heapPerDevice = (double)(allocatedBytes - bytesBefore) / events.size();
+
+  size_t slotBytes = sizeof(MacAddress) + sizeof(uint32_t) + sizeof(DeviceInfo);
+  double tablePerDevice = (double)(deviceTable.slotCount() * slotBytes) / deviceTable.capacity();
+  double namesPerDevice = (double)namePool.bytes() / deviceTable.capacity();
+  printf("bench=hotpath stage=device_record devices=%zu record_bytes=%zu table_bytes_per_device=%.1f "
+         "name_pool_bytes_per_device=%.1f heap_bytes_per_device=%.1f bytes_per_device=%.1f\n",
+         deviceTable.size(), sizeof(DeviceInfo), tablePerDevice, namesPerDevice, heapPerDevice,
+         tablePerDevice + namesPerDevice + heapPerDevice);
+  fflush(stdout);
+}
+
+void benchDeviceTable() {
+  for (size_t devices : POPULATIONS) {
+    MacHashTable<DeviceInfo> table(devices);
+    for (size_t i = 0; i < devices; i++) {
+      table.findOrInsert(deviceAddress(i), 0);
+    }
+    measure("device_table_find_or_insert", param("devices", devices), [&](size_t i) {
+      sizeSink = (size_t)&table.findOrInsert(deviceAddress(i % devices), (uint32_t)i);
+    });
+  }
+}
+
+void benchAdvertisementPath() {
+  NimBLEAdvertisedDevice ad = makeAdvertisement(deviceAddress(1), -50);
+  measure("decode_advertisement", "", [&](size_t i) {
+    (void)i;
+    AdvertisementEvent event;
+    decodeAdvertisement(&ad, event);
+    sizeSink = event.hasName;
+  });
+  NimBLEAdvertisedDevice longAd = makeLongNameAdvertisement(deviceAddress(1), 1);
+  measure("decode_advertisement", "payload=long_name_uuid128", [&](size_t i) {
+    (void)i;
+    AdvertisementEvent event;
+    decodeAdvertisement(&longAd, event);
+    sizeSink = event.hasName;
+  });
+
+  // Unbekanntes Geraet weit weg: endet nach dem RSSI-Vergleich und einem Nachschlagen
+  setFilter(false, 0, 0);
+  fillDeviceTable(DEVICE_TABLE_CAPACITY);
+  NimBLEAdvertisedDevice farAd = makeAdvertisement(0x5A0000000001ULL, -90);
+  AdvertisementEvent farEvent;
+  decodeAdvertisement(&farAd, farEvent);
+  measure("reject_out_of_range", std::string("rssi=-90 ") + param("table", DEVICE_TABLE_CAPACITY), [&](size_t i) {
+    (void)i;
+    processAdvertisement(farEvent);
+  });
+
+  MyAdvertisedDeviceCallbacks firmwareCallbacks;
+  NimBLEAdvertisedDeviceCallbacks& callbacks = firmwareCallbacks;
+  for (size_t devices : POPULATIONS) {
+    std::vector<NimBLEAdvertisedDevice> ads = makeAdvertisements(devices);
+    std::vector<AdvertisementEvent> events(devices);
+    for (size_t i = 0; i < devices; i++) {
+      decodeAdvertisement(&ads[i], events[i]);
+    }
+    std::string params = param("devices", devices) + " " + param("table", DEVICE_TABLE_CAPACITY);
+
+    setFilter(false, 0, 0);
+    fillDeviceTable(devices);
+    measure("process_advertisement", params + " filter=off", [&](size_t i) {
+      processAdvertisement(events[i % devices]);
+    });
+    // Gesamtweg wie im blockierenden Scan: onResult dekodiert und verarbeitet direkt
+    measure("advertisement_total", params + " filter=off", [&](size_t i) {
+      callbacks.onResult(&ads[i % devices]);
+    });
+
+    // Filter mit 256 Adressen, davon die Haelfte aus der Umgebung
+    setFilter(true, 256, devices / 2);
+    fillDeviceTable(devices);
+    measure("advertisement_total", params + " filter=on macs=256", [&](size_t i) {
+      callbacks.onResult(&ads[i % devices]);
+    });
+  }
+  setFilter(false, 0, 0);
+}
+
+void benchScanWindow() {
+  const uint8_t payload[] = {0x02, 0x01, 0x06,
+                             0x08, 0x09, 'N', 'G', 'I', 'S', '0', '0', '4',
+                             0x05, 0xFF, 0x59, 0x00, 0x01, 0x02,
+                             0x03, 0x03, 0xAA, 0xFE};
+  const size_t ADVERTISEMENTS_PER_DEVICE = 4;
+  setFilter(false, 0, 0);
+  bleScanner.init();
+  NimBLEScan* scan = NimBLEDevice::getScan();
+
+  // Ein Fenster mit devices Adressen; gibt die gemeldete Geraeteanzahl zurueck
+  auto runWindow = [&](size_t devices, size_t& retained, size_t& heapRise) {
+    bleScanner.startContinuous();
+    size_t base = liveBytes;
+    peakLiveBytes = liveBytes;
+    for (size_t round = 0; round < ADVERTISEMENTS_PER_DEVICE; round++) {
+      for (size_t i = 0; i < devices; i++) {
+        MacAddress mac = deviceAddress(i);
+        uint8_t address[6];
+        for (int k = 0; k < 6; k++) {
+          address[k] = (mac >> (8 * (5 - k))) & 0xFF;
+        }
+        scan->hostDeliver(address, 0, -45 - (int)(i % 10), payload, sizeof(payload));
+        bleScanner.processEvents();
+      }
+    }
+    heapRise = peakLiveBytes - base;
+    retained = (size_t)scan->getResults().getCount();
+    bleScanner.stopScanWindow();
+    int deviceCount = 0;
+    bleScanner.pollScanWindow(deviceCount);
+    return deviceCount;
+  };
+
+  for (int mode = 0; mode < 2; mode++) {
+    scan->setMaxResults(mode == 0 ? 0 : 0xFF);
+    for (size_t devices : POPULATIONS) {
+      size_t retained = 0;
+      size_t heapRise = 0;
+      deviceTable.clear();
+      inRangeIndex.clear();
+      // Erstes Fenster zum Aufwaermen: Schein-Controller und Ring haben danach ihre Groesse
+      runWindow(devices, retained, heapRise);
+      int counted = runWindow(devices, retained, heapRise);
+      printf("bench=hotpath stage=scan_window mode=%s devices=%zu advertisements=%zu retained_results=%zu "
+             "peak_heap_bytes=%zu counted_devices=%d\n",
+             mode == 0 ? "streaming" : "retained", devices, devices * ADVERTISEMENTS_PER_DEVICE, retained,
+             heapRise, counted);
+      fflush(stdout);
+    }
+  }
+  scan->clearResults();
+  scan->setMaxResults(STREAMING_SCAN ? 0 : 0xFF);
+}
+
+void benchJson() {
+  fillDeviceTable(1);
+  DeviceInfo* device = deviceTable.find(deviceAddress(0));
+  measure("generate_beacon_json", "", [&](size_t i) {
+    (void)i;
+    sizeSink = generateBeaconJSON(jsonBuffer, sizeof(jsonBuffer), deviceAddress(0), *device);
+  });
+
+  for (size_t devices : POPULATIONS) {
+    fillDeviceTable(devices);
+    measure("count_devices_in_range", param("devices", deviceTable.size()), [](size_t i) {
+      (void)i;
+      countDevicesInRange();
+    });
+    measure("generate_devices_json", param("devices", deviceTable.size()), [](size_t i) {
+      (void)i;
+      sizeSink = generateDevicesJSON(jsonBuffer, sizeof(jsonBuffer));
+    });
+    measure("stream_devices_json", param("devices", deviceTable.size()), [](size_t i) {
+      (void)i;
+      CountingPrint out;
+      JsonWriter writer(out);
+      writeDevicesJSON(writer);
+      writer.flush();
+      sizeSink = out.bytes;
+    });
+  }
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  allocationCount++;
+  allocatedBytes += size;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  liveBytes += malloc_usable_size(p);
+  if (liveBytes > peakLiveBytes) {
+    peakLiveBytes = liveBytes;
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  if (p) {
+    liveBytes -= malloc_usable_size(p);
+  }
+  free(p);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+int main() {
+  // Debug-Ausgaben der Firmware verwerfen, sie sind aber Teil der gemessenen Arbeit
+  FILE* devnull = fopen("/dev/null", "w");
+  Serial.hostSetSink(devnull);
+  NativeHAL::setMicros(100000000ULL);
+
+  ConfigManager::init();
+
+  benchFilters();
+  benchFilterBank();
+  benchDeviceFilter();
+  benchDeviceTable();
+  benchDeviceRecord();
+  benchAdvertisementPath();
+  benchScanWindow();
+  benchJson();
+  return 0;
+}
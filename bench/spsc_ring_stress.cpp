@@ -0,0 +1,111 @@
+// Stresstest und Durchsatzmessung fuer SpscRing
+//
+// Ein Producer-Thread schreibt fortlaufende Nummern in den Ring (wie der
+// BLE-Callback), ein Consumer-Thread liest sie (wie die Verarbeitungsstufe).
+// Geprueft wird, dass jede angenommene Nummer genau einmal und in
+// aufsteigender Reihenfolge ankommt und dass angenommen + verworfen der
+// Anzahl der push()-Aufrufe entspricht. Im Modus "retry" wiederholt der
+// Producer volle push()-Versuche, dann muss jede Nummer ankommen.
+//
+// Build und Aufruf auf dem Host:
+//   g++ -std=gnu++17 -O2 -Isrc bench/spsc_ring_stress.cpp -o spsc_ring_stress -lpthread
+//   ./spsc_ring_stress
+//
+// Ausgabe: eine Zeile pro Messung, "key=value" getrennt durch Leerzeichen.
+// Rueckgabewert ungleich 0, wenn eine Pruefung fehlschlaegt.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include "SpscRing.h"
+
+namespace {
+
+// Etwa so gross wie ein AdvertisementEvent
+struct Item {
+  uint32_t sequence;
+  uint8_t payload[92];
+};
+
+template <size_t N>
+bool runCase(const char* name, uint32_t items, bool retryWhenFull, unsigned consumerDelayUs) {
+  std::unique_ptr<SpscRing<Item, N>> ringStorage(new SpscRing<Item, N>());
+  SpscRing<Item, N>& ring = *ringStorage;
+
+  std::atomic<bool> producerDone(false);
+  uint32_t received = 0;
+  uint32_t lastSequence = 0;
+  bool ordered = true;
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::thread consumer([&]() {
+    Item item;
+    for (;;) {
+      bool done = producerDone.load(std::memory_order_acquire);
+      bool any = false;
+      while (ring.pop(item)) {
+        if (received > 0 && item.sequence <= lastSequence) {
+          ordered = false;
+        }
+        if (item.payload[0] != (uint8_t)item.sequence ||
+            item.payload[sizeof(item.payload) - 1] != (uint8_t)(item.sequence >> 8)) {
+          ordered = false;
+        }
+        lastSequence = item.sequence;
+        received++;
+        any = true;
+        if (consumerDelayUs) {
+          std::this_thread::sleep_for(std::chrono::microseconds(consumerDelayUs));
+        }
+      }
+      if (done && !any) {
+        break;
+      }
+      if (!any) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  Item item = {};
+  uint32_t attempts = 0;
+  for (uint32_t i = 1; i <= items; i++) {
+    item.sequence = i;
+    item.payload[0] = (uint8_t)i;
+    item.payload[sizeof(item.payload) - 1] = (uint8_t)(i >> 8);
+    attempts++;
+    while (!ring.push(item) && retryWhenFull) {
+      attempts++;
+      std::this_thread::yield();
+    }
+  }
+  producerDone.store(true, std::memory_order_release);
+  consumer.join();
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  bool countsMatch = received == ring.pushed() && ring.pushed() + ring.dropped() == attempts &&
+                     (!retryWhenFull || received == items);
+  bool ok = ordered && countsMatch;
+
+  printf("bench=spsc_ring case=%s slots=%u items=%u accepted=%u dropped=%u max_fill=%u "
+         "ns_per_item=%.1f result=%s\n",
+         name, (unsigned)N, (unsigned)items, (unsigned)ring.pushed(), (unsigned)ring.dropped(),
+         (unsigned)ring.maxFill(), seconds * 1e9 / items, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  bool ok = true;
+  // Producer wartet bei vollem Ring: vollstaendige Uebergabe, misst den Durchsatz
+  ok &= runCase<64>("retry", 10000000, true, 0);
+  // Minimaler Ring: maximale Konkurrenz um dieselben Slots
+  ok &= runCase<2>("retry_tiny_ring", 1000000, true, 0);
+  // Langsamer Consumer ohne Wiederholung: Verluste muessen sauber gezaehlt werden
+  ok &= runCase<64>("drop_slow_consumer", 200000, false, 5);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+// Benchmark: Reaktionszeit und Ruhe der Entfernungsfilter
+//
+// Spielt synthetische Bewegungen eines Beacons durch processAdvertisement
+// (derselbe Weg wie in der Firmware, mit -DFILTER_BANK=1 ueber die
+// FilterBank) und vergleicht die Filtermodelle, die {"tracker":...} waehlt:
+// scalar (KalmanFilter) und velocity (VelocityKalmanFilter).
+//
+// Szenarien (Schwellenwert DISTANCE_THRESHOLD, 1 m):
+//   step      0,5 m, nach 10 s Sprung auf 3 m
+//   depart    0,5 m, nach 10 s mit 1 m/s weg bis 5 m
+//   approach  0,5 m, 5 s auf 4 m, dann mit 1 m/s heran bis 0,3 m
+//   hold_0.95 steht 60 s knapp innerhalb des Schwellenwerts
+//   hold_2    steht 60 s bei 2 m
+// latency_ms ist die Zeit vom Ueberschreiten des Schwellenwerts durch die
+// wahre Entfernung bis zur ersten gefilterten Entfernung auf derselben Seite,
+// flips die Zahl der Wechsel der Entscheidung "in Reichweite" waehrend
+// hold_0.95, rms_m der Fehler der gefilterten Entfernung waehrend hold_2.
+//
+// Advertisements kommen alle interval_ms (+-20 %), 20 % gehen verloren; das
+// RSSI folgt dem Pfadverlustmodell aus Config.h mit 2 dB Rauschen und ganzen
+// dBm wie vom Funkteil. Jede Zeile ist der Mittelwert ueber RUNS Durchlaeufe
+// mit verschiedenen Zufallsfolgen, gleich fuer beide Filtermodelle.
+//
+// Build und Aufruf auf dem Host (gegen lib/NativeHAL, ohne src/main.cpp):
+//   pio run -e bench_tracker && .pio/build/bench_tracker/program
+// Weitere Befehle vor jedem Lauf, z.B. mit anderem Prozessrauschen:
+//   .pio/build/bench_tracker/program --command '{"target":"BLE001","process_noise":0.1}'
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "NativeHAL.h"
+#include "Config.h"
+#include "ConfigManager.h"
+#include "BLEScanner.h"
+#include "DeviceInfo.h"
+#include "BeaconTracker.h"
+
+namespace {
+
+const int RUNS = 20;
+const double LOSS = 0.2;
+const double JITTER = 0.2;
+const double RSSI_NOISE_DB = 2.0;
+const uint32_t START_MS = 100000;  // millis() beim Start jedes Durchlaufs
+
+enum Kind { CROSSING, FLIPS, RMS };
+
+struct Scenario {
+  const char* name;
+  Kind kind;
+  uint32_t durationMs;
+  uint32_t measureFromMs;  // FLIPS/RMS: erst ab hier zaehlen
+  double (*truth)(double t);  // Wahre Entfernung in m, t in s
+};
+
+double stepTruth(double t) { return t < 10 ? 0.5 : 3.0; }
+double departTruth(double t) { return t < 10 ? 0.5 : std::min(5.0, 0.5 + (t - 10)); }
+double approachTruth(double t) {
+  if (t < 5) {
+    return 0.5;
+  }
+  return t < 25 ? 4.0 : std::max(0.3, 4.0 - (t - 25));
+}
+double hold095Truth(double t) {
+  (void)t;
+  return 0.95;
+}
+// Erst nah, damit die Firmware das Geraet anlegt (siehe processAdvertisement)
+double hold2Truth(double t) { return t < 2 ? 0.5 : 2.0; }
+
+const Scenario SCENARIOS[] = {
+  {"step", CROSSING, 20000, 0, stepTruth},
+  {"depart", CROSSING, 20000, 0, departTruth},
+  {"approach", CROSSING, 35000, 0, approachTruth},
+  {"hold_0.95", FLIPS, 70000, 10000, hold095Truth},
+  {"hold_2", RMS, 70000, 10000, hold2Truth},
+};
+
+const uint32_t INTERVALS[] = {100, 1000};
+
+std::vector<std::string> extraCommands;
+
+void command(const std::string& json) {
+  ConfigManager::processConfigCommand(json.c_str(), json.length());
+}
+
+// Umkehrung von rssiToMeters: RSSI, das ein Beacon in distance Metern liefert
+double rssiAt(double distance) {
+  double uncorrected = distance - ConfigManager::getDistanceCorrection();
+  return ConfigManager::getTxPower() - 10.0 * ConfigManager::getEnvironmentalFactor() * log10(uncorrected);
+}
+
+struct Result {
+  double latencyMs = 0;
+  double flips = 0;
+  double rmsM = 0;
+};
+
+Result runOnce(const Scenario& scenario, uint32_t intervalMs, MacAddress address, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::normal_distribution<double> noise(0.0, RSSI_NOISE_DB);
+  const float threshold = ConfigManager::getDistanceThreshold();
+
+  // Zeitpunkt, an dem die wahre Entfernung den Schwellenwert ueberschreitet
+  double crossingMs = -1;
+  bool startInside = scenario.truth(0) <= threshold;
+  for (uint32_t t = 0; t < scenario.durationMs && scenario.kind == CROSSING; t++) {
+    if ((scenario.truth(t / 1000.0) <= threshold) != startInside) {
+      crossingMs = t;
+      break;
+    }
+  }
+
+  Result result;
+  double latency = -1;
+  bool wasInside = false;
+  bool haveDecision = false;
+  double squaredError = 0;
+  size_t errorSamples = 0;
+  double t = 0;
+  while (t < scenario.durationMs) {
+    t += intervalMs * (1.0 + JITTER * (2 * uniform(random) - 1));
+    double truth = scenario.truth(t / 1000.0);
+    double rssi = rssiAt(truth) + noise(random);
+    if (uniform(random) < LOSS) {
+      continue;
+    }
+
+    uint32_t now = START_MS + (uint32_t)t;
+    NativeHAL::setMicros((uint64_t)now * 1000);
+    AdvertisementEvent event;
+    memset(&event, 0, sizeof(event));
+    event.address = address;
+    event.rssi = (int)lround(rssi);
+    event.timestamp = now;
+    processAdvertisement(event);
+    flushFilterBank();
+    DeviceInfo* device = deviceTable.find(address);
+    if (device == nullptr) {
+      continue;
+    }
+
+    float estimate = device->filteredDistance;
+    bool inside = estimate <= threshold;
+    if (scenario.kind == CROSSING) {
+      if (latency < 0 && t >= crossingMs && inside != startInside) {
+        latency = t - crossingMs;
+      }
+    } else if (t >= scenario.measureFromMs) {
+      if (haveDecision && inside != wasInside) {
+        result.flips++;
+      }
+      wasInside = inside;
+      haveDecision = true;
+      squaredError += (estimate - truth) * (estimate - truth);
+      errorSamples++;
+    }
+  }
+  // Nie erkannt: bis zum Ende des Szenarios
+  result.latencyMs = latency >= 0 ? latency : scenario.durationMs - crossingMs;
+  result.rmsM = errorSamples > 0 ? sqrt(squaredError / errorSamples) : 0;
+  return result;
+}
+
+void runScenario(const Scenario& scenario, const char* tracker, uint32_t intervalMs, uint32_t& nextAddress) {
+  command(std::string("{\"target\":\"") + GATEWAY_ID.c_str() + "\",\"tracker\":\"" + tracker + "\"}");
+  for (const std::string& extra : extraCommands) {
+    command(extra);
+  }
+
+  Result sum;
+  for (int run = 0; run < RUNS; run++) {
+    deviceTable.clear();
+    inRangeIndex.clear();
+    // Neue Adresse je Durchlauf, damit kein Filterzustand uebrig bleibt
+    Result one = runOnce(scenario, intervalMs, 0xC0FFEE000000ULL + nextAddress++, 1000 + run * 7919 + intervalMs);
+    sum.latencyMs += one.latencyMs;
+    sum.flips += one.flips;
+    sum.rmsM += one.rmsM;
+  }
+
+  printf("bench=tracker scenario=%s tracker=%s interval_ms=%u", scenario.name, tracker, (unsigned)intervalMs);
+  if (scenario.kind == CROSSING) {
+    printf(" latency_ms=%.0f", sum.latencyMs / RUNS);
+  } else if (scenario.kind == FLIPS) {
+    printf(" flips=%.1f", sum.flips / RUNS);
+  } else {
+    printf(" rms_m=%.3f", sum.rmsM / RUNS);
+  }
+  printf(" runs=%d\n", RUNS);
+  fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--command") == 0) {
+      extraCommands.push_back(argv[++i]);
+    }
+  }
+
+  // Debug-Ausgaben der Firmware verwerfen
+  FILE* devnull = fopen("/dev/null", "w");
+  Serial.hostSetSink(devnull);
+  NativeHAL::setMicros((uint64_t)START_MS * 1000);
+
+  ConfigManager::init();
+  command(std::string("{\"target\":\"") + GATEWAY_ID.c_str() + "\",\"mac_enable\":false}");
+
+  uint32_t nextAddress = 0;
+  for (const Scenario& scenario : SCENARIOS) {
+    for (uint32_t intervalMs : INTERVALS) {
+      for (const char* tracker : {"scalar", "velocity"}) {
+        runScenario(scenario, tracker, intervalMs, nextAddress);
+      }
+    }
+  }
+  return 0;
+}
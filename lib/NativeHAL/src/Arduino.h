@@ -0,0 +1,207 @@
+#ifndef NATIVE_HAL_ARDUINO_H
+#define NATIVE_HAL_ARDUINO_H
+
+// Host-Ersatz fuer den Teil des Arduino-Cores, den die Firmware benutzt.
+// Zeitbasis ist eine virtuelle Uhr (siehe NativeHAL.h), damit Simulationen
+// und Replays deterministisch und schneller als Echtzeit laufen.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+// Gleiche Rundungslogik wie dtostrf() im ESP32-Arduino-Core, damit Host-Ausgaben
+// byte-identisch zum Geraet bleiben
+char* dtostrf(double number, signed char width, unsigned char prec, char* s);
+
+class String {
+public:
+  String() {}
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  String(const String& other) = default;
+  String(String&& other) = default;
+  explicit String(char c) : s_(1, c) {}
+  explicit String(int v) : s_(std::to_string(v)) {}
+  explicit String(unsigned int v) : s_(std::to_string(v)) {}
+  explicit String(long v) : s_(std::to_string(v)) {}
+  explicit String(unsigned long v) : s_(std::to_string(v)) {}
+  explicit String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+  explicit String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+
+  String& operator=(const String& other) = default;
+  String& operator=(String&& other) = default;
+  String& operator=(const char* s) { s_ = s ? s : ""; return *this; }
+
+  String& operator+=(const String& rhs) { s_ += rhs.s_; return *this; }
+  String& operator+=(const char* rhs) { if (rhs) s_ += rhs; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  String& operator+=(int v) { s_ += std::to_string(v); return *this; }
+  String& operator+=(unsigned int v) { s_ += std::to_string(v); return *this; }
+  String& operator+=(long v) { s_ += std::to_string(v); return *this; }
+  String& operator+=(unsigned long v) { s_ += std::to_string(v); return *this; }
+
+  bool concat(const String& rhs) { s_ += rhs.s_; return true; }
+  bool concat(const char* rhs) { if (rhs) s_ += rhs; return true; }
+  bool concat(char c) { s_ += c; return true; }
+  bool concat(const char* rhs, unsigned int len) { s_.append(rhs, len); return true; }
+
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, char b) { String r(a); r += b; return r; }
+
+  bool operator==(const String& rhs) const { return s_ == rhs.s_; }
+  bool operator==(const char* rhs) const { return s_ == (rhs ? rhs : ""); }
+  bool operator!=(const String& rhs) const { return s_ != rhs.s_; }
+  bool operator!=(const char* rhs) const { return !(*this == rhs); }
+  bool operator<(const String& rhs) const { return s_ < rhs.s_; }
+  char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char& operator[](unsigned int i) { return s_[i]; }
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  bool isEmpty() const { return s_.empty(); }
+  const char* c_str() const { return s_.c_str(); }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+  bool reserve(unsigned int size) { s_.reserve(size); return true; }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t pos = s_.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  int indexOf(const String& str, unsigned int from = 0) const {
+    size_t pos = s_.find(str.s_, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  int lastIndexOf(char c) const {
+    size_t pos = s_.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+  String substring(unsigned int from) const {
+    return from >= s_.size() ? String() : String(s_.substr(from));
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= s_.size()) return String();
+    return String(s_.substr(from, to - from));
+  }
+  void trim() {
+    size_t b = s_.find_first_not_of(" \t\r\n");
+    size_t e = s_.find_last_not_of(" \t\r\n");
+    s_ = (b == std::string::npos) ? std::string() : s_.substr(b, e - b + 1);
+  }
+  void toLowerCase() { for (auto& c : s_) c = (char)tolower((unsigned char)c); }
+  void toUpperCase() { for (auto& c : s_) c = (char)toupper((unsigned char)c); }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s_.c_str(), nullptr); }
+  bool startsWith(const String& prefix) const { return s_.compare(0, prefix.s_.size(), prefix.s_) == 0; }
+
+private:
+  void fromDouble(double v, unsigned char decimals) {
+    char buf[33];
+    s_ = dtostrf(v, decimals + 2, decimals, buf);
+  }
+  std::string s_;
+};
+
+// Ergebnistyp von String-Verkettungen im Arduino-Core; ArduinoJson erwartet ihn
+class StringSumHelper : public String {
+public:
+  StringSumHelper(const String& s) : String(s) {}
+  StringSumHelper(const char* s) : String(s) {}
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int decimals = 2) { char buf[33]; return print(dtostrf(v, decimals + 2, decimals, buf)); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  size_t println(double v, int decimals) { size_t n = print(v, decimals); return n + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(buf)) return write((const uint8_t*)buf, len);
+    std::string big(len + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&big[0], big.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)big.data(), len);
+  }
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long timeout) { timeout_ = timeout; }
+
+  String readStringUntil(char terminator) {
+    String ret;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) ret += (char)c;
+    return ret;
+  }
+  size_t readBytes(uint8_t* buffer, size_t length) {
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0) buffer[n++] = (uint8_t)c;
+    return n;
+  }
+
+protected:
+  unsigned long timeout_ = 1000;
+};
+
+// Heap-Abfragen des ESP32-Cores. Der Host hat keinen festen Heap: die Werte
+// stellt NativeHAL::setHeap() ein (Voreinstellung wie ein ESP32-S3 im Betrieb).
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMaxAllocHeap();
+};
+extern EspClass ESP;
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "HardwareSerial.h"
+
+#endif // NATIVE_HAL_ARDUINO_H
@@ -0,0 +1,110 @@
+#include "Arduino.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct NativeTask {
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint32_t notifications = 0;
+};
+
+struct NativeQueue {
+  std::mutex mutex;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+struct NativeMutex {
+  std::recursive_mutex mutex;
+};
+
+namespace {
+
+thread_local NativeTask* currentTask = nullptr;
+
+}  // namespace
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t coreId) {
+  (void)name; (void)stackDepth; (void)priority; (void)coreId;
+  NativeTask* task = new NativeTask();
+  if (handle) *handle = task;
+  std::thread([task, function, parameter]() {
+    currentTask = task;
+    function(parameter);
+  }).detach();
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+  std::lock_guard<std::mutex> lock(task->mutex);
+  task->notifications++;
+  task->cv.notify_one();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+  NativeTask* task = currentTask;
+  if (!task) return 0;
+  std::unique_lock<std::mutex> lock(task->mutex);
+  task->cv.wait_for(lock, std::chrono::milliseconds(ticksToWait), [task] { return task->notifications > 0; });
+  uint32_t value = task->notifications;
+  if (value > 0) task->notifications = clearCountOnExit ? 0 : value - 1;
+  return value;
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)millis(); }
+
+TaskHandle_t xTaskGetCurrentTaskHandle() { return currentTask; }
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  NativeQueue* queue = new NativeQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+  (void)ticksToWait;
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  if (queue->items.size() >= queue->length) return pdFALSE;
+  const uint8_t* bytes = (const uint8_t*)item;
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+  (void)ticksToWait;
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  if (queue->items.empty()) return pdFALSE;
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  return (UBaseType_t)queue->items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return new NativeMutex(); }
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticksToWait) {
+  (void)ticksToWait;
+  mutex->mutex.lock();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex) {
+  mutex->mutex.unlock();
+  return pdTRUE;
+}
@@ -0,0 +1,78 @@
+#ifndef NATIVE_HAL_HARDWARESERIAL_H
+#define NATIVE_HAL_HARDWARESERIAL_H
+
+#include <deque>
+#include <functional>
+#include <string>
+#include "Arduino.h"
+
+#define SERIAL_8N1 0x800001c
+
+// UART-Ersatz: Empfangsdaten werden vom Host eingespeist, gesendete Daten
+// landen entweder in einer FILE*-Senke oder in einem Puffer zum Auswerten.
+class HardwareSerial : public Stream {
+public:
+  explicit HardwareSerial(int uartNum) : uartNum_(uartNum) {}
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1) {
+    baud_ = baud;
+    (void)config; (void)rxPin; (void)txPin;
+  }
+  void end() {}
+  size_t setRxBufferSize(size_t size) { return size; }
+  // Wird wie der UART-Event-Task nach dem Einspeisen aufgerufen
+  void onReceive(std::function<void(void)> callback) { onReceive_ = callback; }
+  operator bool() const { return true; }
+
+  int available() override { return (int)rx_.size(); }
+  int read() override {
+    if (rx_.empty()) return -1;
+    int c = (uint8_t)rx_.front();
+    rx_.pop_front();
+    return c;
+  }
+  size_t read(uint8_t* buffer, size_t size) {
+    size_t count = 0;
+    while (count < size && !rx_.empty()) {
+      buffer[count++] = (uint8_t)rx_.front();
+      rx_.pop_front();
+    }
+    return count;
+  }
+  int peek() override { return rx_.empty() ? -1 : (uint8_t)rx_.front(); }
+
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    txBytes_ += size;
+    if (sink_) {
+      fwrite(buffer, 1, size, sink_);
+    } else {
+      tx_.append((const char*)buffer, size);
+    }
+    return size;
+  }
+
+  // Host-Schnittstelle
+  void hostInject(const char* data, size_t len) {
+    rx_.insert(rx_.end(), data, data + len);
+    if (onReceive_) onReceive_();
+  }
+  void hostInject(const std::string& data) { hostInject(data.data(), data.size()); }
+  void hostSetSink(FILE* sink) { sink_ = sink; }
+  std::string hostTakeOutput() { std::string out; out.swap(tx_); return out; }
+  unsigned long hostBytesWritten() const { return txBytes_; }
+
+private:
+  int uartNum_;
+  unsigned long baud_ = 0;
+  std::deque<char> rx_;
+  std::string tx_;
+  FILE* sink_ = nullptr;
+  std::function<void(void)> onReceive_;
+  unsigned long txBytes_ = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_HAL_HARDWARESERIAL_H
@@ -0,0 +1,361 @@
+#include "NativeHAL.h"
+#include "Arduino.h"
+#include "NimBLEDevice.h"
+#include <fstream>
+#include <iterator>
+#include <map>
+
+HardwareSerial Serial(0);
+EspClass ESP;
+
+namespace {
+
+uint64_t clockMicros = 0;
+std::multimap<unsigned long, NativeHAL::Advertisement> scheduled;
+unsigned long delivered = 0;
+unsigned long missed = 0;
+bool deliverWhileIdle = false;
+bool modelScanDuty = false;
+NimBLEScan scanInstance;
+uint32_t heapFree = 180000;
+uint32_t heapLargestBlock = 110000;
+
+}  // namespace
+
+unsigned long millis() { return (unsigned long)(clockMicros / 1000); }
+unsigned long micros() { return (unsigned long)clockMicros; }
+void delay(unsigned long ms) { NativeHAL::advanceMillis(ms); }
+void yield() {}
+
+uint32_t EspClass::getFreeHeap() { return heapFree; }
+uint32_t EspClass::getMaxAllocHeap() { return heapLargestBlock; }
+
+char* dtostrf(double number, signed char width, unsigned char prec, char* s) {
+  bool negative = false;
+
+  if (std::isnan(number)) {
+    strcpy(s, "nan");
+    return s;
+  }
+  if (std::isinf(number)) {
+    strcpy(s, "inf");
+    return s;
+  }
+
+  char* out = s;
+  int fillme = width;
+  if (prec > 0) {
+    fillme -= (prec + 1);
+  }
+  if (number < 0.0) {
+    negative = true;
+    fillme--;
+    number = -number;
+  }
+
+  // Rundung wie im ESP32-Core: print(1.999, 2) ergibt "2.00"
+  double rounding = 2.0;
+  for (unsigned int i = 0; i < prec; ++i) {
+    rounding *= 10.0;
+  }
+  rounding = 1.0 / rounding;
+  number += rounding;
+
+  double tenpow = 1.0;
+  unsigned int digitcount = 1;
+  while (number >= 10.0 * tenpow) {
+    tenpow *= 10.0;
+    digitcount++;
+  }
+  number /= tenpow;
+  fillme -= digitcount;
+
+  while (fillme-- > 0) {
+    *out++ = ' ';
+  }
+  if (negative) {
+    *out++ = '-';
+  }
+
+  digitcount += prec;
+  int8_t digit = 0;
+  while (digitcount-- > 0) {
+    digit = (int8_t)number;
+    if (digit > 9) digit = 9;
+    *out++ = (char)('0' | digit);
+    if ((digitcount == prec) && (prec > 0)) {
+      *out++ = '.';
+    }
+    number -= digit;
+    number *= 10.0;
+  }
+  *out = 0;
+  return s;
+}
+
+namespace NativeHAL {
+
+void setMicros(uint64_t now) { clockMicros = now; }
+uint64_t nowMicros() { return clockMicros; }
+
+void setHeap(uint32_t freeBytes, uint32_t largestBlock) {
+  heapFree = freeBytes;
+  heapLargestBlock = largestBlock;
+}
+
+void advanceMillis(unsigned long ms) {
+  unsigned long target = millis() + ms;
+  while (!scheduled.empty() && scheduled.begin()->first <= target) {
+    auto it = scheduled.begin();
+    // Ein Scan, der vor diesem Advertisement endet, wird zuerst abgeschlossen
+    scanInstance.hostAdvanceTo(it->first);
+    if ((uint64_t)it->first * 1000 > clockMicros) {
+      clockMicros = (uint64_t)it->first * 1000;
+    }
+    if ((scanInstance.isScanning() && scanInstance.hostInWindow(it->first)) || deliverWhileIdle) {
+      scanInstance.hostDeliver(it->second.address, it->second.addressType, it->second.rssi,
+                               it->second.payload.data(), it->second.payload.size());
+      delivered++;
+    } else {
+      missed++;
+    }
+    scheduled.erase(it);
+  }
+  scanInstance.hostAdvanceTo(target);
+  if ((uint64_t)target * 1000 > clockMicros) {
+    clockMicros = (uint64_t)target * 1000;
+  }
+}
+
+void schedule(const Advertisement& adv) { scheduled.emplace(adv.timeMs, adv); }
+size_t pendingAdvertisements() { return scheduled.size(); }
+unsigned long nextAdvertisementTime() { return scheduled.empty() ? 0 : scheduled.begin()->first; }
+unsigned long lastAdvertisementTime() { return scheduled.empty() ? 0 : scheduled.rbegin()->first; }
+unsigned long deliveredAdvertisements() { return delivered; }
+unsigned long missedAdvertisements() { return missed; }
+void setDeliverWhileIdle(bool enabled) { deliverWhileIdle = enabled; }
+void setModelScanDuty(bool enabled) { modelScanDuty = enabled; }
+
+long loadCapture(const char* path, unsigned long startMs, std::string& error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    error = std::string("cannot open ") + path;
+    return -1;
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (data.size() < 8 || memcmp(data.data(), "BLECAP", 6) != 0 || data[6] != 1) {
+    error = "not a version 1 .blecap file";
+    return -1;
+  }
+
+  long count = 0;
+  bool haveFirst = false;
+  uint32_t first = 0;
+  size_t pos = 8;
+  while (pos < data.size()) {
+    if (pos + 13 > data.size() || pos + 13 + data[pos + 12] > data.size()) {
+      error = "truncated record at offset " + std::to_string(pos);
+      return -1;
+    }
+    const uint8_t* r = &data[pos];
+    uint32_t timestamp = r[0] | (r[1] << 8) | (r[2] << 16) | ((uint32_t)r[3] << 24);
+    if (!haveFirst) {
+      first = timestamp;
+      haveFirst = true;
+    }
+    Advertisement adv;
+    // Zeitabstand relativ zum ersten Datensatz, auch ueber einen millis()-Ueberlauf
+    adv.timeMs = startMs + (uint32_t)(timestamp - first);
+    memcpy(adv.address, r + 4, 6);
+    adv.addressType = r[10];
+    adv.rssi = (int8_t)r[11];
+    adv.payload.assign(r + 13, r + 13 + r[12]);
+    schedule(adv);
+    pos += 13 + r[12];
+    count++;
+  }
+  return count;
+}
+
+}  // namespace NativeHAL
+
+//============================== NimBLE ======================================
+
+std::string NimBLEAddress::toString() const {
+  char buf[18];
+  snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x",
+           m_address[5], m_address[4], m_address[3], m_address[2], m_address[1], m_address[0]);
+  return buf;
+}
+
+NimBLEUUID::NimBLEUUID(const uint8_t* data, uint8_t size) {
+  memset(&m_uuid, 0, sizeof(m_uuid));
+  if (size == 2) {
+    m_uuid.u16.u.type = BLE_UUID_TYPE_16;
+    m_uuid.u16.value = (uint16_t)(data[0] | (data[1] << 8));
+  } else if (size == 4) {
+    m_uuid.u32.u.type = BLE_UUID_TYPE_32;
+    m_uuid.u32.value = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+  } else if (size == 16) {
+    m_uuid.u128.u.type = BLE_UUID_TYPE_128;
+    memcpy(m_uuid.u128.value, data, 16);
+  }
+}
+
+std::string NimBLEUUID::toString() const {
+  char buf[40];
+  if (m_uuid.u.type == BLE_UUID_TYPE_16) {
+    snprintf(buf, sizeof(buf), "0x%04x", m_uuid.u16.value);
+  } else if (m_uuid.u.type == BLE_UUID_TYPE_32) {
+    snprintf(buf, sizeof(buf), "0x%08x", (unsigned)m_uuid.u32.value);
+  } else {
+    const uint8_t* u = m_uuid.u128.value;
+    snprintf(buf, sizeof(buf), "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+             u[15], u[14], u[13], u[12], u[11], u[10], u[9], u[8],
+             u[7], u[6], u[5], u[4], u[3], u[2], u[1], u[0]);
+  }
+  return buf;
+}
+
+const uint8_t* NimBLEAdvertisedDevice::findField(uint8_t type, uint8_t* lengthOut) const {
+  size_t pos = 0;
+  while (pos + 1 < m_payload.size()) {
+    uint8_t len = m_payload[pos];
+    if (len == 0 || pos + 1 + len > m_payload.size()) break;
+    if (m_payload[pos + 1] == type) {
+      if (lengthOut) *lengthOut = len - 1;
+      return &m_payload[pos + 2];
+    }
+    pos += 1 + len;
+  }
+  return nullptr;
+}
+
+std::string NimBLEAdvertisedDevice::getName() const {
+  uint8_t len = 0;
+  const uint8_t* data = findField(0x09, &len);
+  if (!data) data = findField(0x08, &len);
+  return data ? std::string((const char*)data, len) : std::string();
+}
+
+std::string NimBLEAdvertisedDevice::getManufacturerData() const {
+  uint8_t len = 0;
+  const uint8_t* data = findField(0xFF, &len);
+  return data ? std::string((const char*)data, len) : std::string();
+}
+
+bool NimBLEAdvertisedDevice::haveServiceUUID() const {
+  static const uint8_t types[] = {0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+  for (uint8_t t : types) {
+    if (findField(t)) return true;
+  }
+  return false;
+}
+
+NimBLEUUID NimBLEAdvertisedDevice::getServiceUUID(uint8_t index) const {
+  static const uint8_t types[] = {0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+  static const uint8_t sizes[] = {2, 2, 4, 4, 16, 16};
+  for (int i = 0; i < 6; i++) {
+    uint8_t len = 0;
+    const uint8_t* data = findField(types[i], &len);
+    if (data && len >= sizes[i] * (index + 1)) {
+      return NimBLEUUID(data + sizes[i] * index, sizes[i]);
+    }
+  }
+  return NimBLEUUID();
+}
+
+int8_t NimBLEAdvertisedDevice::getTXPower() const {
+  const uint8_t* data = findField(0x0A);
+  return data ? (int8_t)data[0] : -99;
+}
+
+void NimBLEScan::setAdvertisedDeviceCallbacks(NimBLEAdvertisedDeviceCallbacks* callbacks, bool wantDuplicates) {
+  m_callbacks = callbacks;
+  m_wantDuplicates = wantDuplicates;
+}
+
+NimBLEScanResults NimBLEScan::start(uint32_t duration, bool is_continue) {
+  if (!is_continue) clearResults();
+  m_seenThisScan.clear();
+  m_scanning = true;
+  m_scanCompleteCB = nullptr;
+  m_scanStart = millis();
+  m_scanEnd = millis() + duration * 1000;
+  // Blockierender Scan: virtuelle Uhr bis zum Scan-Ende vorspulen
+  NativeHAL::advanceMillis(duration * 1000);
+  return m_results;
+}
+
+bool NimBLEScan::start(uint32_t duration, void (*scanCompleteCB)(NimBLEScanResults), bool is_continue) {
+  if (!is_continue) clearResults();
+  m_seenThisScan.clear();
+  m_scanning = true;
+  m_scanCompleteCB = scanCompleteCB;
+  m_scanStart = millis();
+  m_scanEnd = duration == 0 ? 0 : millis() + duration * 1000;
+  return true;
+}
+
+bool NimBLEScan::stop() {
+  // Wie NimBLE: ein laufender Scan meldet sein Ende auch beim Abbruch
+  bool wasScanning = m_scanning;
+  m_scanning = false;
+  if (wasScanning && m_scanCompleteCB) m_scanCompleteCB(m_results);
+  return true;
+}
+
+bool NimBLEScan::hostInWindow(unsigned long t) const {
+  if (!modelScanDuty || m_interval == 0 || t < m_scanStart) return true;
+  // Intervall und Fenster in Millisekunden wie bei NimBLE 1.4
+  unsigned long phase = (t - m_scanStart) % m_interval;
+  return phase < m_window;
+}
+
+void NimBLEScan::clearResults() {
+  for (auto* device : m_results.m_devices) delete device;
+  m_results.m_devices.clear();
+}
+
+void NimBLEScan::hostAdvanceTo(unsigned long now) {
+  if (m_scanning && m_scanEnd != 0 && now >= m_scanEnd) {
+    if ((uint64_t)m_scanEnd * 1000 > NativeHAL::nowMicros()) {
+      NativeHAL::setMicros((uint64_t)m_scanEnd * 1000);
+    }
+    m_scanning = false;
+    if (m_scanCompleteCB) m_scanCompleteCB(m_results);
+  }
+}
+
+void NimBLEScan::hostDeliver(const uint8_t address[6], uint8_t addressType, int rssi,
+                             const uint8_t* payload, size_t length) {
+  uint8_t native[6];
+  for (int i = 0; i < 6; i++) native[i] = address[5 - i];
+  NimBLEAddress addr(native, addressType);
+  uint64_t key = (uint64_t)addr;
+
+  bool firstThisScan = std::find(m_seenThisScan.begin(), m_seenThisScan.end(), key) == m_seenThisScan.end();
+  if (firstThisScan) m_seenThisScan.push_back(key);
+  if (!firstThisScan && m_duplicateFilter && !m_wantDuplicates) return;
+
+  // Wie NimBLE: bekannte Geraete werden aktualisiert, neue angelegt
+  NimBLEAdvertisedDevice* device = nullptr;
+  for (auto* d : m_results.m_devices) {
+    if (d->getAddress() == addr) { device = d; break; }
+  }
+  bool stored = true;
+  if (device) {
+    device->update(rssi, payload, length);
+  } else {
+    device = new NimBLEAdvertisedDevice(addr, rssi, payload, length);
+    if (m_maxResults == 0 || (m_maxResults != 0xFF && m_results.m_devices.size() >= m_maxResults)) {
+      stored = false;
+    } else {
+      m_results.m_devices.push_back(device);
+    }
+  }
+  if (m_callbacks) m_callbacks->onResult(device);
+  if (!stored) delete device;
+}
+
+NimBLEScan* NimBLEDevice::getScan() { return &scanInstance; }
@@ -0,0 +1,55 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+// Steuerung der Host-Umgebung: virtuelle Uhr und simulierte Advertisement-Quelle.
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace NativeHAL {
+
+// Ein geplantes Advertisement. address[] ist in Textreihenfolge (aa:bb:...:ff).
+struct Advertisement {
+  unsigned long timeMs;
+  uint8_t address[6];
+  uint8_t addressType = 0;
+  int8_t rssi;
+  std::vector<uint8_t> payload;
+};
+
+// Virtuelle Uhr in Mikrosekunden. advance() liefert alle bis dahin faelligen
+// Advertisements an einen laufenden Scan aus und beendet abgelaufene Scans.
+void setMicros(uint64_t now);
+uint64_t nowMicros();
+void advanceMillis(unsigned long ms);
+
+// Advertisement-Quelle
+void schedule(const Advertisement& adv);
+size_t pendingAdvertisements();
+unsigned long nextAdvertisementTime();
+unsigned long lastAdvertisementTime();
+unsigned long deliveredAdvertisements();
+unsigned long missedAdvertisements();  // Eingetroffen, waehrend kein Scan lief
+
+// Auch ohne laufenden Scan an die Callbacks liefern. Fuer Replays: ein
+// Mitschnitt enthaelt nur, was onResult auf dem Geraet schon gesehen hat.
+void setDeliverWhileIdle(bool enabled);
+
+// Scan-Intervall und -Fenster nachbilden: Advertisements ausserhalb des
+// Empfangsfensters gehen verloren (zaehlen als missed). Aus: alles, was
+// waehrend eines Scans eintrifft, wird geliefert.
+void setModelScanDuty(bool enabled);
+
+// Was ESP.getFreeHeap() und ESP.getMaxAllocHeap() melden
+void setHeap(uint32_t freeBytes, uint32_t largestBlock);
+
+// Laedt einen .blecap-Mitschnitt (Format siehe src/AdvertisementCapture.h)
+// und plant ihn so ein, dass der erste Datensatz zur Zeit startMs eintrifft.
+// Gibt die Anzahl der Datensaetze zurueck, -1 bei Fehler (Text in error).
+long loadCapture(const char* path, unsigned long startMs, std::string& error);
+
+}  // namespace NativeHAL
+
+#endif // NATIVE_HAL_H
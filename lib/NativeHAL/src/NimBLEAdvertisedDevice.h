@@ -0,0 +1,6 @@
+#ifndef NATIVE_HAL_NIMBLEADVERTISEDDEVICE_H
+#define NATIVE_HAL_NIMBLEADVERTISEDDEVICE_H
+
+#include "NimBLEDevice.h"
+
+#endif // NATIVE_HAL_NIMBLEADVERTISEDDEVICE_H
@@ -0,0 +1,163 @@
+#ifndef NATIVE_HAL_NIMBLEDEVICE_H
+#define NATIVE_HAL_NIMBLEDEVICE_H
+
+// Host-Ersatz fuer die von der Firmware genutzte NimBLE-Arduino-1.4-API.
+// Advertisements kommen aus der simulierten Quelle in NativeHAL.h.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define BLE_ADDR_PUBLIC 0
+#define BLE_ADDR_RANDOM 1
+
+class NimBLEAddress {
+public:
+  NimBLEAddress() { memset(m_address, 0, sizeof(m_address)); }
+  // Byte-Reihenfolge wie NimBLE: m_address[0] ist das letzte Oktett des Textes
+  explicit NimBLEAddress(const uint8_t address[6], uint8_t type = BLE_ADDR_PUBLIC) : m_addrType(type) {
+    memcpy(m_address, address, sizeof(m_address));
+  }
+  const uint8_t* getNative() const { return m_address; }
+  uint8_t getType() const { return m_addrType; }
+  std::string toString() const;
+  operator uint64_t() const {
+    uint64_t v = 0;
+    for (int i = 5; i >= 0; i--) v = (v << 8) | m_address[i];
+    return v;
+  }
+  bool operator==(const NimBLEAddress& rhs) const { return memcmp(m_address, rhs.m_address, 6) == 0; }
+
+private:
+  uint8_t m_address[6];
+  uint8_t m_addrType = BLE_ADDR_PUBLIC;
+};
+
+// UUID-Typen wie in NimBLEs host/ble_uuid.h
+#define BLE_UUID_TYPE_16 16
+#define BLE_UUID_TYPE_32 32
+#define BLE_UUID_TYPE_128 128
+
+typedef struct { uint8_t type; } ble_uuid_t;
+typedef struct { ble_uuid_t u; uint16_t value; } ble_uuid16_t;
+typedef struct { ble_uuid_t u; uint32_t value; } ble_uuid32_t;
+typedef struct { ble_uuid_t u; uint8_t value[16]; } ble_uuid128_t;  // Little Endian
+typedef union {
+  ble_uuid_t u;
+  ble_uuid16_t u16;
+  ble_uuid32_t u32;
+  ble_uuid128_t u128;
+} ble_uuid_any_t;
+
+class NimBLEUUID {
+public:
+  NimBLEUUID() { memset(&m_uuid, 0, sizeof(m_uuid)); }
+  // data in Little Endian, wie im Advertisement
+  NimBLEUUID(const uint8_t* data, uint8_t size);
+  uint8_t bitSize() const { return m_uuid.u.type; }
+  const ble_uuid_any_t* getNative() const { return &m_uuid; }
+  std::string toString() const;
+
+private:
+  ble_uuid_any_t m_uuid;
+};
+
+class NimBLEAdvertisedDevice {
+public:
+  NimBLEAdvertisedDevice(const NimBLEAddress& address, int rssi, const uint8_t* payload, size_t length)
+    : m_address(address), m_rssi(rssi), m_payload(payload, payload + length) {}
+
+  NimBLEAddress getAddress() const { return m_address; }
+  int getRSSI() const { return m_rssi; }
+  uint8_t* getPayload() { return m_payload.data(); }
+  size_t getPayloadLength() const { return m_payload.size(); }
+
+  bool haveName() const { return findField(0x09) || findField(0x08); }
+  std::string getName() const;
+  bool haveManufacturerData() const { return findField(0xFF) != nullptr; }
+  std::string getManufacturerData() const;
+  bool haveServiceUUID() const;
+  NimBLEUUID getServiceUUID(uint8_t index = 0) const;
+  bool haveTXPower() const { return findField(0x0A) != nullptr; }
+  int8_t getTXPower() const;
+
+  void update(int rssi, const uint8_t* payload, size_t length) {
+    m_rssi = rssi;
+    m_payload.assign(payload, payload + length);
+  }
+
+private:
+  const uint8_t* findField(uint8_t type, uint8_t* lengthOut = nullptr) const;
+
+  NimBLEAddress m_address;
+  int m_rssi;
+  std::vector<uint8_t> m_payload;
+};
+
+class NimBLEAdvertisedDeviceCallbacks {
+public:
+  virtual ~NimBLEAdvertisedDeviceCallbacks() {}
+  virtual void onResult(NimBLEAdvertisedDevice* advertisedDevice) = 0;
+};
+
+class NimBLEScanResults {
+public:
+  int getCount() { return (int)m_devices.size(); }
+  NimBLEAdvertisedDevice getDevice(uint32_t i) { return *m_devices[i]; }
+
+private:
+  friend class NimBLEScan;
+  std::vector<NimBLEAdvertisedDevice*> m_devices;
+};
+
+class NimBLEScan {
+public:
+  void setAdvertisedDeviceCallbacks(NimBLEAdvertisedDeviceCallbacks* callbacks, bool wantDuplicates = false);
+  void setActiveScan(bool active) { m_activeScan = active; }
+  void setInterval(uint16_t interval) { m_interval = interval; }
+  void setWindow(uint16_t window) { m_window = window; }
+  void setDuplicateFilter(bool enabled) { m_duplicateFilter = enabled; }
+  void setMaxResults(uint8_t maxResults) { m_maxResults = maxResults; }
+
+  NimBLEScanResults start(uint32_t duration, bool is_continue = false);
+  bool start(uint32_t duration, void (*scanCompleteCB)(NimBLEScanResults), bool is_continue = false);
+  bool stop();
+  bool isScanning() const { return m_scanning; }
+  void clearResults();
+  NimBLEScanResults getResults() { return m_results; }
+
+  // Host-Schnittstelle (von NativeHAL benutzt)
+  bool hostActiveScan() const { return m_activeScan; }
+  uint16_t hostInterval() const { return m_interval; }
+  uint16_t hostWindow() const { return m_window; }
+  void hostDeliver(const uint8_t address[6], uint8_t addressType, int rssi,
+                   const uint8_t* payload, size_t length);
+  void hostAdvanceTo(unsigned long now);
+  // Liegt t im Empfangsfenster (Intervall/Fenster ab Scan-Start)?
+  bool hostInWindow(unsigned long t) const;
+  unsigned long hostScanEnd() const { return m_scanEnd; }
+
+private:
+  NimBLEAdvertisedDeviceCallbacks* m_callbacks = nullptr;
+  bool m_wantDuplicates = false;
+  bool m_activeScan = false;
+  bool m_duplicateFilter = true;
+  uint16_t m_interval = 100;
+  uint16_t m_window = 100;
+  uint8_t m_maxResults = 0xFF;
+  bool m_scanning = false;
+  unsigned long m_scanEnd = 0;  // 0 = unbegrenzt
+  unsigned long m_scanStart = 0;
+  void (*m_scanCompleteCB)(NimBLEScanResults) = nullptr;
+  NimBLEScanResults m_results;
+  std::vector<uint64_t> m_seenThisScan;
+};
+
+class NimBLEDevice {
+public:
+  static void init(const std::string& deviceName) { (void)deviceName; }
+  static NimBLEScan* getScan();
+};
+
+#endif // NATIVE_HAL_NIMBLEDEVICE_H
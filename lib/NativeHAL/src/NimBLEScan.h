@@ -0,0 +1,6 @@
+#ifndef NATIVE_HAL_NIMBLESCAN_H
+#define NATIVE_HAL_NIMBLESCAN_H
+
+#include "NimBLEDevice.h"
+
+#endif // NATIVE_HAL_NIMBLESCAN_H
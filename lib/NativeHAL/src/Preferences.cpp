@@ -0,0 +1,105 @@
+#include "Preferences.h"
+
+namespace {
+
+std::map<std::string, std::map<std::string, std::vector<uint8_t>>> storage;
+unsigned long writeCount = 0;
+
+}  // namespace
+
+bool Preferences::begin(const char* name, bool readOnly) {
+  auto it = storage.find(name);
+  if (it == storage.end()) {
+    if (readOnly) return false;
+    it = storage.emplace(name, std::map<std::string, std::vector<uint8_t>>()).first;
+  }
+  ns_ = &it->second;
+  readOnly_ = readOnly;
+  return true;
+}
+
+void Preferences::end() { ns_ = nullptr; }
+
+bool Preferences::clear() {
+  if (!ns_ || readOnly_) return false;
+  ns_->clear();
+  writeCount++;
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!ns_ || readOnly_) return false;
+  writeCount++;
+  return ns_->erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) { return get(key) != nullptr; }
+
+size_t Preferences::put(const char* key, const void* value, size_t len) {
+  if (!ns_ || readOnly_) return 0;
+  const uint8_t* bytes = (const uint8_t*)value;
+  (*ns_)[key].assign(bytes, bytes + len);
+  writeCount++;
+  return len;
+}
+
+const std::vector<uint8_t>* Preferences::get(const char* key) {
+  if (!ns_) return nullptr;
+  auto it = ns_->find(key);
+  return it == ns_->end() ? nullptr : &it->second;
+}
+
+size_t Preferences::putInt(const char* key, int32_t value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putBool(const char* key, bool value) { uint8_t v = value; return put(key, &v, 1); }
+size_t Preferences::putUChar(const char* key, uint8_t value) { return put(key, &value, 1); }
+size_t Preferences::putFloat(const char* key, float value) { return put(key, &value, sizeof(value)); }
+size_t Preferences::putString(const char* key, const String& value) { return put(key, value.c_str(), value.length()); }
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) { return put(key, value, len); }
+
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) {
+  const auto* v = get(key);
+  int32_t out = defaultValue;
+  if (v && v->size() == sizeof(out)) memcpy(&out, v->data(), sizeof(out));
+  return out;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+  const auto* v = get(key);
+  return (v && v->size() == 1) ? (*v)[0] != 0 : defaultValue;
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) {
+  const auto* v = get(key);
+  return (v && v->size() == 1) ? (*v)[0] : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+  const auto* v = get(key);
+  float out = defaultValue;
+  if (v && v->size() == sizeof(out)) memcpy(&out, v->data(), sizeof(out));
+  return out;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+  const auto* v = get(key);
+  return v ? String(std::string(v->begin(), v->end())) : defaultValue;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  const auto* v = get(key);
+  return v ? v->size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  const auto* v = get(key);
+  if (!v || v->size() > maxLen) return 0;
+  memcpy(buf, v->data(), v->size());
+  return v->size();
+}
+
+unsigned long Preferences::hostWriteCount() { return writeCount; }
+
+void Preferences::hostReset() {
+  storage.clear();
+  writeCount = 0;
+}
@@ -0,0 +1,46 @@
+#ifndef NATIVE_HAL_PREFERENCES_H
+#define NATIVE_HAL_PREFERENCES_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+// NVS-Ersatz: alle Namespaces liegen prozessweit im RAM. Wie auf dem ESP32
+// schlaegt begin() im Nur-Lese-Modus fehl, solange der Namespace nicht existiert.
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+
+  size_t putInt(const char* key, int32_t value);
+  size_t putBool(const char* key, bool value);
+  size_t putUChar(const char* key, uint8_t value);
+  size_t putFloat(const char* key, float value);
+  size_t putString(const char* key, const String& value);
+  size_t putBytes(const char* key, const void* value, size_t len);
+
+  int32_t getInt(const char* key, int32_t defaultValue = 0);
+  bool getBool(const char* key, bool defaultValue = false);
+  uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+  float getFloat(const char* key, float defaultValue = NAN);
+  String getString(const char* key, const String& defaultValue = String());
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+  // Host-Schnittstelle: Anzahl der Schreibzugriffe (Flash-Verschleiss-Abschaetzung)
+  static unsigned long hostWriteCount();
+  static void hostReset();
+
+private:
+  size_t put(const char* key, const void* value, size_t len);
+  const std::vector<uint8_t>* get(const char* key);
+
+  std::map<std::string, std::vector<uint8_t>>* ns_ = nullptr;
+  bool readOnly_ = true;
+};
+
+#endif // NATIVE_HAL_PREFERENCES_H
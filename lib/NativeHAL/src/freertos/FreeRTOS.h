@@ -0,0 +1,23 @@
+#ifndef NATIVE_HAL_FREERTOS_H
+#define NATIVE_HAL_FREERTOS_H
+
+// Minimaler FreeRTOS-Ersatz auf Basis von std::thread/std::mutex.
+
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskIDLE_PRIORITY 0
+#define PRO_CPU_NUM 0
+#define APP_CPU_NUM 1
+
+#endif // NATIVE_HAL_FREERTOS_H
@@ -0,0 +1,13 @@
+#ifndef NATIVE_HAL_SEMPHR_H
+#define NATIVE_HAL_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+struct NativeMutex;
+typedef NativeMutex* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticksToWait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex);
+
+#endif // NATIVE_HAL_SEMPHR_H
@@ -0,0 +1,21 @@
+#ifndef NATIVE_HAL_TASK_H
+#define NATIVE_HAL_TASK_H
+
+#include "FreeRTOS.h"
+
+struct NativeTask;
+typedef NativeTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+// Startet einen echten Host-Thread; Kern und Prioritaet werden ignoriert
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t coreId);
+void vTaskDelay(TickType_t ticks);
+void xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+TickType_t xTaskGetTickCount();
+// nullptr im Hauptthread (setup()/loop()): Benachrichtigungen dorthin entfallen
+TaskHandle_t xTaskGetCurrentTaskHandle();
+
+#endif // NATIVE_HAL_TASK_H
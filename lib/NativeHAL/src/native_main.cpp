@@ -0,0 +1,200 @@
+// Host-Einstiegspunkt: faehrt setup()/loop() gegen die virtuelle Uhr.
+//
+//   program [-v] [--serial-out DATEI] [--capture] [--scan-duty] [--command JSON]...
+//       Simulierte Szene: ein Beacon kommt in Reichweite und geht wieder;
+//       misst die Reaktionszeit der UART-Meldungen (nur im JSON-Uplink).
+//       --command legt nach setup() eine Zeile in den Meshtastic-UART, als
+//       käme sie aus dem Mesh, z.B. '{"target":"BLE001","uplink":"binary"}'.
+//       --scan-duty laesst Advertisements ausserhalb des Scan-Fensters
+//       verloren gehen (fuer den adaptiven Scan).
+//   program --replay MITSCHNITT.blecap [--speed X] [--uart-out DATEI] [-v]
+//       Spielt einen Mitschnitt ueber denselben Weg wie onResult ab.
+//       --speed 1 ist Echtzeit, --speed 100 hundertfach, 0 (Standard) so
+//       schnell wie moeglich. --uart-out schreibt die Bytes an Meshtastic
+//       unveraendert in eine Datei; sie sind bei gleichem Mitschnitt und
+//       gleicher Firmware byte-identisch und lassen sich direkt diffen.
+//
+// Auf stdout erscheinen die UART-Meldungen mit virtuellem Zeitstempel,
+// Serial-Ausgaben nur mit -v (stderr) oder --serial-out.
+// Eigene Host-Programme (Benchmarks) setzen NATIVE_HAL_NO_MAIN.
+
+#ifndef NATIVE_HAL_NO_MAIN
+
+#include <Arduino.h>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+#include "NativeHAL.h"
+
+void setup();
+void loop();
+void setCaptureEnabled(bool enabled);
+
+extern HardwareSerial MeshtasticSerial;
+
+namespace {
+
+constexpr unsigned long LOOP_TICK_MS = 5;         // Simulierte Dauer einer loop()-Iteration
+constexpr unsigned long ADV_INTERVAL_MS = 100;    // Advertising-Intervall des Beacons
+constexpr unsigned long ENTER_MS = 2000;          // Beacon kommt in Reichweite
+constexpr unsigned long LEAVE_MS = 12000;         // Beacon verlaesst den Schwellenwert
+constexpr unsigned long SILENT_MS = 25000;        // Beacon verstummt
+constexpr unsigned long END_MS = 60000;
+constexpr unsigned long REPLAY_TAIL_MS = 60000;   // Nach dem letzten Datensatz weiterlaufen (Timeouts)
+
+const uint8_t BEACON_ADDRESS[6] = {0x08, 0x05, 0x04, 0x03, 0x02, 0x01};
+
+struct Options {
+  bool verbose = false;
+  bool capture = false;
+  bool scanDuty = false;
+  const char* serialOut = nullptr;
+  const char* replay = nullptr;
+  const char* uartOut = nullptr;
+  double speed = 0;
+  std::vector<std::string> commands;
+};
+
+void scheduleWalkScenario() {
+  uint32_t seed = 12345;
+  for (unsigned long t = ENTER_MS; t < SILENT_MS; t += ADV_INTERVAL_MS) {
+    float meters = t < LEAVE_MS ? 0.5f : 3.0f;
+    seed = seed * 1103515245u + 12345u;
+    float noise = (float)((seed >> 16) % 5) - 2.0f;
+    NativeHAL::Advertisement adv;
+    adv.timeMs = t;
+    memcpy(adv.address, BEACON_ADDRESS, sizeof(adv.address));
+    adv.rssi = (int8_t)lroundf(-59.0f - 27.0f * log10f(meters) + noise);
+    const uint8_t payload[] = {0x02, 0x01, 0x06,
+                               0x08, 0x09, 'N', 'G', 'I', 'S', '0', '0', '4',
+                               0x05, 0xFF, 0x59, 0x00, 0x01, 0x02};
+    adv.payload.assign(payload, payload + sizeof(payload));
+    NativeHAL::schedule(adv);
+  }
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "-v") {
+      options.verbose = true;
+    } else if (arg == "--capture") {
+      options.capture = true;
+    } else if (arg == "--scan-duty") {
+      options.scanDuty = true;
+    } else if (arg == "--serial-out" && hasValue) {
+      options.serialOut = argv[++i];
+    } else if (arg == "--replay" && hasValue) {
+      options.replay = argv[++i];
+    } else if (arg == "--uart-out" && hasValue) {
+      options.uartOut = argv[++i];
+    } else if (arg == "--speed" && hasValue) {
+      options.speed = atof(argv[++i]);
+    } else if (arg == "--command" && hasValue) {
+      options.commands.push_back(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [-v] [--serial-out FILE] [--capture] [--scan-duty] [--command JSON]... "
+                      "[--replay FILE.blecap [--speed X] [--uart-out FILE]]\n", argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    return 2;
+  }
+
+  FILE* serialSink = fopen(options.serialOut ? options.serialOut : "/dev/null", "w");
+  FILE* uartSink = options.uartOut ? fopen(options.uartOut, "wb") : nullptr;
+  if (!serialSink || (options.uartOut && !uartSink)) {
+    perror("fopen");
+    return 1;
+  }
+  Serial.hostSetSink(options.verbose ? stderr : serialSink);
+
+  NativeHAL::setModelScanDuty(options.scanDuty);
+  bool replaying = options.replay != nullptr;
+  if (!replaying) {
+    scheduleWalkScenario();
+  }
+  setup();
+  if (options.capture) {
+    setCaptureEnabled(true);
+  }
+  for (const std::string& command : options.commands) {
+    MeshtasticSerial.hostInject(command + "\n");
+  }
+
+  unsigned long endMs = END_MS;
+  long records = 0;
+  if (replaying) {
+    std::string error;
+    records = NativeHAL::loadCapture(options.replay, millis(), error);
+    if (records < 0) {
+      fprintf(stderr, "%s: %s\n", options.replay, error.c_str());
+      return 1;
+    }
+    NativeHAL::setDeliverWhileIdle(true);
+    endMs = (records > 0 ? NativeHAL::lastAdvertisementTime() : millis()) + REPLAY_TAIL_MS;
+  }
+
+  auto wallStart = std::chrono::steady_clock::now();
+  unsigned long virtualStart = millis();
+
+  long enterLatency = -1;
+  long leaveLatency = -1;
+  std::string pending;
+  while (millis() < endMs) {
+    loop();
+    NativeHAL::advanceMillis(LOOP_TICK_MS);
+
+    if (options.speed > 0) {
+      auto due = wallStart + std::chrono::duration<double, std::milli>((millis() - virtualStart) / options.speed);
+      std::this_thread::sleep_until(due);
+    }
+
+    std::string out = MeshtasticSerial.hostTakeOutput();
+    if (uartSink) {
+      fwrite(out.data(), 1, out.size(), uartSink);
+    }
+    pending += out;
+    size_t nl;
+    while ((nl = pending.find('\n')) != std::string::npos) {
+      std::string line = pending.substr(0, nl);
+      pending.erase(0, nl + 1);
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      printf("[%10.3f] %s\n", millis() / 1000.0, line.c_str());
+      unsigned long now = millis();
+      if (enterLatency < 0 && now >= ENTER_MS && line.find("\"crusher\":true") != std::string::npos) {
+        enterLatency = (long)(now - ENTER_MS);
+      }
+      if (leaveLatency < 0 && now >= LEAVE_MS && line.find("\"crusher\":false") != std::string::npos) {
+        leaveLatency = (long)(now - LEAVE_MS);
+      }
+    }
+  }
+
+  double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+  if (replaying) {
+    fprintf(stderr, "replayed=%ld delivered=%lu virtual_ms=%lu wall_ms=%.0f speedup=%.0f\n",
+            records, NativeHAL::deliveredAdvertisements(), millis() - virtualStart, wallMs,
+            wallMs > 0 ? (millis() - virtualStart) / wallMs : 0.0);
+  } else {
+    printf("enter_latency_ms=%ld leave_latency_ms=%ld delivered=%lu missed=%lu\n",
+           enterLatency, leaveLatency, NativeHAL::deliveredAdvertisements(), NativeHAL::missedAdvertisements());
+  }
+
+  if (uartSink) fclose(uartSink);
+  fclose(serialSink);
+  return 0;
+}
+
+#endif // NATIVE_HAL_NO_MAIN
@@ -0,0 +1,118 @@
+#include "AdaptiveScan.h"
+#include "Config.h"
+#include "ConfigManager.h"
+#include "Log.h"
+#include <atomic>
+
+// Von Verarbeitungsstufe bzw. BLE-Callback geschrieben, von loop() gelesen
+static std::atomic<uint32_t> lastActivityTime(0);
+static std::atomic<uint32_t> filteredAdvertisements(0);
+static std::atomic<bool> rampUpPending(false);
+static std::atomic<int> currentMode(SCAN_MODE_FULL);
+
+// Telemetrie (nur aus loop())
+static uint64_t radioOnMicros = 0;
+static uint32_t idleScanMs = 0;
+static uint32_t modeChanges = 0;
+static uint32_t lastRateCount = 0;
+static float advertisementRate = 0;
+
+// Auf den von BLE erlaubten Bereich begrenzen (2.5 ms bis 10.24 s); die
+// Umrechnung in 0.625-ms-Einheiten macht NimBLE selbst
+static uint16_t clampScanMs(int ms) {
+  if (ms < 3) {
+    return 3;
+  }
+  return ms > 10240 ? 10240 : (uint16_t)ms;
+}
+
+void noteFilteredAdvertisement(unsigned long now) {
+  filteredAdvertisements.fetch_add(1, std::memory_order_relaxed);
+  noteTrackedBeacon(now);
+}
+
+void noteTrackedBeacon(unsigned long now) {
+  lastActivityTime.store(now, std::memory_order_relaxed);
+  if (currentMode.load(std::memory_order_relaxed) == SCAN_MODE_IDLE) {
+    rampUpPending.store(true, std::memory_order_relaxed);
+  }
+}
+
+ScanParameters selectScanParameters(unsigned long now) {
+  uint32_t lastActivity = lastActivityTime.load(std::memory_order_relaxed);
+  // Aktivität aus einem anderen Task kann einen Tick neuer sein als now
+  bool quiet = (long)(now - lastActivity) >= (long)ConfigManager::getScanIdleDelay();
+  ScanMode mode = ConfigManager::getAdaptiveScan() && quiet ? SCAN_MODE_IDLE : SCAN_MODE_FULL;
+  
+  rampUpPending.store(false, std::memory_order_relaxed);
+  if (mode != currentMode.load(std::memory_order_relaxed)) {
+    currentMode.store(mode, std::memory_order_relaxed);
+    modeChanges++;
+    if (mode == SCAN_MODE_IDLE) {
+      LOG_INFO(LOG_SCAN, "Keine Beacon-Aktivität seit %d ms - Sparbetrieb (passiv, %d von %d ms)",
+               ConfigManager::getScanIdleDelay(), SCAN_IDLE_WINDOW, ConfigManager::getScanIdleLatency());
+    } else {
+      LOG_INFO(LOG_SCAN, "Beacon-Aktivität - volle Scan-Leistung");
+    }
+  }
+  // Aktivität zwischen Prüfung und Umschalten nicht verlieren
+  if (mode == SCAN_MODE_IDLE && lastActivityTime.load(std::memory_order_relaxed) != lastActivity) {
+    rampUpPending.store(true, std::memory_order_relaxed);
+  }
+  
+  ScanParameters parameters;
+  if (mode == SCAN_MODE_IDLE) {
+    parameters.active = false;
+    parameters.interval = clampScanMs(ConfigManager::getScanIdleLatency());
+    parameters.window = clampScanMs(SCAN_IDLE_WINDOW);
+    if (parameters.window > parameters.interval) {
+      parameters.window = parameters.interval;
+    }
+  } else {
+    parameters.active = ConfigManager::getActiveScan();
+    parameters.interval = ConfigManager::getScanInterval();
+    parameters.window = ConfigManager::getScanWindow();
+  }
+  return parameters;
+}
+
+bool isScanRampUpPending() {
+  return rampUpPending.load(std::memory_order_relaxed);
+}
+
+void accountScanWindow(unsigned long durationMs, const ScanParameters& parameters) {
+  if (parameters.interval > 0) {
+    radioOnMicros += (uint64_t)durationMs * 1000 * parameters.window / parameters.interval;
+  }
+  if (currentMode.load(std::memory_order_relaxed) == SCAN_MODE_IDLE) {
+    idleScanMs += durationMs;
+  }
+  
+  // Gleitender Mittelwert über die letzten Fenster
+  uint32_t count = filteredAdvertisements.load(std::memory_order_relaxed);
+  if (durationMs > 0) {
+    float windowRate = (count - lastRateCount) * 1000.0f / durationMs;
+    advertisementRate = 0.5f * advertisementRate + 0.5f * windowRate;
+  }
+  lastRateCount = count;
+}
+
+ScanMode getScanMode() {
+  return (ScanMode)currentMode.load(std::memory_order_relaxed);
+}
+
+uint32_t getRadioOnMs() {
+  return (uint32_t)(radioOnMicros / 1000);
+}
+
+uint32_t getScanIdleMs() {
+  return idleScanMs;
+}
+
+uint32_t getScanModeChanges() {
+  return modeChanges;
+}
+
+float getFilteredAdvertisementRate() {
+  return advertisementRate;
+}
@@ -0,0 +1,56 @@
+#ifndef ADAPTIVESCAN_H
+#define ADAPTIVESCAN_H
+
+#include <Arduino.h>
+
+// Passt das Tastverhältnis des BLE-Scans an die beobachtete Aktivität an.
+//
+// Volle Leistung: SCAN_INTERVAL/SCAN_WINDOW und ACTIVE_SCAN aus der
+// Konfiguration. Hat seit getScanIdleDelay() kein Gerät den MAC-Filter
+// passiert und verfolgt das Tracking keinen Beacon, wechselt der Scan in
+// den Sparbetrieb: passiv, SCAN_IDLE_WINDOW lauschen pro
+// getScanIdleLatency(). Ein Beacon, dessen Sendeintervall kürzer als
+// SCAN_IDLE_WINDOW ist, wird damit spätestens nach einem Sparintervall gehört,
+// langsamere meist nach ein bis zwei (NimBLE/Beacons streuen die Zeitpunkte
+// zufällig). Sobald das passiert, wird das
+// laufende Scan-Fenster abgebrochen und mit voller Leistung neu gestartet
+// (im blockierenden Scan erst beim nächsten scan()).
+//
+// Ohne adaptive_scan läuft der Scan immer mit voller Leistung; die
+// Funkzeit wird trotzdem geschätzt.
+
+enum ScanMode {
+  SCAN_MODE_FULL = 0,
+  SCAN_MODE_IDLE = 1
+};
+
+// Parameter für ein Scan-Fenster (Intervall und Fenster in Millisekunden,
+// wie NimBLEScan::setInterval/setWindow)
+struct ScanParameters {
+  bool active;
+  uint16_t interval;
+  uint16_t window;
+};
+
+// Ein Advertisement hat den MAC-Filter passiert; aus jedem Task aufrufbar
+void noteFilteredAdvertisement(unsigned long now);
+// Das Tracking verfolgt gerade einen Beacon
+void noteTrackedBeacon(unsigned long now);
+
+// Wählt die Betriebsart für das nächste Scan-Fenster (vor jedem Start)
+ScanParameters selectScanParameters(unsigned long now);
+
+// true, wenn im Sparbetrieb Aktivität auftrat und das Fenster neu starten soll
+bool isScanRampUpPending();
+
+// Nach jedem Scan-Fenster: Dauer und verwendete Parameter für die Funkzeit
+void accountScanWindow(unsigned long durationMs, const ScanParameters& parameters);
+
+// Telemetrie seit dem Start
+ScanMode getScanMode();
+uint32_t getRadioOnMs();        // Geschätzte Empfangszeit (Fensterdauer x Tastverhältnis)
+uint32_t getScanIdleMs();       // Davon im Sparbetrieb gescannt
+uint32_t getScanModeChanges();
+float getFilteredAdvertisementRate();  // Advertisements/s, die den Filter passiert haben (gleitend)
+
+#endif // ADAPTIVESCAN_H
@@ -0,0 +1,77 @@
+#include "AdvertisementCapture.h"
+#include "Config.h"
+#include "SpscRing.h"
+#include "Base64.h"
+
+static SpscRing<CaptureRecord, CAPTURE_QUEUE_LENGTH> captureRing;
+static volatile bool captureEnabled = CAPTURE_ADVERTISEMENTS;
+
+size_t encodeCaptureRecord(const CaptureRecord& record, uint8_t* out) {
+  out[0] = record.timestamp & 0xFF;
+  out[1] = (record.timestamp >> 8) & 0xFF;
+  out[2] = (record.timestamp >> 16) & 0xFF;
+  out[3] = (record.timestamp >> 24) & 0xFF;
+  memcpy(out + 4, record.address, 6);
+  out[10] = record.addressType;
+  out[11] = (uint8_t)record.rssi;
+  out[12] = record.payloadLength;
+  memcpy(out + CAPTURE_RECORD_HEADER_SIZE, record.payload, record.payloadLength);
+  return CAPTURE_RECORD_HEADER_SIZE + record.payloadLength;
+}
+
+void setCaptureEnabled(bool enabled) {
+  captureEnabled = enabled;
+  Serial.printf("Advertisement-Mitschnitt %s\n", enabled ? "aktiv" : "aus");
+}
+
+bool isCaptureEnabled() {
+  return captureEnabled;
+}
+
+void captureAdvertisement(NimBLEAdvertisedDevice* device, uint32_t timestamp) {
+  CaptureRecord record;
+  record.timestamp = timestamp;
+  
+  // NimBLE speichert die Adresse rückwärts (letztes Oktett zuerst)
+  NimBLEAddress address = device->getAddress();
+  const uint8_t* native = address.getNative();
+  for (int i = 0; i < 6; i++) {
+    record.address[i] = native[5 - i];
+  }
+  record.addressType = address.getType();
+  record.rssi = (int8_t)device->getRSSI();
+  
+  size_t length = device->getPayloadLength();
+  if (length > CAPTURE_MAX_PAYLOAD) {
+    length = CAPTURE_MAX_PAYLOAD;
+  }
+  record.payloadLength = (uint8_t)length;
+  memcpy(record.payload, device->getPayload(), length);
+  
+  captureRing.push(record);
+}
+
+int runCaptureOutput(Print& out) {
+  // "CAP:" + Base64 des längsten Datensatzes + "\r\n"
+  static constexpr size_t MAX_RECORD = CAPTURE_RECORD_HEADER_SIZE + CAPTURE_MAX_PAYLOAD;
+  uint8_t encoded[MAX_RECORD];
+  char line[4 + (MAX_RECORD + 2) / 3 * 4 + 2];
+  
+  int written = 0;
+  CaptureRecord record;
+  while (captureRing.pop(record)) {
+    size_t length = encodeCaptureRecord(record, encoded);
+    memcpy(line, "CAP:", 4);
+    size_t pos = 4 + base64Encode(encoded, length, line + 4);
+    line[pos++] = '\r';
+    line[pos++] = '\n';
+    // Eine Zeile pro write(), damit andere Ausgaben sie nicht zerteilen
+    out.write((const uint8_t*)line, pos);
+    written++;
+  }
+  return written;
+}
+
+uint32_t getDroppedCaptureRecords() {
+  return captureRing.dropped();
+}
@@ -0,0 +1,51 @@
+#ifndef ADVERTISEMENTCAPTURE_H
+#define ADVERTISEMENTCAPTURE_H
+
+#include <Arduino.h>
+#include <NimBLEAdvertisedDevice.h>
+
+// Mitschnitt der Advertisements, wie sie in onResult ankommen, zum späteren
+// Abspielen im Host-Build (.pio/build/native/program --replay).
+//
+// Aufzeichnungsformat (.blecap), alle Zahlen little-endian:
+//   Dateikopf:  "BLECAP" <Version 0x01> <0x00>             (8 Byte)
+//   Datensatz:  uint32  Zeitstempel (millis() beim Empfang)
+//               uint8   Adresse[6] in Textreihenfolge (aa:bb:cc:dd:ee:ff)
+//               uint8   Adresstyp (BLE_ADDR_PUBLIC/RANDOM)
+//               int8    RSSI
+//               uint8   Payload-Länge n (höchstens CAPTURE_MAX_PAYLOAD)
+//               uint8   Payload[n], Advertising- plus Scan-Response-Daten
+//
+// Auf der seriellen Konsole erscheint jeder Datensatz als eigene Zeile
+// "CAP:<base64>"; tools/blecap.py macht daraus eine .blecap-Datei.
+
+static constexpr uint8_t CAPTURE_FORMAT_VERSION = 1;
+static constexpr size_t CAPTURE_FILE_HEADER_SIZE = 8;
+static constexpr size_t CAPTURE_RECORD_HEADER_SIZE = 13;
+static constexpr size_t CAPTURE_MAX_PAYLOAD = 62;
+
+struct CaptureRecord {
+  uint32_t timestamp;
+  uint8_t address[6];
+  uint8_t addressType;
+  int8_t rssi;
+  uint8_t payloadLength;
+  uint8_t payload[CAPTURE_MAX_PAYLOAD];
+};
+
+// Schreibt den Datensatz im Dateiformat nach out (mind. CAPTURE_RECORD_HEADER_SIZE
+// + CAPTURE_MAX_PAYLOAD Byte), gibt die Länge zurück
+size_t encodeCaptureRecord(const CaptureRecord& record, uint8_t* out);
+
+// Mitschnitt ein-/ausschalten (Voreinstellung CAPTURE_ADVERTISEMENTS)
+void setCaptureEnabled(bool enabled);
+bool isCaptureEnabled();
+
+// Aus onResult: legt das Advertisement im Mitschnitt-Ring ab
+void captureAdvertisement(NimBLEAdvertisedDevice* device, uint32_t timestamp);
+
+// Aus loop(): schreibt wartende Datensätze als "CAP:"-Zeilen, gibt deren Anzahl zurück
+int runCaptureOutput(Print& out);
+uint32_t getDroppedCaptureRecords();
+
+#endif // ADVERTISEMENTCAPTURE_H
@@ -0,0 +1,140 @@
+#include "AdvertisingData.h"
+#include <cstring>
+
+// AD-Typen aus den Bluetooth Assigned Numbers
+static constexpr uint8_t AD_INCOMPLETE_UUID16 = 0x02;
+static constexpr uint8_t AD_COMPLETE_UUID16 = 0x03;
+static constexpr uint8_t AD_INCOMPLETE_UUID32 = 0x04;
+static constexpr uint8_t AD_COMPLETE_UUID32 = 0x05;
+static constexpr uint8_t AD_INCOMPLETE_UUID128 = 0x06;
+static constexpr uint8_t AD_COMPLETE_UUID128 = 0x07;
+static constexpr uint8_t AD_SHORT_NAME = 0x08;
+static constexpr uint8_t AD_COMPLETE_NAME = 0x09;
+static constexpr uint8_t AD_TX_POWER = 0x0A;
+static constexpr uint8_t AD_SERVICE_DATA16 = 0x16;
+static constexpr uint8_t AD_MANUFACTURER_DATA = 0xFF;
+
+static constexpr uint16_t COMPANY_APPLE = 0x004C;
+static constexpr uint16_t EDDYSTONE_SERVICE_UUID = 0xFEAA;
+static constexpr int EDDYSTONE_LOSS_AT_1M = 41;  // dB zwischen 0 m und 1 m laut Eddystone-Spezifikation
+
+static void setView(ByteView& view, const uint8_t* data, uint8_t length) {
+  if (!view.present()) {
+    view.data = data;
+    view.length = length;
+  }
+}
+
+// Listen ohne eine vollständige UUID zählen nicht, ein späteres Feld kann sie ersetzen
+static void setUuidList(ByteView& view, const uint8_t* data, uint8_t length, uint8_t uuidSize) {
+  if (length >= uuidSize) {
+    setView(view, data, (uint8_t)(length - length % uuidSize));
+  }
+}
+
+static void parseManufacturerData(const uint8_t* data, uint8_t length, AdvertisingData& out) {
+  if (out.manufacturerData.present()) {
+    return;
+  }
+  setView(out.manufacturerData, data, length);
+  if (length < 2) {
+    return;
+  }
+  out.hasManufacturerId = true;
+  out.manufacturerId = data[0] | (data[1] << 8);
+
+  // iBeacon: 4C 00 02 15, UUID[16], Major[2], Minor[2], Leistung in 1 m
+  if (out.manufacturerId == COMPANY_APPLE && length == 25 && data[2] == 0x02 && data[3] == 0x15) {
+    out.isIBeacon = true;
+    out.iBeacon.uuid = data + 4;
+    out.iBeacon.major = (uint16_t)((data[20] << 8) | data[21]);
+    out.iBeacon.minor = (uint16_t)((data[22] << 8) | data[23]);
+    out.iBeacon.measuredPower = (int8_t)data[24];
+  }
+}
+
+static void parseServiceData16(const uint8_t* data, uint8_t length, AdvertisingData& out) {
+  if (out.isEddystone || length < 3 || (data[0] | (data[1] << 8)) != EDDYSTONE_SERVICE_UUID) {
+    return;
+  }
+  EddystoneFrame& frame = out.eddystone;
+  frame.frameType = data[2];
+  frame.hasTxPower = (frame.frameType == EDDYSTONE_UID || frame.frameType == EDDYSTONE_URL ||
+                      frame.frameType == EDDYSTONE_EID) && length >= 4;
+  frame.txPowerAt0m = frame.hasTxPower ? (int8_t)data[3] : 0;
+  uint8_t header = frame.hasTxPower ? 4 : 3;
+  frame.data.data = data + header;
+  frame.data.length = (uint8_t)(length - header);
+  out.isEddystone = true;
+}
+
+bool parseAdvertisingData(const uint8_t* payload, size_t length, AdvertisingData& out) {
+  memset(&out, 0, sizeof(out));
+  ByteView shortName = {nullptr, 0};
+  bool complete = true;
+
+  size_t pos = 0;
+  while (pos + 1 < length) {
+    uint8_t fieldLength = payload[pos];
+    if (fieldLength == 0) {
+      break;  // Rest ist Auffüllung
+    }
+    if (pos + 1 + fieldLength > length) {
+      complete = false;
+      break;
+    }
+    uint8_t type = payload[pos + 1];
+    const uint8_t* data = payload + pos + 2;
+    uint8_t dataLength = fieldLength - 1;
+
+    switch (type) {
+      case AD_COMPLETE_NAME:
+        setView(out.name, data, dataLength);
+        break;
+      case AD_SHORT_NAME:
+        setView(shortName, data, dataLength);
+        break;
+      case AD_MANUFACTURER_DATA:
+        parseManufacturerData(data, dataLength, out);
+        break;
+      case AD_INCOMPLETE_UUID16:
+      case AD_COMPLETE_UUID16:
+        setUuidList(out.serviceUuids16, data, dataLength, 2);
+        break;
+      case AD_INCOMPLETE_UUID32:
+      case AD_COMPLETE_UUID32:
+        setUuidList(out.serviceUuids32, data, dataLength, 4);
+        break;
+      case AD_INCOMPLETE_UUID128:
+      case AD_COMPLETE_UUID128:
+        setUuidList(out.serviceUuids128, data, dataLength, 16);
+        break;
+      case AD_TX_POWER:
+        if (dataLength >= 1 && !out.hasTxPower) {
+          out.hasTxPower = true;
+          out.txPower = (int8_t)data[0];
+        }
+        break;
+      case AD_SERVICE_DATA16:
+        parseServiceData16(data, dataLength, out);
+        break;
+      default:
+        break;
+    }
+    pos += 1 + fieldLength;
+  }
+
+  // Wie NimBLE: der vollständige Name hat Vorrang
+  if (!out.name.present()) {
+    out.name = shortName;
+  }
+
+  if (out.isIBeacon) {
+    out.hasMeasuredPower = true;
+    out.measuredPower = out.iBeacon.measuredPower;
+  } else if (out.isEddystone && out.eddystone.hasTxPower) {
+    out.hasMeasuredPower = true;
+    out.measuredPower = (int8_t)(out.eddystone.txPowerAt0m - EDDYSTONE_LOSS_AT_1M);
+  }
+  return complete;
+}
@@ -0,0 +1,84 @@
+#ifndef ADVERTISINGDATA_H
+#define ADVERTISINGDATA_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Zerlegt die rohen Advertising- und Scan-Response-Daten eines
+// Advertisements in einem Durchlauf. Alle Felder sind Ansichten in den
+// Payload: nichts wird kopiert oder allokiert, die Zeiger gelten, solange der
+// Payload lebt (in onResult also nur während des Callbacks).
+//
+// Ersetzt haveName/getName, getManufacturerData und getServiceUUID von
+// NimBLE, die jedes Mal die AD-Strukturen erneut durchlaufen und einen
+// std::string zurückgeben.
+
+// Zeiger und Länge eines Felds im Payload; data == nullptr: Feld fehlt
+struct ByteView {
+  const uint8_t* data;
+  uint8_t length;
+
+  bool present() const { return data != nullptr; }
+};
+
+// iBeacon-Rahmen in den Herstellerdaten von Apple (0x004C, Typ 0x02 0x15)
+struct IBeaconFrame {
+  const uint8_t* uuid;  // 16 Byte, Big Endian wie im Rahmen
+  uint16_t major;
+  uint16_t minor;
+  int8_t measuredPower;  // RSSI in 1 m, dBm
+};
+
+// Eddystone-Rahmen in den Service-Daten zu 0xFEAA
+enum EddystoneFrameType : uint8_t {
+  EDDYSTONE_UID = 0x00,
+  EDDYSTONE_URL = 0x10,
+  EDDYSTONE_TLM = 0x20,
+  EDDYSTONE_EID = 0x30,
+};
+
+struct EddystoneFrame {
+  uint8_t frameType;   // EddystoneFrameType
+  bool hasTxPower;     // UID, URL und EID enthalten die Sendeleistung in 0 m
+  int8_t txPowerAt0m;  // dBm
+  ByteView data;       // Rahmen ohne Typ- und Leistungsbyte
+};
+
+struct AdvertisingData {
+  // Vollständiger Name (0x09), sonst verkürzter Name (0x08); nicht nullterminiert
+  ByteView name;
+  // Herstellerdaten (0xFF) samt Company ID in den ersten zwei Bytes
+  ByteView manufacturerData;
+  bool hasManufacturerId;
+  uint16_t manufacturerId;
+
+  // Service-UUIDs als Listen (0x02/0x03, 0x04/0x05, 0x06/0x07), Little Endian,
+  // Länge ein Vielfaches der UUID-Größe. Mehrere Felder derselben Größe
+  // (vollständig oder nicht): nur das erste mit mindestens einer UUID zählt.
+  ByteView serviceUuids16;  // je 2 Byte
+  ByteView serviceUuids32;  // je 4 Byte
+  ByteView serviceUuids128;  // je 16 Byte
+
+  bool hasTxPower;  // TX Power Level (0x0A)
+  int8_t txPower;
+
+  bool isIBeacon;
+  IBeaconFrame iBeacon;
+  bool isEddystone;
+  EddystoneFrame eddystone;
+
+  // Vom Beacon angegebener RSSI in 1 m: iBeacon direkt, Eddystone aus der
+  // Sendeleistung in 0 m minus 41 dB (Freiraumdämpfung auf 1 m)
+  bool hasMeasuredPower;
+  int8_t measuredPower;
+
+  size_t serviceUuid16Count() const { return serviceUuids16.length / 2; }
+  size_t serviceUuid32Count() const { return serviceUuids32.length / 4; }
+  size_t serviceUuid128Count() const { return serviceUuids128.length / 16; }
+};
+
+// Durchläuft payload einmal und füllt out. Gibt false zurück, wenn eine
+// AD-Struktur über das Ende hinausragt; die Felder davor bleiben gültig.
+bool parseAdvertisingData(const uint8_t* payload, size_t length, AdvertisingData& out);
+
+#endif // ADVERTISINGDATA_H
@@ -1,74 +1,261 @@
 #include "BLEScanner.h"
 #include "Config.h"
 #include "BeaconTracker.h"
+#include "ConfigManager.h"
+#include "Pipeline.h"
+#include "AdvertisementCapture.h"
+#include "Log.h"
+#include "AdvertisingData.h"
+#include "Stats.h"
+#include "MemoryGovernor.h"
 
 // Global instance
 BLEScanner bleScanner;
 
 // Global variables from Config.h
-std::set<std::string> filteredDevices;
+MacAllowlist filteredDevices(MAC_FILTER_CAPACITY);
 int devicesInRangeCount = 0;
 
+static uint16_t internDeviceName(const char* name, DeviceInfo& deviceInfo);
+static void armDeviceTimer(MacAddress deviceAddress, DeviceInfo& deviceInfo, uint32_t now);
+static void applyFilteredDistance(MacAddress deviceAddress, DeviceInfo& deviceInfo);
+#if FILTER_BANK
+static void stageFilterSample(MacAddress deviceAddress, DeviceInfo& deviceInfo, int rssi, float rawDistance, uint32_t timestamp);
+#endif
+
 // Callback implementation
 void MyAdvertisedDeviceCallbacks::onResult(NimBLEAdvertisedDevice* advertisedDevice) {
-  std::string deviceAddress = advertisedDevice->getAddress().toString();
+  AdvertisementEvent event;
+  decodeAdvertisement(advertisedDevice, event);
+  noteAdvertisementReceived();
+#if STREAMING_SCAN
+  bleScanner.countAddress(event.address);
+#endif
+  
+  if (isCaptureEnabled()) {
+    captureAdvertisement(advertisedDevice, event.timestamp);
+  }
+  
+  bleScanner.handleAdvertisement(event);
+}
+
+void decodeAdvertisement(NimBLEAdvertisedDevice* advertisedDevice, AdvertisementEvent& event) {
+  NimBLEAddress address = advertisedDevice->getAddress();
+  event.address = macFromNative(address.getNative());
+  
+  event.rssi = advertisedDevice->getRSSI();
+  event.timestamp = millis();
+  
+  // Ein Durchlauf über die Rohdaten; kopiert wird nur, was ins Event gehört
+  AdvertisingData data;
+  parseAdvertisingData(advertisedDevice->getPayload(), advertisedDevice->getPayloadLength(), data);
+  
+  event.hasName = data.name.present();
+  size_t nameLength = 0;
+  while (nameLength < data.name.length && nameLength < sizeof(event.name) - 1 && data.name.data[nameLength] != 0) {
+    event.name[nameLength] = (char)data.name.data[nameLength];
+    nameLength++;
+  }
+  event.name[nameLength] = '\0';
+  
+  event.hasManufacturerId = data.hasManufacturerId;
+  event.manufacturerId = data.manufacturerId;
+  
+  // Binär übernehmen; als Text erst bei der Ausgabe (formatServiceUuid).
+  // Wie NimBLEs getServiceUUID(): die erste 16-Bit-UUID, sonst 32, sonst 128 Bit.
+  memset(&event.serviceUuid, 0, sizeof(event.serviceUuid));
+  if (data.serviceUuid16Count() > 0) {
+    memcpy(event.serviceUuid.value, data.serviceUuids16.data, 2);
+    event.serviceUuid.bits = 16;
+  } else if (data.serviceUuid32Count() > 0) {
+    memcpy(event.serviceUuid.value, data.serviceUuids32.data, 4);
+    event.serviceUuid.bits = 32;
+  } else if (data.serviceUuid128Count() > 0) {
+    memcpy(event.serviceUuid.value, data.serviceUuids128.data, 16);
+    event.serviceUuid.bits = 128;
+  }
+}
+
+void processAdvertisement(const AdvertisementEvent& event) {
+  MacAddress deviceAddress = event.address;
   
   // Check if device is in our filter (if filter is active)
   if (!isDeviceInFilter(deviceAddress)) {
     // Skip devices not in our filter
+    noteAdvertisementFilteredOut();
     return;
   }
+  noteFilteredAdvertisement(event.timestamp);
   
-  int rssi = advertisedDevice->getRSSI();
+  int rssi = event.rssi;
   
-  // Get or create device info
-  DeviceInfo& deviceInfo = deviceInfoMap[deviceAddress];
+  // Unbekanntes Gerät außerhalb des Schwellenwerts gar nicht erst anlegen.
+  // Bekannte Geräte brauchen auch schwache Messungen, sonst verlassen sie
+  // den Bereich erst mit dem Timeout.
+  if (!isRssiWithinThreshold(rssi) && deviceTable.find(deviceAddress) == nullptr) {
+    return;
+  }
+  
+  // Get or create device info; a full table evicts its least recently seen device
+  uint32_t evictionsBefore = deviceTable.evictions();
+  bool inserted = false;
+  DeviceInfo& deviceInfo = deviceTable.findOrInsert(deviceAddress, event.timestamp, &inserted);
+  if (deviceTable.evictions() != evictionsBefore) {
+    inRangeIndex.remove(deviceTable.lastEvicted());
+    noteDeviceEvictions(EVICT_TABLE_FULL);
+  }
+#if !FILTER_BANK
+  if (inserted) {
+    deviceInfo.rssiFilter.setWindowSize(ConfigManager::getWindowSize());
+    deviceInfo.distanceFilter.setWindowSize(ConfigManager::getWindowSize());
+    deviceInfo.kalmanFilter.setNoise(ConfigManager::getProcessNoise(), ConfigManager::getMeasurementNoise());
+    deviceInfo.velocityFilter.setNoise(ConfigManager::getProcessNoise(), ConfigManager::getMeasurementNoise());
+  }
+#endif
   
   // Update RSSI
   deviceInfo.rssi = rssi;
   
   // Update time last seen
-  deviceInfo.lastSeen = millis();
+  deviceInfo.lastSeen = event.timestamp;
+  armDeviceTimer(deviceAddress, deviceInfo, event.timestamp);
   
   // Calculate and filter distance
   float rawDistance = rssiToMeters(rssi);
   deviceInfo.rawDistance = rawDistance;
   
+#if !FILTER_BANK
   // Apply Kalman filter
-  deviceInfo.filteredDistance = deviceInfo.kalmanFilter.update(rawDistance);
+  if (ConfigManager::getDistanceTracker() == TRACKER_VELOCITY) {
+    deviceInfo.filteredDistance = deviceInfo.velocityFilter.update(rawDistance, event.timestamp);
+  } else {
+    deviceInfo.filteredDistance = deviceInfo.kalmanFilter.update(rawDistance);
+  }
   
   // Apply moving average filters
   deviceInfo.avgRssi = deviceInfo.rssiFilter.update(rssi);
   deviceInfo.avgDistance = deviceInfo.distanceFilter.update(deviceInfo.filteredDistance);
+#endif
   
-  // Update device name if available
-  if (advertisedDevice->haveName()) {
-    deviceInfo.name = advertisedDevice->getName();
-  } else if (deviceInfo.name.empty()) {
-    deviceInfo.name = "Unknown";
-  }
-  
-  // Try to identify device type based on manufacturer data
-  if (advertisedDevice->haveManufacturerData()) {
-    std::string strManufacturerData = advertisedDevice->getManufacturerData();
-    uint8_t* manufacturerData = (uint8_t*)strManufacturerData.data();
-    
-    if (strManufacturerData.length() >= 2) {
-      uint16_t manufacturerId = manufacturerData[0] | (manufacturerData[1] << 8);
-      char idStr[7];
-      sprintf(idStr, "0x%04X", manufacturerId);
-      deviceInfo.manufacturerId = idStr;
-      deviceInfo.manufacturerName = getManufacturerName(manufacturerId).c_str();
-    }
+  // Unter Speicherdruck Name und Service-UUID nur für geschützte Geräte (isProtectedDevice)
+  bool keepMetadata = keepDeviceMetadata(deviceAddress);
+  
+  // Name nur neu eintragen, wenn er sich geändert hat
+  if (keepMetadata && event.hasName && !namePool.equals(deviceInfo.nameId, event.name)) {
+    deviceInfo.nameId = internDeviceName(event.name, deviceInfo);
+  }
+  
+  // Hersteller-ID und Service-UUID bleiben Zahlen, Text erst bei der Ausgabe
+  if (event.hasManufacturerId) {
+    deviceInfo.manufacturerId = event.manufacturerId;
+    deviceInfo.hasManufacturerId = true;
   }
   
   // Additional service information if available
-  if (advertisedDevice->haveServiceUUID()) {
-    deviceInfo.serviceUUID = advertisedDevice->getServiceUUID().toString();
+  if (keepMetadata && event.serviceUuid.bits != 0) {
+    deviceInfo.serviceUuid = event.serviceUuid;
+  }
+  
+#if FILTER_BANK
+  // Filter laufen gesammelt in flushFilterBank(), danach auch der Rest unten
+  stageFilterSample(deviceAddress, deviceInfo, rssi, rawDistance, event.timestamp);
+#else
+  applyFilteredDistance(deviceAddress, deviceInfo);
+#endif
+}
+
+// Einträge im Namensvorrat werden nur frei, wenn ein Gerät seinen Namen
+// wechselt oder aus deviceTable verdrängt wird. Nur dann lohnt es sich, bei
+// vollem Vorrat die Tabelle nach noch benutzten Namen zu durchsuchen.
+static bool namesReleased = false;
+static uint32_t evictionsAtCollect = 0;
+
+static uint16_t internDeviceName(const char* name, DeviceInfo& deviceInfo) {
+  if (deviceInfo.nameId != NamePool::NO_NAME) {
+    deviceInfo.nameId = NamePool::NO_NAME;
+    namesReleased = true;
+  }
+  if (namePool.full() && (namesReleased || deviceTable.evictions() != evictionsAtCollect)) {
+    namePool.beginCollect();
+    deviceTable.forEach([](MacAddress, DeviceInfo& device) {
+      namePool.mark(device.nameId);
+    });
+    namePool.sweep();
+    namesReleased = false;
+    evictionsAtCollect = deviceTable.evictions();
+  }
+  return namePool.intern(name);
+}
+
+size_t dropUnlistedMetadata() {
+  size_t dropped = 0;
+  deviceTable.forEach([&dropped](MacAddress address, DeviceInfo& device) {
+    if ((device.nameId == NamePool::NO_NAME && device.serviceUuid.bits == 0) ||
+        isProtectedDevice(address)) {
+      return;
+    }
+    if (device.nameId != NamePool::NO_NAME) {
+      device.nameId = NamePool::NO_NAME;
+      namesReleased = true;
+    }
+    device.serviceUuid.bits = 0;
+    dropped++;
+  });
+  return dropped;
+}
+
+// Marken der Timer in deviceTimers
+static constexpr uint8_t TIMER_PRESENCE = 0;  // Fällig: nicht mehr in Reichweite
+static constexpr uint8_t TIMER_EVICT = 1;     // Fällig: aus deviceTable löschen
+
+// Jedes Advertisement schiebt die Anwesenheitsfrist des Geräts hinaus (O(1))
+static void armDeviceTimer(MacAddress deviceAddress, DeviceInfo& deviceInfo, uint32_t now) {
+  if (!deviceTimers.owns(deviceInfo.timerId, deviceAddress)) {
+    deviceInfo.timerId = deviceTimers.acquire(deviceAddress);
+    if (deviceInfo.timerId == TimerWheel::NO_TIMER) {
+      // Timer verdrängter Geräte zurückholen; es gibt so viele Timer wie
+      // Tabelleneinträge, danach ist also sicher einer frei
+      deviceTimers.reclaim([](MacAddress owner, uint16_t id) {
+        DeviceInfo* device = deviceTable.find(owner);
+        return device == nullptr || device->timerId != id;
+      });
+      deviceInfo.timerId = deviceTimers.acquire(deviceAddress);
+    }
   }
+  deviceTimers.arm(deviceInfo.timerId, now + IN_RANGE_MAX_AGE_MS, TIMER_PRESENCE);
+}
+
+size_t expireDevices(uint32_t now) {
+  return deviceTimers.advance(now, [](uint16_t id) {
+    MacAddress address = deviceTimers.owner(id);
+    DeviceInfo* device = deviceTable.find(address);
+    if (device == nullptr || device->timerId != id) {
+      // Gerät inzwischen verdrängt
+      deviceTimers.release(id);
+      return;
+    }
+    if (deviceTimers.tag(id) == TIMER_PRESENCE) {
+      inRangeIndex.remove(address);
+      deviceTimers.arm(id, device->lastSeen + DEVICE_IDLE_EVICT_MS, TIMER_EVICT);
+      return;
+    }
+    LOG_DEBUG(LOG_SCAN, "Gerät %s seit %lu s nicht gesehen - gelöscht", macToString(address).text,
+              (unsigned long)(DEVICE_IDLE_EVICT_MS / 1000));
+    deviceTimers.release(id);
+    noteDeviceEvictions(EVICT_IDLE);
+    if (device->nameId != NamePool::NO_NAME) {
+      namesReleased = true;
+    }
+    // Der Platz in filterBank wird wie bei Verdrängung beim nächsten Engpass zurückgeholt
+    deviceTable.erase(address);
+  });
+}
+
+static void applyFilteredDistance(MacAddress deviceAddress, DeviceInfo& deviceInfo) {
+  updateInRangeIndex(deviceAddress, deviceInfo);
   
   // Check if this device is now closer than our current closest
-  if (deviceInfo.filteredDistance <= DISTANCE_THRESHOLD) {
+  if (deviceInfo.filteredDistance <= ConfigManager::getDistanceThreshold()) {
     // Compare with current closest
     if (deviceInfo.filteredDistance < getCurrentClosestBeaconDistance() && 
         deviceAddress != getCurrentClosestBeaconAddress()) {
@@ -81,30 +268,175 @@ void MyAdvertisedDeviceCallbacks::onResult(NimBLEAdvertisedDevice* advertisedDev
   }
 }
 
+#if FILTER_BANK
+static void stageFilterSample(MacAddress deviceAddress, DeviceInfo& deviceInfo, int rssi, float rawDistance, uint32_t timestamp) {
+  if (!filterBank.owns(deviceInfo.filterSlot, deviceAddress)) {
+    deviceInfo.filterSlot = filterBank.acquire(deviceAddress);
+    if (deviceInfo.filterSlot == FilterBank::NO_SLOT) {
+      // Plätze verdrängter Geräte zurückholen; es gibt so viele Plätze wie
+      // Tabelleneinträge, danach ist also sicher einer frei
+      flushFilterBank();
+      filterBank.reclaim([](MacAddress owner, uint16_t slot) {
+        DeviceInfo* device = deviceTable.find(owner);
+        return device == nullptr || device->filterSlot != slot;
+      });
+      deviceInfo.filterSlot = filterBank.acquire(deviceAddress);
+      if (deviceInfo.filterSlot == FilterBank::NO_SLOT) {
+        LOG_ERROR(LOG_SCAN, "Filterbank voll - Messung verworfen");
+        return;
+      }
+    }
+  }
+  
+  if (!filterBank.stage(deviceInfo.filterSlot, (float)rssi, rawDistance, timestamp)) {
+    // Schon FILTER_BANK_SAMPLES Messungen in diesem Durchlauf: jetzt rechnen
+    flushFilterBank();
+    filterBank.stage(deviceInfo.filterSlot, (float)rssi, rawDistance, timestamp);
+  }
+}
+#endif
+
+void flushFilterBank() {
+#if FILTER_BANK
+  filterBank.update([](uint16_t slot) {
+    MacAddress address = filterBank.owner(slot);
+    DeviceInfo* device = deviceTable.find(address);
+    if (device == nullptr || device->filterSlot != slot) {
+      // Gerät inzwischen verdrängt
+      filterBank.release(slot);
+      return;
+    }
+    device->filteredDistance = filterBank.distance(slot);
+    device->avgRssi = filterBank.averageRssi(slot);
+    device->avgDistance = filterBank.averageDistance(slot);
+    applyFilteredDistance(address, *device);
+  });
+#endif
+}
+
 // BLEScanner implementation
-BLEScanner::BLEScanner() : pBLEScan(nullptr) {
+BLEScanner::BLEScanner() :
+  pBLEScan(nullptr),
+  continuousMode(false),
+  scanWindowDone(false),
+  lastWindowCount(0),
+  windowStart(0),
+  windowParameters() {
 }
 
 void BLEScanner::init() {
   NimBLEDevice::init("");
   pBLEScan = NimBLEDevice::getScan();
   pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks(), true);
-  pBLEScan->setActiveScan(ACTIVE_SCAN);
-  pBLEScan->setInterval(SCAN_INTERVAL);
-  pBLEScan->setWindow(SCAN_WINDOW);
+#if STREAMING_SCAN
+  // Ergebnisse nur an den Callback geben, NimBLE gibt sie danach sofort frei
+  pBLEScan->setMaxResults(0);
+#endif
+  applySettings();
+  
+  continuousMode = CONTINUOUS_SCAN;
+}
+
+void BLEScanner::applySettings() {
+  // Volle Leistung oder Sparbetrieb, je nach Beacon-Aktivität
+  windowParameters = selectScanParameters(millis());
+  pBLEScan->setActiveScan(windowParameters.active);
+  pBLEScan->setInterval(windowParameters.interval);
+  pBLEScan->setWindow(windowParameters.window);
 }
 
 int BLEScanner::scan() {
-  NimBLEScanResults results = pBLEScan->start(SCAN_TIME, false);
+  applySettings();
+  windowStart = millis();
+#if STREAMING_SCAN
+  windowAddresses.clear();
+#endif
+  NimBLEScanResults results = pBLEScan->start(ConfigManager::getScanTime(), false);
+  accountScanWindow(millis() - windowStart, windowParameters);
+  recordStat(STATS_SCAN, millis() - windowStart);
+#if STREAMING_SCAN
+  (void)results;
+  return (int)windowAddresses.count();
+#else
   return results.getCount();
+#endif
 }
 
 void BLEScanner::clearResults() {
   pBLEScan->clearResults();
 }
 
-// Implementation of global functions from Config.h
-float rssiToMeters(int rssi) {
+void BLEScanner::startContinuous() {
+  // Scan-Parameter bei jedem Fenster neu übernehmen, damit Konfigurationsänderungen greifen
+  applySettings();
+  scanWindowDone = false;
+  windowStart = millis();
+#if STREAMING_SCAN
+  windowAddresses.clear();
+#endif
+  pBLEScan->start(ConfigManager::getScanTime(), onScanWindowComplete, false);
+}
+
+void BLEScanner::stopScanWindow() {
+  // NimBLE ruft dabei onScanWindowComplete auf, loop() startet neu
+  if (continuousMode && pBLEScan->isScanning()) {
+    pBLEScan->stop();
+  }
+}
+
+void BLEScanner::onScanWindowComplete(NimBLEScanResults results) {
+#if STREAMING_SCAN
+  (void)results;
+  bleScanner.lastWindowCount = (int)bleScanner.windowAddresses.count();
+#else
+  bleScanner.lastWindowCount = results.getCount();
+#endif
+  bleScanner.scanWindowDone = true;
+  notifyLoop();
+}
+
+bool BLEScanner::pollScanWindow(int& deviceCount) {
+  if (!scanWindowDone) {
+    return false;
+  }
+  deviceCount = lastWindowCount;
+  scanWindowDone = false;
+  accountScanWindow(millis() - windowStart, windowParameters);
+  recordStat(STATS_SCAN, millis() - windowStart);
+  return true;
+}
+
+void BLEScanner::handleAdvertisement(const AdvertisementEvent& event) {
+  if (!continuousMode) {
+    // Blockierender Scan: loop() wartet in scan(), daher direkt verarbeiten
+    processAdvertisement(event);
+    return;
+  }
+  if (eventRing.push(event)) {
+    notifyProcessingStage();
+  }
+}
+
+int BLEScanner::processEvents() {
+  int processed = 0;
+  AdvertisementEvent event;
+  while (eventRing.pop(event)) {
+    processAdvertisement(event);
+    processed++;
+  }
+  return processed;
+}
+
+// Wertebereich des BLE-RSSI (int8 laut Spezifikation, -127..+20 dBm)
+static constexpr int RSSI_TABLE_MIN = -127;
+static constexpr int RSSI_TABLE_MAX = 20;
+
+// Entfernung je RSSI-Wert, wird bei jeder Änderung der Kalibrierung neu berechnet
+static float distanceByRssi[RSSI_TABLE_MAX - RSSI_TABLE_MIN + 1];
+// Schwächster RSSI, dessen Rohdistanz noch innerhalb des Schwellenwerts liegt
+static int rssiCutoff = RSSI_TABLE_MIN;
+
+static float computeDistance(int rssi) {
   if (rssi == 0) {
     return -1.0; // Invalid RSSI
   }
@@ -112,62 +444,114 @@ float rssiToMeters(int rssi) {
   // Calculate distance using log-distance path loss model
   // d = 10^((TxPower - RSSI)/(10 * n))
   // where n is the path loss exponent
-  float ratio = (TX_POWER - rssi) / (10.0 * ENVIRONMENTAL_FACTOR);
+  float ratio = (ConfigManager::getTxPower() - rssi) / (10.0 * ConfigManager::getEnvironmentalFactor());
   float rawDistance = pow(10.0, ratio);
   
   // Apply correction factor based on empirical calibration
-  float correctedDistance = rawDistance + DISTANCE_CORRECTION;
+  float correctedDistance = rawDistance + ConfigManager::getDistanceCorrection();
   
   // Ensure we don't have negative distances
   return (correctedDistance > 0) ? correctedDistance : 0.1;
 }
 
-bool isDeviceInFilter(const std::string& address) {
+// Implementation of global functions from Config.h
+void rebuildDistanceTable() {
+  for (int rssi = RSSI_TABLE_MIN; rssi <= RSSI_TABLE_MAX; rssi++) {
+    distanceByRssi[rssi - RSSI_TABLE_MIN] = computeDistance(rssi);
+  }
+  
+  // Alles unterhalb der Grenze liegt sicher außerhalb, auch wenn die
+  // Kurve (z.B. bei env_factor <= 0) nicht monoton fällt
+  rssiCutoff = RSSI_TABLE_MAX + 1;
+  for (int rssi = RSSI_TABLE_MIN; rssi <= RSSI_TABLE_MAX; rssi++) {
+    if (rssi != 0 && distanceByRssi[rssi - RSSI_TABLE_MIN] <= ConfigManager::getDistanceThreshold()) {
+      rssiCutoff = rssi;
+      break;
+    }
+  }
+}
+
+void applyWindowSize(int windowSize) {
+#if FILTER_BANK
+  // Gesammelte Messungen noch mit dem alten Fenster rechnen
+  flushFilterBank();
+  filterBank.setWindowSize(windowSize);
+  deviceTable.forEach([](MacAddress address, DeviceInfo& device) {
+    if (filterBank.owns(device.filterSlot, address)) {
+      device.avgRssi = filterBank.averageRssi(device.filterSlot);
+      device.avgDistance = filterBank.averageDistance(device.filterSlot);
+    }
+  });
+#else
+  // Die Fenster liegen im Geräteeintrag, es wird nur umsortiert
+  deviceTable.forEach([windowSize](MacAddress address, DeviceInfo& device) {
+    (void)address;
+    device.rssiFilter.setWindowSize(windowSize);
+    device.distanceFilter.setWindowSize(windowSize);
+    device.avgRssi = device.rssiFilter.getValue();
+    device.avgDistance = device.distanceFilter.getValue();
+  });
+#endif
+}
+
+// Modell, mit dem die Geräte in deviceTable zuletzt gerechnet wurden
+static DistanceTracker activeTracker = DISTANCE_TRACKER;
+
+void applyDistanceTracker(DistanceTracker tracker, float processNoise, float measurementNoise) {
+#if FILTER_BANK
+  // Gesammelte Messungen noch mit dem alten Modell rechnen
+  flushFilterBank();
+  filterBank.setDistanceTracker(tracker, processNoise, measurementNoise);
+#else
+  bool switched = tracker != activeTracker;
+  deviceTable.forEach([=](MacAddress address, DeviceInfo& device) {
+    (void)address;
+    device.kalmanFilter.setNoise(processNoise, measurementNoise);
+    device.velocityFilter.setNoise(processNoise, measurementNoise);
+    // Beim Wechsel übernimmt das neue Modell die bisherige Schätzung
+    if (switched && tracker == TRACKER_VELOCITY) {
+      device.velocityFilter.seed(device.filteredDistance, device.lastSeen);
+    } else if (switched) {
+      device.kalmanFilter.seed(device.filteredDistance, device.velocityFilter.getVariance());
+    }
+  });
+#endif
+  activeTracker = tracker;
+}
+
+float rssiToMeters(int rssi) {
+  if (rssi < RSSI_TABLE_MIN || rssi > RSSI_TABLE_MAX) {
+    return computeDistance(rssi);
+  }
+  return distanceByRssi[rssi - RSSI_TABLE_MIN];
+}
+
+bool isRssiWithinThreshold(int rssi) {
+  return rssi >= rssiCutoff;
+}
+
+int getRssiCutoff() {
+  return rssiCutoff;
+}
+
+bool isDeviceInFilter(MacAddress address) {
   // If filter is not active, accept all devices
-  if (!USE_DEVICE_FILTER) {
+  if (!ConfigManager::getUseDeviceFilter()) {
     return true;
   }
   
   // Otherwise, check if the device is in our filtered list
-  return filteredDevices.find(address) != filteredDevices.end();
+  return filteredDevices.contains(address);
 }
 
 void parseDeviceFilter() {
-  if (!USE_DEVICE_FILTER || DEVICE_FILTER.length() == 0) {
-    Serial.println("Device filter is disabled. All devices will be monitored.");
-    return;
-  }
-  
   // Clear previous filter
   filteredDevices.clear();
   
-  // Parse the filter string
-  String filterStr = DEVICE_FILTER;
-  int idx = 0;
-  int lastIdx = 0;
-  
-  // Find commas and extract MAC addresses
-  while ((idx = filterStr.indexOf(',', lastIdx)) >= 0) {
-    String macAddr = filterStr.substring(lastIdx, idx);
-    macAddr.trim();  // Remove any whitespace
-    if (macAddr.length() > 0) {
-      filteredDevices.insert(macAddr.c_str());
-      Serial.print("Added to filter: ");
-      Serial.println(macAddr);
-    }
-    lastIdx = idx + 1;
-  }
-  
-  // Add the last MAC address (or only one if no commas)
-  String macAddr = filterStr.substring(lastIdx);
-  macAddr.trim();
-  if (macAddr.length() > 0) {
-    filteredDevices.insert(macAddr.c_str());
-    Serial.print("Added to filter: ");
-    Serial.println(macAddr);
-  }
+  // Parse the default filter string
+  size_t added = filteredDevices.parseList(DEVICE_FILTER);
   
-  Serial.print("Device filter is active with ");
-  Serial.print(filteredDevices.size());
-  Serial.println(" device(s).");
-}
\ No newline at end of file
+  Serial.print("Device filter initialized with ");
+  Serial.print(added);
+  Serial.println(" default device(s).");
+}
@@ -6,6 +6,32 @@
 #include <NimBLEScan.h>
 #include <NimBLEAdvertisedDevice.h>
 #include "DeviceInfo.h"
+#include "SpscRing.h"
+#include "AdaptiveScan.h"
+#include "UniqueAddressCounter.h"
+
+// Mit STREAMING_SCAN 1 behält NimBLE keine Scan-Ergebnisse
+// (setMaxResults(0)): jedes Advertisement wird nur im Callback verarbeitet und
+// danach sofort freigegeben, der Heap bleibt während eines Fensters flach, egal
+// wie viele Geräte in der Nähe sind. Die Geräteanzahl pro Fenster zählt dann
+// windowAddresses. Mit 0 sammelt NimBLE wie früher alle Geräte des Fensters
+// bis clearResults().
+#ifndef STREAMING_SCAN
+#define STREAMING_SCAN 1
+#endif
+
+// Kopie der relevanten Daten eines Advertisements. Feste Größe, damit der
+// BLE-Callback sie ohne Heap in den Ring zur Verarbeitungsstufe legen kann.
+struct AdvertisementEvent {
+  MacAddress address;
+  int rssi;
+  unsigned long timestamp;
+  bool hasName;
+  char name[32];
+  bool hasManufacturerId;
+  uint16_t manufacturerId;
+  ServiceUuid serviceUuid;  // bits 0: keine Service-UUID
+};
 
 // Callback for BLE scan results
 class MyAdvertisedDeviceCallbacks: public NimBLEAdvertisedDeviceCallbacks {
@@ -16,15 +42,77 @@ class MyAdvertisedDeviceCallbacks: public NimBLEAdvertisedDeviceCallbacks {
 class BLEScanner {
 private:
   NimBLEScan* pBLEScan;
+  SpscRing<AdvertisementEvent, ADVERTISEMENT_QUEUE_LENGTH> eventRing;
+  bool continuousMode;
+  volatile bool scanWindowDone;
+  volatile int lastWindowCount;
+  unsigned long windowStart;
+  ScanParameters windowParameters;  // Vom laufenden Fenster benutzt (Funkzeit)
+#if STREAMING_SCAN
+  // Verschiedene Adressen im laufenden Fenster (256 Byte); nur aus onResult
+  // beschrieben, zurückgesetzt bzw. gelesen, während kein Scan läuft
+  UniqueAddressCounter<11> windowAddresses;
+#endif
+
+  static void onScanWindowComplete(NimBLEScanResults results);
+  void applySettings();
 
 public:
   BLEScanner();
   void init();
-  int scan();  // Returns the number of devices found
-  void clearResults();
+  int scan();  // Blocking scan, returns the number of devices found
+  void clearResults();  // Mit STREAMING_SCAN gibt es nichts freizugeben
+#if STREAMING_SCAN
+  // Aus onResult: Adresse für die Geräteanzahl des Fensters zählen
+  void countAddress(MacAddress address) { windowAddresses.add(address); }
+#endif
+  bool isContinuous() const { return continuousMode; }
+
+  // Dauerscan: startet ein nicht-blockierendes Scan-Fenster (SCAN_TIME lang)
+  void startContinuous();
+  // true, wenn ein Scan-Fenster beendet wurde; deviceCount erhält dessen Geräteanzahl
+  bool pollScanWindow(int& deviceCount);
+  // Beendet das laufende Fenster vorzeitig, z.B. um den Sparbetrieb zu verlassen
+  void stopScanWindow();
+
+  // Vom Callback aufgerufen: im Dauerscan in den Ring, sonst direkt verarbeiten
+  void handleAdvertisement(const AdvertisementEvent& event);
+  // Verarbeitet alle wartenden Advertisements, gibt deren Anzahl zurück
+  // (nur aus der Verarbeitungsstufe aufrufen)
+  int processEvents();
+
+  // Ring-Statistik: angenommene und wegen vollem Ring verworfene Advertisements
+  uint32_t getQueuedEvents() const { return eventRing.pushed(); }
+  uint32_t getDroppedEvents() const { return eventRing.dropped(); }
+  uint32_t getMaxQueueFill() const { return eventRing.maxFill(); }
 };
 
+// Apply one advertisement to deviceTable (filter, distance, filters, tracking flags)
+void processAdvertisement(const AdvertisementEvent& event);
+
+// Mit FILTER_BANK: rechnet die gesammelten Messungen und führt gefilterte
+// Werte, Bereichsindex und nächsten Beacon nach (vor jedem Tracking-Durchlauf).
+// Ohne FILTER_BANK passiert das schon in processAdvertisement.
+void flushFilterBank();
+
+// Lässt die fälligen Fristen aus deviceTimers ablaufen: IN_RANGE_MAX_AGE_MS
+// nach dem letzten Advertisement fällt ein Gerät aus inRangeIndex,
+// DEVICE_IDLE_EVICT_MS danach wird es aus deviceTable gelöscht. Kostet
+// O(abgelaufene Fristen) statt eines Durchlaufs über alle Geräte. Gibt die
+// Zahl der abgelaufenen Fristen zurück (nur unter DeviceDataLock aufrufen).
+size_t expireDevices(uint32_t now);
+
+// Verwirft Name und Service-UUID aller Geräte außer denen aus filteredDevices
+// und dem verfolgten Beacon (isProtectedDevice, Speicherwächter). Gibt die Zahl der betroffenen Geräte zurück
+// (nur unter DeviceDataLock aufrufen).
+size_t dropUnlistedMetadata();
+
+// Kopiert Adresse, RSSI, Name, Hersteller-ID und Service-UUID aus dem
+// NimBLE-Objekt in ein AdvertisementEvent (Teil von onResult). Der Payload
+// wird dabei genau einmal durchlaufen (parseAdvertisingData), ohne Heap.
+void decodeAdvertisement(NimBLEAdvertisedDevice* advertisedDevice, AdvertisementEvent& event);
+
 // Global scanner instance
 extern BLEScanner bleScanner;
 
-#endif // BLESCANNER_H
\ No newline at end of file
+#endif // BLESCANNER_H
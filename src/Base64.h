@@ -0,0 +1,30 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Base64 mit Auffüllung ('='), für Binärdaten in Textzeilen (Mitschnitt,
+// Meshtastic-Uplink). out braucht base64Length(length) Zeichen, es wird
+// kein Nullterminator geschrieben.
+constexpr size_t base64Length(size_t length) {
+  return (length + 2) / 3 * 4;
+}
+
+inline size_t base64Encode(const uint8_t* data, size_t length, char* out) {
+  static const char BASE64_CHARS[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t pos = 0;
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t block = (uint32_t)data[i] << 16;
+    if (i + 1 < length) block |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < length) block |= data[i + 2];
+    out[pos++] = BASE64_CHARS[(block >> 18) & 0x3F];
+    out[pos++] = BASE64_CHARS[(block >> 12) & 0x3F];
+    out[pos++] = i + 1 < length ? BASE64_CHARS[(block >> 6) & 0x3F] : '=';
+    out[pos++] = i + 2 < length ? BASE64_CHARS[block & 0x3F] : '=';
+  }
+  return pos;
+}
+
+#endif // BASE64_H
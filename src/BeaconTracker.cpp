@@ -1,19 +1,22 @@
 #include "BeaconTracker.h"
 #include "Config.h"
 #include "DeviceInfo.h"
+#include "BLEScanner.h"
 #include "MeshtasticComm.h"
+#include "ConfigManager.h"
+#include "Log.h"
+#include "Stats.h"
 #include <Arduino.h>
 
 // Beacon Tracking Variablen
-static std::string currentClosestBeaconAddress = "";
+static MacAddress currentClosestBeaconAddress = NO_MAC_ADDRESS;
 static float currentClosestBeaconDistance = 999.0;
 static bool beaconStatusChanged = false;
 static unsigned long lastBeaconUpdate = 0;
 static bool beaconDisappearanceReported = false;  // Flag um zu tracken, ob das Verschwinden bereits gemeldet wurde
-static std::set<std::string> currentScanBeacons;  // Set für die im aktuellen Scan gefundenen Beacons
 
 // Getter und Setter Implementierungen
-const std::string& getCurrentClosestBeaconAddress() {
+MacAddress getCurrentClosestBeaconAddress() {
   return currentClosestBeaconAddress;
 }
 
@@ -29,11 +32,11 @@ bool getBeaconDisappearanceReported() {
   return beaconDisappearanceReported;
 }
 
-std::set<std::string>& getCurrentScanBeacons() {
-  return currentScanBeacons;
+bool isTrackingBeacon() {
+  return currentClosestBeaconAddress != NO_MAC_ADDRESS && !beaconDisappearanceReported;
 }
 
-void setCurrentClosestBeaconAddress(const std::string& address) {
+void setCurrentClosestBeaconAddress(MacAddress address) {
   currentClosestBeaconAddress = address;
 }
 
@@ -49,10 +52,6 @@ void setBeaconDisappearanceReported(bool reported) {
   beaconDisappearanceReported = reported;
 }
 
-void clearCurrentScanBeacons() {
-  currentScanBeacons.clear();
-}
-
 void updateLastBeaconSeen() {
   lastBeaconUpdate = millis();
 }
@@ -62,97 +61,95 @@ unsigned long getLastBeaconUpdate() {
 }
 
 void initBeaconTracking() {
-  currentClosestBeaconAddress = "";
+  currentClosestBeaconAddress = NO_MAC_ADDRESS;
   currentClosestBeaconDistance = 999.0;
   beaconStatusChanged = false;
   beaconDisappearanceReported = false;
-  currentScanBeacons.clear();
   lastBeaconUpdate = 0;
 }
 
+void updateInRangeIndex(MacAddress address, const DeviceInfo& device) {
+  // Nur Geräte aus dem Filter erreichen die Tabelle, daher zählt hier allein die Distanz
+  bool inRange = device.filteredDistance <= ConfigManager::getDistanceThreshold();
+  inRangeIndex.update(address, device.filteredDistance, inRange);
+}
+
+void rebuildInRangeIndex() {
+  inRangeIndex.clear();
+  uint32_t now = millis();
+  deviceTable.forEach([now](MacAddress address, DeviceInfo& device) {
+    // Geräte, deren Anwesenheitsfrist schon abgelaufen ist, bleiben draußen
+    if (isDeviceInFilter(address) && (uint32_t)(now - device.lastSeen) < IN_RANGE_MAX_AGE_MS) {
+      updateInRangeIndex(address, device);
+    }
+  });
+}
+
+// Count devices within threshold (using dynamic threshold)
+void countDevicesInRange() {
+  expireDevices(millis());
+  devicesInRangeCount = inRangeIndex.size();
+}
+
 // Find the closest beacon and handle tracking
 void findAndTrackClosestBeacon() {
-  std::string closestBeaconAddress = "";
+  unsigned long started = micros();
+  MacAddress closestBeaconAddress = NO_MAC_ADDRESS;
   float closestBeaconDistance = 999.0;
   DeviceInfo* closestBeacon = nullptr;
   
   // Debug-Ausgabe zum Beginn der Funktion
-  Serial.println("UART-DEBUG: Suche nach dem nächsten Beacon...");
-  Serial.println("UART-DEBUG: Aktuell verfolgter Beacon: " + String(currentClosestBeaconAddress.empty() ? "keiner" : currentClosestBeaconAddress.c_str()));
-  
-  // Lösche die Liste der aktuell sichtbaren Beacons
-  currentScanBeacons.clear();
+  LOG_DEBUG(LOG_TRACK, "Suche nach dem nächsten Beacon, aktuell verfolgt: %s",
+            currentClosestBeaconAddress == NO_MAC_ADDRESS ? "keiner" : macToString(currentClosestBeaconAddress).text);
   
-  // Find the closest beacon and handle tracking
-  for (auto& pair : deviceInfoMap) {
-    std::string address = pair.first;
-    DeviceInfo& device = pair.second;
-    
-    // Skip devices not in our filter (if filter is active)
-    if (!isDeviceInFilter(address)) {
-      continue;
-    }
-    
-    // Only consider devices within threshold and seen in the last 30 seconds
-    if (device.filteredDistance <= DISTANCE_THRESHOLD && 
-        (millis() - device.lastSeen) < 30000) {
-      
-      // Add to the set of currently visible beacons
-      currentScanBeacons.insert(address);
-      
-      // Check if this is the closest beacon
-      if (device.filteredDistance < closestBeaconDistance) {
-        closestBeaconDistance = device.filteredDistance;
-        closestBeaconAddress = address;
-        closestBeacon = &device;
-      }
-    }
+  // Sichtbar sind die Geräte im Index (innerhalb des Schwellenwerts, kürzlich
+  // gesehen); der nächste steht auf Rang 0
+  expireDevices(millis());
+  if (!inRangeIndex.empty()) {
+    closestBeaconAddress = inRangeIndex.addressAt(0);
+    closestBeaconDistance = inRangeIndex.distanceAt(0);
+    closestBeacon = deviceTable.find(closestBeaconAddress);
   }
   
   // Überprüfen, ob der aktuell verfolgte Beacon verschwunden ist
-  if (!currentClosestBeaconAddress.empty()) {
-    bool beaconIsVisible = currentScanBeacons.find(currentClosestBeaconAddress) != currentScanBeacons.end();
+  if (currentClosestBeaconAddress != NO_MAC_ADDRESS) {
+    bool beaconIsVisible = inRangeIndex.contains(currentClosestBeaconAddress);
     
-    Serial.print("UART-DEBUG: Verfolgter Beacon ");
-    Serial.print(currentClosestBeaconAddress.c_str());
-    Serial.print(beaconIsVisible ? " ist sichtbar" : " ist NICHT sichtbar");
-    Serial.print(", Verschwinden gemeldet: ");
-    Serial.println(beaconDisappearanceReported ? "Ja" : "Nein");
+    LOG_DEBUG(LOG_TRACK, "Verfolgter Beacon %s %s, Verschwinden gemeldet: %s",
+              macToString(currentClosestBeaconAddress).text, beaconIsVisible ? "ist sichtbar" : "ist NICHT sichtbar",
+              beaconDisappearanceReported ? "Ja" : "Nein");
     
     // Wenn der Beacon gerade verschwunden ist und wir es noch nicht gemeldet haben
     if (!beaconIsVisible && !beaconDisappearanceReported) {
-      Serial.println("UART-DEBUG: *** BEACON IST VERSCHWUNDEN! ***");
-      Serial.println("UART-DEBUG: Sende finale Benachrichtigung mit presence: false");
+      LOG_INFO(LOG_TRACK, "Beacon %s ist verschwunden, sende finale Benachrichtigung mit presence: false",
+               macToString(currentClosestBeaconAddress).text);
       
-      if (deviceInfoMap.find(currentClosestBeaconAddress) != deviceInfoMap.end()) {
-        DeviceInfo& currentBeacon = deviceInfoMap[currentClosestBeaconAddress];
-        
+      DeviceInfo* currentBeacon = deviceTable.find(currentClosestBeaconAddress);
+      if (currentBeacon != nullptr) {
         // Sende eine spezielle Nachricht mit presence=false
-        sendBeaconToMeshtastic(currentClosestBeaconAddress, currentBeacon, BEACON_TIMEOUT_SECONDS + 1);
+        sendBeaconToMeshtastic(currentClosestBeaconAddress, *currentBeacon, BEACON_TIMEOUT_SECONDS + 1);
         
         // Markiere, dass wir das Verschwinden bereits gemeldet haben
         beaconDisappearanceReported = true;
-        
-        Serial.println("UART-DEBUG: Verschwinden-Nachricht wurde gesendet");
       } else {
-        Serial.println("UART-DEBUG: FEHLER: Beacon-Info nicht gefunden!");
+        LOG_ERROR(LOG_TRACK, "Beacon-Info für %s nicht gefunden", macToString(currentClosestBeaconAddress).text);
       }
     }
     
     // Wenn der Beacon wieder auftaucht, nachdem wir sein Verschwinden gemeldet haben
     if (beaconIsVisible && beaconDisappearanceReported) {
-      Serial.println("UART-DEBUG: BEACON IST ZURÜCKGEKEHRT! Sende neue Nachricht mit presence: true");
+      LOG_INFO(LOG_TRACK, "Beacon %s ist zurückgekehrt, sende neue Nachricht mit presence: true",
+               macToString(currentClosestBeaconAddress).text);
       
       // Dies ist ein Status-Wechsel und muss gemeldet werden
       beaconStatusChanged = true;
       beaconDisappearanceReported = false;
       
       // Wenn es der aktuell verfolgte Beacon ist, sofort ein Update senden
-      if (deviceInfoMap.find(currentClosestBeaconAddress) != deviceInfoMap.end()) {
-        DeviceInfo& currentBeacon = deviceInfoMap[currentClosestBeaconAddress];
-        sendBeaconToMeshtastic(currentClosestBeaconAddress, currentBeacon);
+      DeviceInfo* currentBeacon = deviceTable.find(currentClosestBeaconAddress);
+      if (currentBeacon != nullptr) {
+        sendBeaconToMeshtastic(currentClosestBeaconAddress, *currentBeacon);
         beaconStatusChanged = false; // Reset nach dem Senden
-        Serial.println("UART-DEBUG: Rückkehr-Nachricht wurde gesendet");
       }
     }
   }
@@ -160,11 +157,9 @@ void findAndTrackClosestBeacon() {
   // Check if we found a closest beacon
   if (closestBeacon != nullptr) {
     // Wenn wir einen anderen Beacon verfolgen als den aktuell nächsten
-    if (!currentClosestBeaconAddress.empty() && currentClosestBeaconAddress != closestBeaconAddress) {
-      Serial.print("UART-DEBUG: Neuer nächster Beacon gefunden. Alt: ");
-      Serial.print(currentClosestBeaconAddress.c_str());
-      Serial.print(" -> Neu: ");
-      Serial.println(closestBeaconAddress.c_str());
+    if (currentClosestBeaconAddress != NO_MAC_ADDRESS && currentClosestBeaconAddress != closestBeaconAddress) {
+      LOG_INFO(LOG_TRACK, "Neuer nächster Beacon: %s -> %s (%.2f m)", macToString(currentClosestBeaconAddress).text,
+               macToString(closestBeaconAddress).text, closestBeaconDistance);
       
       // Now update to the new closest beacon
       beaconStatusChanged = true;
@@ -174,11 +169,11 @@ void findAndTrackClosestBeacon() {
       
       // Reset the disappearance flag when tracking a new beacon
       beaconDisappearanceReported = false;
-      Serial.println("UART-DEBUG: Verschwinden-Flag zurückgesetzt für neuen Beacon");
       
-    } else if (currentClosestBeaconAddress.empty()) {
+    } else if (currentClosestBeaconAddress == NO_MAC_ADDRESS) {
       // First time detecting a beacon
-      Serial.println("UART-DEBUG: Erster Beacon entdeckt!");
+      LOG_INFO(LOG_TRACK, "Erster Beacon entdeckt: %s (%.2f m)", macToString(closestBeaconAddress).text,
+               closestBeaconDistance);
       beaconStatusChanged = true;
       currentClosestBeaconAddress = closestBeaconAddress;
       currentClosestBeaconDistance = closestBeaconDistance;
@@ -197,40 +192,35 @@ void findAndTrackClosestBeacon() {
     // If a status change occurred or we need to send regular updates
     if (beaconStatusChanged) {
       // Send data for the new closest beacon
-      Serial.println("UART-DEBUG: Sende Daten für nächsten Beacon...");
+      LOG_DEBUG(LOG_TRACK, "Sende Daten für nächsten Beacon %s", macToString(closestBeaconAddress).text);
       sendBeaconToMeshtastic(closestBeaconAddress, *closestBeacon);
       beaconStatusChanged = false;
     }
   } else {
     // No beacons found within threshold
-    Serial.println("UART-DEBUG: Kein Beacon innerhalb des Schwellenwerts gefunden.");
+    LOG_DEBUG(LOG_TRACK, "Kein Beacon innerhalb des Schwellenwerts gefunden");
     
     // Wenn kein Beacon mehr sichtbar ist und wir einen verfolgt haben, aber noch keine Verschwinden-Meldung gesendet haben
-    if (!currentClosestBeaconAddress.empty() && currentScanBeacons.empty() && !beaconDisappearanceReported) {
-      Serial.println("UART-DEBUG: Alle Beacons sind verschwunden!");
+    if (currentClosestBeaconAddress != NO_MAC_ADDRESS && inRangeIndex.empty() && !beaconDisappearanceReported) {
+      LOG_INFO(LOG_TRACK, "Alle Beacons sind verschwunden");
       
       // Nur wenn wir die deviceInfo noch haben
-      if (deviceInfoMap.find(currentClosestBeaconAddress) != deviceInfoMap.end()) {
-        DeviceInfo& lastTrackedBeacon = deviceInfoMap[currentClosestBeaconAddress];
-        
+      DeviceInfo* lastTrackedBeacon = deviceTable.find(currentClosestBeaconAddress);
+      if (lastTrackedBeacon != nullptr) {
         // Verschwinden melden
-        Serial.println("UART-DEBUG: Sende finale Benachrichtigung für letzten Beacon mit presence: false");
-        sendBeaconToMeshtastic(currentClosestBeaconAddress, lastTrackedBeacon, BEACON_TIMEOUT_SECONDS + 1);
+        LOG_DEBUG(LOG_TRACK, "Sende finale Benachrichtigung für %s mit presence: false",
+                  macToString(currentClosestBeaconAddress).text);
+        sendBeaconToMeshtastic(currentClosestBeaconAddress, *lastTrackedBeacon, BEACON_TIMEOUT_SECONDS + 1);
         
         beaconDisappearanceReported = true;
-        Serial.println("UART-DEBUG: Verschwinden-Nachricht wurde gesendet");
       }
     }
   }
   
   // Debug-Ausgabe zum Ende der Funktion
-  Serial.print("UART-DEBUG: Aktuell sichtbare Beacons: ");
-  Serial.println(currentScanBeacons.size());
-  Serial.print("UART-DEBUG: Verfolgter Beacon: ");
-  Serial.println(currentClosestBeaconAddress.empty() ? "keiner" : currentClosestBeaconAddress.c_str());
-  Serial.print("UART-DEBUG: Status-Change-Flag: ");
-  Serial.println(beaconStatusChanged ? "Ja" : "Nein");
-  Serial.print("UART-DEBUG: Verschwinden bereits gemeldet: ");
-  Serial.println(beaconDisappearanceReported ? "Ja" : "Nein");
-  Serial.println("UART-DEBUG: Ende der Beacon-Tracking-Funktion");
+  LOG_DEBUG(LOG_TRACK, "Sichtbare Beacons: %u, verfolgt: %s, Status-Change: %s, Verschwinden gemeldet: %s",
+            (unsigned)inRangeIndex.size(),
+            currentClosestBeaconAddress == NO_MAC_ADDRESS ? "keiner" : macToString(currentClosestBeaconAddress).text,
+            beaconStatusChanged ? "Ja" : "Nein", beaconDisappearanceReported ? "Ja" : "Nein");
+  recordStat(STATS_TRACKING, micros() - started);
 }
\ No newline at end of file
@@ -2,23 +2,32 @@
 #define BEACONTRACKER_H
 
 #include <string>
-#include <set>
+#include "MacAddress.h"
+
+struct DeviceInfo;
 
 // Find and track closest beacon
 void findAndTrackClosestBeacon();
 
+// Update devicesInRangeCount (filtered devices within threshold)
+void countDevicesInRange();
+
+// Keep inRangeIndex in step with deviceTable: after each processed
+// advertisement, and completely after filter or threshold changes
+void updateInRangeIndex(MacAddress address, const DeviceInfo& device);
+void rebuildInRangeIndex();
+
 // Getter and setter functions for beacon tracking variables
-const std::string& getCurrentClosestBeaconAddress();
+MacAddress getCurrentClosestBeaconAddress();  // NO_MAC_ADDRESS if none
 float getCurrentClosestBeaconDistance();
 bool getBeaconStatusChanged();
 bool getBeaconDisappearanceReported();
-std::set<std::string>& getCurrentScanBeacons();
+bool isTrackingBeacon();  // Ein Beacon wird verfolgt und ist nicht als verschwunden gemeldet
 
-void setCurrentClosestBeaconAddress(const std::string& address);
+void setCurrentClosestBeaconAddress(MacAddress address);
 void setCurrentClosestBeaconDistance(float distance);
 void setBeaconStatusChanged(bool changed);
 void setBeaconDisappearanceReported(bool reported);
-void clearCurrentScanBeacons();
 
 // Update last seen time for current beacon
 void updateLastBeaconSeen();
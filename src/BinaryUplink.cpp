@@ -0,0 +1,69 @@
+#include "BinaryUplink.h"
+#include "Config.h"
+#include "Base64.h"
+#include <cmath>
+
+// Rundet auf ganze Einheiten und begrenzt auf den uint16-Bereich
+static uint16_t quantize(float value, float unitsPerOne) {
+  float scaled = roundf(value * unitsPerOne);
+  if (!(scaled > 0)) {
+    return 0;  // Auch NaN
+  }
+  if (scaled >= 65535.0f) {
+    return 65535;
+  }
+  return (uint16_t)scaled;
+}
+
+static void encodeEntry(uint8_t* out, const BeaconReport& report) {
+  uint16_t decimeters = quantize(report.distance, 10.0f);
+  uint16_t deciseconds = quantize(report.presence.lastSeen, 10.0f);
+  
+  out[0] = report.presence.present ? UPLINK_FLAG_PRESENT : 0;
+  out[1] = (report.address >> 16) & 0xFF;
+  out[2] = (report.address >> 8) & 0xFF;
+  out[3] = report.address & 0xFF;
+  out[4] = decimeters & 0xFF;
+  out[5] = decimeters >> 8;
+  out[6] = deciseconds & 0xFF;
+  out[7] = deciseconds >> 8;
+}
+
+size_t encodeBeaconFrame(uint8_t* out, const BeaconReport* reports, size_t count) {
+  if (count > UPLINK_MAX_ENTRIES) {
+    count = UPLINK_MAX_ENTRIES;
+  }
+  
+  size_t pos = 0;
+  if (count == 1) {
+    out[pos++] = UPLINK_FRAME_VERSION;
+  } else {
+    out[pos++] = UPLINK_BATCH_FRAME_VERSION;
+    out[pos++] = (uint8_t)count;
+  }
+  for (size_t i = 0; i < count; i++) {
+    encodeEntry(out + pos, reports[i]);
+    pos += UPLINK_ENTRY_SIZE;
+  }
+  
+  size_t idLength = GATEWAY_ID.length();
+  if (idLength > UPLINK_MAX_GATEWAY_ID) {
+    idLength = UPLINK_MAX_GATEWAY_ID;
+  }
+  memcpy(out + pos, GATEWAY_ID.c_str(), idLength);
+  return pos + idLength;
+}
+
+size_t generateBeaconFrameText(char* buffer, size_t size, const BeaconReport* reports, size_t count) {
+  uint8_t frame[UPLINK_MAX_FRAME_SIZE];
+  size_t frameLength = encodeBeaconFrame(frame, reports, count);
+  
+  char text[base64Length(UPLINK_MAX_FRAME_SIZE) + 1];
+  size_t textLength = base64Encode(frame, frameLength, text);
+  if (size > 0) {
+    size_t copied = textLength < size ? textLength : size - 1;
+    memcpy(buffer, text, copied);
+    buffer[copied] = '\0';
+  }
+  return textLength;
+}
@@ -0,0 +1,43 @@
+#ifndef BINARYUPLINK_H
+#define BINARYUPLINK_H
+
+#include <Arduino.h>
+#include "DeviceInfo.h"
+
+// Kompakte Beacon-Meldung für den Meshtastic-Uplink (UPLINK_BINARY).
+//
+// Ein Eintrag beschreibt einen Beacon (8 Byte, Zahlen little-endian):
+//   Flags    1  Bit 0 = anwesend ("crusher"), übrige Bits 0
+//   ID       3  die letzten drei Oktette der MAC in Textreihenfolge
+//               (aa:bb:cc:dd:ee:ff -> dd ee ff)
+//   Distanz  2  in Dezimetern (uint16, gerundet, 0..65535)
+//   Zeit     2  last_seen in Zehntelsekunden (uint16, gerundet, 0..65535)
+//
+// Rahmen Version 1 (eine Meldung):   <1> <Eintrag> <Gateway-ID>
+// Rahmen Version 2 (mehrere, siehe ReportBatch.h):
+//                                    <2> <Anzahl n> <n Einträge> <Gateway-ID>
+// Die Gateway-ID (ASCII) reicht jeweils bis zum Rahmenende.
+//
+// Meshtastic überträgt Textzeilen, deshalb wird der Rahmen als eine Base64-
+// Zeile gesendet: mit "BLE001" sind das 15 Byte bzw. 20 Zeichen statt rund
+// 65 Zeichen JSON. Eine JSON-Zeile beginnt immer mit '{' oder '[', beides
+// kommt in Base64 nicht vor. Referenz-Decoder: tools/uplink_decode.py
+
+static constexpr uint8_t UPLINK_FRAME_VERSION = 1;
+static constexpr uint8_t UPLINK_BATCH_FRAME_VERSION = 2;
+static constexpr size_t UPLINK_ENTRY_SIZE = 8;
+static constexpr size_t UPLINK_MAX_ENTRIES = 16;
+static constexpr size_t UPLINK_MAX_GATEWAY_ID = 24;
+static constexpr size_t UPLINK_MAX_FRAME_SIZE = 2 + UPLINK_MAX_ENTRIES * UPLINK_ENTRY_SIZE + UPLINK_MAX_GATEWAY_ID;
+
+static constexpr uint8_t UPLINK_FLAG_PRESENT = 0x01;
+
+// Schreibt den Rahmen für count Meldungen (1..UPLINK_MAX_ENTRIES) nach out
+// (mind. UPLINK_MAX_FRAME_SIZE Byte), gibt die Länge zurück. Längere
+// Gateway-IDs werden abgeschnitten.
+size_t encodeBeaconFrame(uint8_t* out, const BeaconReport* reports, size_t count);
+
+// Rahmen als Base64-Text nach buffer (nullterminiert), Rückgabe wie snprintf
+size_t generateBeaconFrameText(char* buffer, size_t size, const BeaconReport* reports, size_t count);
+
+#endif // BINARYUPLINK_H
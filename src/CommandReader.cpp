@@ -0,0 +1,109 @@
+#include "CommandReader.h"
+#include "SpscRing.h"
+#include "Log.h"
+#include "Pipeline.h"
+
+enum FramerState {
+  FRAME_IDLE,     // Zwischen zwei Zeilen, führende Leerzeichen werden übersprungen
+  FRAME_TEXT,     // Zeile wird gesammelt
+  FRAME_DISCARD   // Zeile zu lang, Rest bis '\n' wird verworfen
+};
+
+static HardwareSerial* commandSerial = nullptr;
+static SpscRing<CommandLine, COMMAND_QUEUE_LENGTH> commandQueue;
+
+// Zustand des Automaten (nur vom einzigen Erzeuger benutzt)
+static FramerState framerState = FRAME_IDLE;
+static CommandLine currentLine;
+
+static uint32_t overlongLines = 0;
+
+static bool isBlank(uint8_t c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static void finishLine() {
+  while (currentLine.length > 0 && isBlank(currentLine.text[currentLine.length - 1])) {
+    currentLine.length--;
+  }
+  currentLine.text[currentLine.length] = '\0';
+  if (!commandQueue.push(currentLine)) {
+    LOG_WARN(LOG_UART, "Befehlswarteschlange voll - Zeile verworfen");
+  }
+  notifyLoop();
+}
+
+static void feedByte(uint8_t c) {
+  switch (framerState) {
+    case FRAME_IDLE:
+      if (isBlank(c)) {
+        break;
+      }
+      currentLine.length = 0;
+      framerState = FRAME_TEXT;
+      // fall through
+    case FRAME_TEXT:
+      if (c == '\n') {
+        finishLine();
+        framerState = FRAME_IDLE;
+      } else if (c == '\r') {
+        // CRLF vom Meshtastic-Gerät, nur '\n' beendet die Zeile
+      } else if (currentLine.length >= COMMAND_LINE_LENGTH) {
+        overlongLines++;
+        framerState = FRAME_DISCARD;
+        LOG_WARN(LOG_UART, "Befehlszeile länger als %d Zeichen - verworfen", COMMAND_LINE_LENGTH);
+      } else {
+        currentLine.text[currentLine.length++] = (char)c;
+      }
+      break;
+    case FRAME_DISCARD:
+      if (c == '\n') {
+        framerState = FRAME_IDLE;
+      }
+      break;
+  }
+}
+
+// Leert den Empfangsring des Treibers in Blöcken, wartet nie auf weitere Bytes
+static void readAvailableBytes() {
+  uint8_t chunk[64];
+  int available;
+  while ((available = commandSerial->available()) > 0) {
+    size_t count = commandSerial->read(chunk, available < (int)sizeof(chunk) ? available : sizeof(chunk));
+    if (count == 0) {
+      break;
+    }
+    for (size_t i = 0; i < count; i++) {
+      feedByte(chunk[i]);
+    }
+  }
+}
+
+void initCommandReader(HardwareSerial& serial) {
+  commandSerial = &serial;
+  serial.setRxBufferSize(COMMAND_RX_BUFFER_SIZE);
+#if COMMAND_RX_EVENT
+  // Läuft im UART-Event-Task, sobald Bytes da sind oder die Leitung ruht
+  serial.onReceive([]() { readAvailableBytes(); });
+#endif
+}
+
+void pollCommandReader() {
+#if !COMMAND_RX_EVENT
+  if (commandSerial != nullptr) {
+    readAvailableBytes();
+  }
+#endif
+}
+
+bool takeCommandLine(CommandLine& line) {
+  return commandQueue.pop(line);
+}
+
+uint32_t getOverlongCommandLines() {
+  return overlongLines;
+}
+
+uint32_t getDroppedCommandLines() {
+  return commandQueue.dropped();
+}
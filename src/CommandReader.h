@@ -0,0 +1,45 @@
+#ifndef COMMANDREADER_H
+#define COMMANDREADER_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include "Config.h"
+
+// Liest Befehlszeilen vom Meshtastic-UART, ohne loop() je zu blockieren.
+//
+// Die Bytes landen zuerst im Empfangsring des UART-Treibers
+// (COMMAND_RX_BUFFER_SIZE). Von dort holt ein Zustandsautomat sie Byte für
+// Byte ab und setzt Zeilen zusammen; nur vollständige Zeilen kommen in die
+// Befehlswarteschlange. Eine halbe Zeile bleibt einfach im Automaten liegen,
+// bis der Rest eintrifft. '\r' wird ignoriert, Leerzeichen am Anfang und Ende
+// werden entfernt, leere Zeilen übersprungen. Eine Zeile mit mehr als
+// COMMAND_LINE_LENGTH Zeichen wird bis zum nächsten '\n' verworfen und
+// gezählt - der Puffer läuft nie über.
+//
+// Mit COMMAND_RX_EVENT 1 füllt der UART-Event-Task (onReceive) die
+// Warteschlange, mit 0 ruft loop() pollCommandReader() auf. In beiden Fällen
+// gibt es genau einen Erzeuger und einen Verbraucher (loop()).
+#ifndef COMMAND_RX_EVENT
+#define COMMAND_RX_EVENT 1
+#endif
+
+// Eine vollständige Befehlszeile, nullterminiert
+struct CommandLine {
+  uint16_t length;
+  char text[COMMAND_LINE_LENGTH + 1];
+};
+
+// Vor serial.begin() aufrufen (Größe des Empfangsrings wird dort festgelegt)
+void initCommandReader(HardwareSerial& serial);
+
+// Liest alle bereits empfangenen Bytes, ohne zu warten (nur ohne COMMAND_RX_EVENT)
+void pollCommandReader();
+
+// Holt die nächste vollständige Zeile aus der Warteschlange
+bool takeCommandLine(CommandLine& line);
+
+// Zähler seit dem Start
+uint32_t getOverlongCommandLines();  // Zu lange Zeilen, verworfen
+uint32_t getDroppedCommandLines();   // Warteschlange voll, verworfen
+
+#endif // COMMANDREADER_H
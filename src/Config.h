@@ -3,14 +3,23 @@
 
 #include <Arduino.h>
 #include <string>
-#include <set>
+#include "MacAddress.h"
+#include "MacAllowlist.h"
 
 //========================= KONFIGURIERBARE VARIABLEN =========================
 // BLE-Scan Parameter
 static constexpr int SCAN_TIME = 5;                // Scan-Dauer in Sekunden
-static constexpr int SCAN_INTERVAL = 100;          // Scan-Intervall (in 0.625ms Einheiten)
-static constexpr int SCAN_WINDOW = 99;             // Scan-Fenster (in 0.625ms Einheiten)
+static constexpr int SCAN_INTERVAL = 100;          // Scan-Intervall (Millisekunden, NimBLE rechnet in 0.625-ms-Einheiten um)
+static constexpr int SCAN_WINDOW = 99;             // Scan-Fenster (Millisekunden)
 static constexpr bool ACTIVE_SCAN = true;          // Aktiver Scan verbraucht mehr Strom, liefert aber mehr Daten
+static constexpr bool CONTINUOUS_SCAN = true;      // Dauerscan: Scan-Fenster laufen nahtlos hintereinander, loop() blockiert nicht
+static constexpr int ADVERTISEMENT_QUEUE_LENGTH = 64; // Ringpuffer für Advertisements zwischen BLE-Callback und Verarbeitung (Zweierpotenz)
+
+// Adaptiver Scan (siehe AdaptiveScan.h)
+static constexpr bool ADAPTIVE_SCAN = false;       // Ohne Beacon-Aktivität Tastverhältnis senken und passiv scannen; zur Laufzeit per {"adaptive_scan":true}
+static constexpr int SCAN_IDLE_DELAY = 30000;      // So lange ohne Beacon-Aktivität bis zum Sparbetrieb (Millisekunden)
+static constexpr int SCAN_IDLE_LATENCY = 1000;     // Sparbetrieb: Scan-Intervall = typische zusätzliche Erkennungszeit (Millisekunden, max. 10240)
+static constexpr int SCAN_IDLE_WINDOW = 110;       // Sparbetrieb: Empfangsfenster pro Intervall, länger als das Advertising-Intervall der Beacons (Millisekunden)
 
 // RSSI zu Meter Konvertierungsparameter
 static constexpr int TX_POWER = -59;               // Kalibrierte Sendeleistung bei 1 Meter (je nach Beacon anpassen)
@@ -19,14 +28,61 @@ static constexpr float DISTANCE_THRESHOLD = 1.0;   // Nur Geräte innerhalb dies
 static constexpr float DISTANCE_CORRECTION = -0.5;  // Korrekturwert zur Anpassung der berechneten Distanz (in Metern), je niedriger desto näher rückt der Beacon
 
 // Kalman-Filter Parameter
-static constexpr float PROCESS_NOISE = 0.01;       // Prozessrauschen - höhere Werte folgen Änderungen schneller
-static constexpr float MEASUREMENT_NOISE = 0.5;    // Messrauschen - höhere Werte glätten stärker
+enum DistanceTracker {
+  TRACKER_SCALAR = 0,   // KalmanFilter: nur die Entfernung, ein fester Schritt pro Messung
+  TRACKER_VELOCITY = 1  // VelocityKalmanFilter: Entfernung und Geschwindigkeit, rechnet mit dem Abstand der Messungen
+};
+static constexpr DistanceTracker DISTANCE_TRACKER = TRACKER_SCALAR; // Zur Laufzeit per {"tracker":"velocity"} bzw. "scalar"
+static constexpr float PROCESS_NOISE = 0.01;       // Prozessrauschen - höhere Werte folgen Änderungen schneller (scalar: m² pro Messung, velocity: m²/s³)
+static constexpr float MEASUREMENT_NOISE = 0.5;    // Messrauschen - höhere Werte glätten stärker (m²)
+static constexpr uint32_t TRACKER_MAX_GAP_MS = 5000; // velocity: nach einer längeren Pause startet der Filter bei der nächsten Messung neu
+static constexpr float TRACKER_SPEED_VARIANCE = 1.0; // velocity: Unsicherheit der Geschwindigkeit beim Start ((m/s)²)
 
 // Gleitender Mittelwert Parameter
 static constexpr int WINDOW_SIZE = 5;              // Anzahl der Werte für den gleitenden Mittelwert
+static constexpr int MAX_WINDOW_SIZE = 20;         // Obergrenze für window_size; so viele Werte liegen je Filter direkt im Geräteeintrag
+static constexpr int FILTER_BANK_SAMPLES = 8;      // Nur mit FILTER_BANK (siehe FilterBank.h): gesammelte Messungen pro Gerät und Tracking-Durchlauf, die nächste erzwingt eine Zwischenrechnung
 
 // Beacon Tracking Parameter
 static constexpr int BEACON_TIMEOUT_SECONDS = 10;  // Timeout in Sekunden für Beacon-Tracking
+static constexpr int TRACKING_INTERVAL = 200;      // Intervall für die Beacon-Auswertung im Dauerscan (Millisekunden)
+
+// Verarbeitungs-Pipeline (Dauerscan)
+static constexpr int PROCESSING_CORE = 1;          // Kern des Verarbeitungs-Tasks (NimBLE-Host läuft auf Kern 0)
+static constexpr int PROCESSING_TASK_PRIORITY = 2; // Über loop() (Priorität 1), damit der Ring zügig geleert wird
+static constexpr int PROCESSING_TASK_STACK = 8192; // Stackgröße des Verarbeitungs-Tasks in Byte
+static constexpr int OUTPUT_QUEUE_LENGTH = 16;     // Ringpuffer für UART-Meldungen an die Ausgabestufe (Zweierpotenz)
+static constexpr int LOOP_IDLE_WAIT = 10;          // Dauerscan: loop() schläft bis zu so lange, wenn nichts zu tun ist (Millisekunden)
+static constexpr int REPORT_BATCH_WINDOW = 1000;   // Mindestabstand zweier Beacon-Meldungen an Meshtastic, dazwischen wird gesammelt (ms, 0 = nach jedem Tracking-Durchlauf)
+static constexpr int REPORT_BATCH_CAPACITY = 8;    // Maximale Anzahl verschiedener Beacons in einer gesammelten Meldung
+
+// Protokollierung (Stufe und Kategorien per build_flags, siehe Log.h)
+static constexpr int LOG_QUEUE_LENGTH = 64;        // Ringpuffer für Protokollmeldungen (Zweierpotenz)
+static constexpr int LOG_MESSAGE_LENGTH = 120;     // Maximale Länge einer Meldung, länger wird abgeschnitten
+static constexpr int LOG_DRAIN_INTERVAL = 20;      // Protokoll-Task wacht spätestens so oft auf, bei halb vollem Ring sofort (Millisekunden)
+static constexpr int LOG_TASK_CORE = 1;            // Kern des Protokoll-Tasks
+static constexpr int LOG_TASK_PRIORITY = 1;        // Wie loop() und unter der Verarbeitung; schläft zwischen zwei Ausgaben, IDLE kommt also auch dran
+static constexpr int LOG_TASK_STACK = 3072;        // Stackgröße des Protokoll-Tasks in Byte
+
+// Advertisement-Mitschnitt auf der seriellen Konsole (siehe AdvertisementCapture.h)
+static constexpr bool CAPTURE_ADVERTISEMENTS = false; // Beim Start aktiv; zur Laufzeit per {"capture":true}
+static constexpr int CAPTURE_QUEUE_LENGTH = 64;       // Ringpuffer zwischen BLE-Callback und Ausgabe (Zweierpotenz)
+
+// Gerätetabelle
+static constexpr int DEVICE_TABLE_CAPACITY = 128;  // Maximale Anzahl gespeicherter Geräte, bei Überlauf wird das am längsten nicht gesehene verdrängt
+static constexpr int NAME_POOL_CAPACITY = 64;      // Verschiedene Gerätenamen gleichzeitig; weitere Namen ersetzt die Ausgabe durch "Unknown"
+static constexpr uint32_t IN_RANGE_MAX_AGE_MS = 30000; // Gerät zählt nur als in Reichweite, wenn es so kürzlich gesehen wurde
+static constexpr uint32_t DEVICE_IDLE_EVICT_MS = 300000; // So lange nicht gesehene Geräte werden aus der Tabelle gelöscht (5 Minuten)
+static constexpr int MAX_DEVICES = DEVICE_TABLE_CAPACITY; // Obergrenze gespeicherter Geräte, zur Laufzeit per {"max_devices":...} (höchstens DEVICE_TABLE_CAPACITY)
+
+// Speicherwächter (siehe MemoryGovernor.h)
+static constexpr int HEAP_BUDGET = 32768;          // Mindestens so viel freier Heap (Byte), sonst wird Last abgebaut; zur Laufzeit per {"heap_budget":...}, 0 = aus
+static constexpr uint32_t HEAP_MIN_BLOCK = 8192;   // Kleinerer größter freier Block gilt als zu stark fragmentiert (Byte)
+static constexpr int MEMORY_CHECK_INTERVAL = 1000; // Prüfintervall des Speicherwächters (Millisekunden)
+static constexpr int MIN_DEVICE_CAP = 16;          // Unter Speicherdruck sinkt die Geräteobergrenze höchstens bis hierhin
+
+// Konfigurationsspeicher (NVS)
+static constexpr int CONFIG_SAVE_DELAY = 10000;    // Änderungen erst speichern, wenn so lange kein Befehl mehr kam (Millisekunden)
 
 // Gateway Identification
 static const String GATEWAY_ID = "BLE001";         // Unique identifier for this gateway - change for multiple gateways
@@ -36,6 +92,7 @@ static const String GATEWAY_ID = "BLE001";         // Unique identifier for this
 // WHOOP e0:80:8f:1e:13:28, NGIS 004 08:05:04:03:02:01, BLE MPU Test e4:b0:63:41:7d:5a
 static const String DEVICE_FILTER = "08:05:04:03:02:01,0d:03:0a:02:0e:01,e4:b0:63:41:7d:5a";  // Hier die gewünschten MAC-Adressen eintragen um mit Komma ohne Leerschritt trennen
 static constexpr bool USE_DEVICE_FILTER = true;  // Auf true setzen, um Filter zu aktivieren
+static constexpr int MAC_FILTER_CAPACITY = 4096;   // Maximale Anzahl MAC-Adressen im Filter (6 Byte pro Adresse)
 
 // JSON-Ausgabe Parameter
 static constexpr int JSON_OUTPUT_INTERVAL = 2000;  // Intervall für JSON-Ausgabe in Millisekunden
@@ -44,15 +101,30 @@ static constexpr int JSON_OUTPUT_INTERVAL = 2000;  // Intervall für JSON-Ausgab
 static constexpr int UART_TX_PIN = 43;             // GPIO-Pin für UART TX
 static constexpr int UART_RX_PIN = 44;             // GPIO-Pin für UART RX
 static constexpr int UART_BAUD_RATE = 115200;      // Baudrate für UART
+static constexpr int COMMAND_RX_BUFFER_SIZE = 512; // Empfangsring des UART-Treibers in Byte (mehr als eine Zeile)
+static constexpr int COMMAND_LINE_LENGTH = 240;    // Maximale Länge einer Befehlszeile ohne Zeilenende, länger wird verworfen
+static constexpr int COMMAND_QUEUE_LENGTH = 4;     // Vollständige Befehlszeilen, die auf loop() warten (Zweierpotenz)
+
+// Format der Beacon-Meldungen an Meshtastic (siehe BinaryUplink.h)
+enum UplinkFormat {
+  UPLINK_JSON = 0,    // {"name":...,"distance":...,"last_seen":...,"crusher":...}
+  UPLINK_BINARY = 1   // Kompakter Binärrahmen als Base64-Zeile
+};
+static constexpr UplinkFormat UPLINK_FORMAT = UPLINK_JSON; // Zur Laufzeit per {"uplink":"binary"} bzw. "json"
 //=============================================================================
 
 // Globale Variablen, die in mehreren Dateien verwendet werden
-extern std::set<std::string> filteredDevices;
+extern MacAllowlist filteredDevices;  // Einzige Kopie der MAC-Filterliste, von ConfigManager gepflegt
 extern int devicesInRangeCount;
 
 // Prototyp für die Funktion, die in mehreren Dateien verwendet wird
-float rssiToMeters(int rssi);
-bool isDeviceInFilter(const std::string& address);
+float rssiToMeters(int rssi);          // Aus der Tabelle, siehe rebuildDistanceTable()
+void rebuildDistanceTable();           // Nach Änderung von TX-Power, Umgebungsfaktor, Korrektur oder Schwellenwert
+void applyWindowSize(int windowSize);  // Neue Fenstergröße der gleitenden Mittelwerte für alle Geräte, ohne Neuallokation
+void applyDistanceTracker(DistanceTracker tracker, float processNoise, float measurementNoise); // Filtermodell und Rauschen für alle Geräte
+bool isRssiWithinThreshold(int rssi);  // Rohdistanz innerhalb des Schwellenwerts (ein Vergleich)
+int getRssiCutoff();
+bool isDeviceInFilter(MacAddress address);
 void parseDeviceFilter();
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "ConfigManager.h"
 #include "Config.h"
 #include "BLEScanner.h"
+#include "AdvertisementCapture.h"
+#include "BeaconTracker.h"
+#include "Pipeline.h"
+#include "Stats.h"
 #include <Preferences.h>
 #include <ArduinoJson.h>
 
@@ -9,36 +13,125 @@ int ConfigManager::runtime_SCAN_TIME = SCAN_TIME;
 int ConfigManager::runtime_SCAN_INTERVAL = SCAN_INTERVAL;
 int ConfigManager::runtime_SCAN_WINDOW = SCAN_WINDOW;
 bool ConfigManager::runtime_ACTIVE_SCAN = ACTIVE_SCAN;
+bool ConfigManager::runtime_ADAPTIVE_SCAN = ADAPTIVE_SCAN;
+int ConfigManager::runtime_SCAN_IDLE_DELAY = SCAN_IDLE_DELAY;
+int ConfigManager::runtime_SCAN_IDLE_LATENCY = SCAN_IDLE_LATENCY;
 int ConfigManager::runtime_TX_POWER = TX_POWER;
 float ConfigManager::runtime_ENVIRONMENTAL_FACTOR = ENVIRONMENTAL_FACTOR;
 float ConfigManager::runtime_DISTANCE_THRESHOLD = DISTANCE_THRESHOLD;
 float ConfigManager::runtime_DISTANCE_CORRECTION = DISTANCE_CORRECTION;
 float ConfigManager::runtime_PROCESS_NOISE = PROCESS_NOISE;
 float ConfigManager::runtime_MEASUREMENT_NOISE = MEASUREMENT_NOISE;
+DistanceTracker ConfigManager::runtime_DISTANCE_TRACKER = DISTANCE_TRACKER;
 int ConfigManager::runtime_WINDOW_SIZE = WINDOW_SIZE;
 int ConfigManager::runtime_BEACON_TIMEOUT_SECONDS = BEACON_TIMEOUT_SECONDS;
-std::set<std::string> ConfigManager::runtime_mac_addresses;
 bool ConfigManager::runtime_USE_DEVICE_FILTER = USE_DEVICE_FILTER;
-String ConfigManager::runtime_DEVICE_FILTER = DEVICE_FILTER;
+UplinkFormat ConfigManager::runtime_UPLINK_FORMAT = UPLINK_FORMAT;
+int ConfigManager::runtime_BATCH_WINDOW = REPORT_BATCH_WINDOW;
+int ConfigManager::runtime_MAX_DEVICES = MAX_DEVICES;
+int ConfigManager::runtime_HEAP_BUDGET = HEAP_BUDGET;
+
+// Anzahl Adressen, bis zu der printCurrentConfig die Liste ausschreibt
+static constexpr size_t MAX_PRINTED_MACS = 16;
+
+// Alle Einstellungen als ein NVS-Blob unter "config": Kopf + Datensatz.
+// Jedes Feld belegt 4 Byte, damit sich geänderte Felder wortweise finden
+// lassen. Neue Felder kommen nur ans Ende; ein älterer, kürzerer Datensatz
+// wird beim Laden mit den Voreinstellungen aufgefüllt. Nur wenn sich
+// Bedeutung oder Reihenfolge bestehender Felder ändert, steigt die Version
+// und loadRecord() braucht eine Migration. Version 0 sind die einzelnen
+// Schlüssel älterer Firmware (loadLegacyKeys).
+struct ConfigRecord {
+    int32_t scanTime;
+    int32_t scanInterval;
+    int32_t scanWindow;
+    int32_t activeScan;
+    int32_t txPower;
+    float environmentalFactor;
+    float distanceThreshold;
+    float distanceCorrection;
+    float processNoise;
+    float measurementNoise;
+    int32_t windowSize;
+    int32_t beaconTimeout;
+    int32_t useDeviceFilter;
+    int32_t uplinkFormat;
+    int32_t batchWindow;
+    int32_t adaptiveScan;
+    int32_t scanIdleDelay;
+    int32_t scanIdleLatency;
+    int32_t maxDevices;
+    int32_t heapBudget;
+    int32_t distanceTracker;
+};
+static_assert(sizeof(ConfigRecord) % 4 == 0 && sizeof(ConfigRecord) / 4 <= 32, "ConfigRecord: 4-byte fields, at most 32");
+
+struct ConfigRecordHeader {
+    uint16_t version;
+    uint16_t length;  // Länge des folgenden Datensatzes in Byte
+    uint32_t crc;     // CRC-32 über den Datensatz
+};
+
+static constexpr uint16_t CONFIG_RECORD_VERSION = 1;
+static constexpr size_t CONFIG_BLOB_MAX = 256;  // Platz für spätere Felder
+
+// Zustand der Persistenz (nur aus loop() benutzt)
+static ConfigRecord savedRecord;       // Stand im NVS
+static bool hasSavedRecord = false;    // savedRecord entspricht dem NVS
+static bool macListDirty = false;      // MAC-Liste seit dem letzten Speichern geändert
+static bool legacyKeysPresent = false; // Einzelne Schlüssel älterer Firmware noch im NVS
+static bool changesPending = false;
+static unsigned long lastChangeTime = 0;
+
+// Schlüssel der Version 0
+static const char* const LEGACY_KEYS[] = {
+    "scan_time", "scan_interval", "scan_window", "active_scan", "tx_power", "env_factor",
+    "dist_thresh", "dist_corr", "proc_noise", "meas_noise", "window_size", "beacon_timeout",
+    "use_filter", "uplink_format", "batch_window", "device_filter"
+};
+
+static uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Bitmaske der Felder, die sich vom gespeicherten Stand unterscheiden
+static uint32_t changedFields(const ConfigRecord& record) {
+    if (!hasSavedRecord) {
+        return (1u << (sizeof(ConfigRecord) / 4)) - 1;
+    }
+    const uint8_t* current = reinterpret_cast<const uint8_t*>(&record);
+    const uint8_t* saved = reinterpret_cast<const uint8_t*>(&savedRecord);
+    uint32_t mask = 0;
+    for (size_t field = 0; field < sizeof(ConfigRecord) / 4; field++) {
+        if (memcmp(current + field * 4, saved + field * 4, 4) != 0) {
+            mask |= 1u << field;
+        }
+    }
+    return mask;
+}
 
 void ConfigManager::init() {
     // Initialize MAC addresses from default filter
     parseDeviceFilter(); // This will populate filteredDevices from DEVICE_FILTER
-    
-    // Copy the parsed devices to our runtime set
-    runtime_mac_addresses.clear();
-    for (const auto& mac : filteredDevices) {
-        runtime_mac_addresses.insert(mac);
-    }
+    rebuildDistanceTable();
+    applyWindowSize(runtime_WINDOW_SIZE);
+    applyDistanceTracker(runtime_DISTANCE_TRACKER, runtime_PROCESS_NOISE, runtime_MEASUREMENT_NOISE);
     
     Serial.println("ConfigManager initialized with default values");
     Serial.printf("Gateway ID: %s\n", GATEWAY_ID.c_str());
     printCurrentConfig();
 }
 
-bool ConfigManager::processConfigCommand(const String& jsonString) {
+bool ConfigManager::processConfigCommand(const char* json, size_t length) {
     StaticJsonDocument<200> doc;
-    DeserializationError error = deserializeJson(doc, jsonString);
+    DeserializationError error = deserializeJson(doc, json, length);
     
     if (error) {
         Serial.print("JSON Parse Error: ");
@@ -60,6 +153,10 @@ bool ConfigManager::processConfigCommand(const String& jsonString) {
     }
     
     bool configChanged = false;
+    bool distanceChanged = false;  // RSSI-Tabelle neu berechnen
+    bool trackerChanged = false;   // Filtermodell oder Rauschen an die Geräte geben
+    bool statsSent = false;        // Nur beantwortet, nichts geändert
+    bool alreadySet = false;       // Gültig, aber schon so eingestellt; trotzdem bestätigen
     
     // Process BLE Scan Parameters
     if (doc.containsKey("scan_time")) {
@@ -86,29 +183,61 @@ bool ConfigManager::processConfigCommand(const String& jsonString) {
         configChanged = true;
     }
     
+    // Adaptiver Scan (siehe AdaptiveScan.h)
+    if (doc.containsKey("adaptive_scan")) {
+        runtime_ADAPTIVE_SCAN = doc["adaptive_scan"].as<bool>();
+        Serial.printf("Updated ADAPTIVE_SCAN to: %s\n", runtime_ADAPTIVE_SCAN ? "true" : "false");
+        configChanged = true;
+    }
+    
+    if (doc.containsKey("scan_idle_delay")) {
+        runtime_SCAN_IDLE_DELAY = doc["scan_idle_delay"].as<int>();
+        if (runtime_SCAN_IDLE_DELAY < 0) {
+            runtime_SCAN_IDLE_DELAY = 0;
+        }
+        Serial.printf("Updated SCAN_IDLE_DELAY to: %d ms\n", runtime_SCAN_IDLE_DELAY);
+        configChanged = true;
+    }
+    
+    if (doc.containsKey("scan_idle_latency")) {
+        // Grenzen des BLE-Scan-Intervalls (2.5 ms bis 10.24 s)
+        runtime_SCAN_IDLE_LATENCY = doc["scan_idle_latency"].as<int>();
+        if (runtime_SCAN_IDLE_LATENCY < 3) {
+            runtime_SCAN_IDLE_LATENCY = 3;
+        } else if (runtime_SCAN_IDLE_LATENCY > 10240) {
+            runtime_SCAN_IDLE_LATENCY = 10240;
+        }
+        Serial.printf("Updated SCAN_IDLE_LATENCY to: %d ms\n", runtime_SCAN_IDLE_LATENCY);
+        configChanged = true;
+    }
+    
     // Process RSSI to Meter Parameters
     if (doc.containsKey("tx_power")) {
         runtime_TX_POWER = doc["tx_power"].as<int>();
         Serial.printf("Updated TX_POWER to: %d\n", runtime_TX_POWER);
         configChanged = true;
+        distanceChanged = true;
     }
     
     if (doc.containsKey("env_factor")) {
         runtime_ENVIRONMENTAL_FACTOR = doc["env_factor"].as<float>();
         Serial.printf("Updated ENVIRONMENTAL_FACTOR to: %.2f\n", runtime_ENVIRONMENTAL_FACTOR);
         configChanged = true;
+        distanceChanged = true;
     }
     
     if (doc.containsKey("distance_threshold")) {
         runtime_DISTANCE_THRESHOLD = doc["distance_threshold"].as<float>();
         Serial.printf("Updated DISTANCE_THRESHOLD to: %.2f\n", runtime_DISTANCE_THRESHOLD);
         configChanged = true;
+        distanceChanged = true;
     }
     
     if (doc.containsKey("distance_correction")) {
         runtime_DISTANCE_CORRECTION = doc["distance_correction"].as<float>();
         Serial.printf("Updated DISTANCE_CORRECTION to: %.2f\n", runtime_DISTANCE_CORRECTION);
         configChanged = true;
+        distanceChanged = true;
     }
     
     // Process Filter Parameters
@@ -116,16 +245,38 @@ bool ConfigManager::processConfigCommand(const String& jsonString) {
         runtime_PROCESS_NOISE = doc["process_noise"].as<float>();
         Serial.printf("Updated PROCESS_NOISE to: %.3f\n", runtime_PROCESS_NOISE);
         configChanged = true;
+        trackerChanged = true;
     }
     
     if (doc.containsKey("measurement_noise")) {
         runtime_MEASUREMENT_NOISE = doc["measurement_noise"].as<float>();
         Serial.printf("Updated MEASUREMENT_NOISE to: %.3f\n", runtime_MEASUREMENT_NOISE);
         configChanged = true;
+        trackerChanged = true;
+    }
+    
+    // Filtermodell: "scalar" (Voreinstellung) oder "velocity" (siehe VelocityKalmanFilter)
+    if (doc.containsKey("tracker")) {
+        String tracker = doc["tracker"].as<String>();
+        if (tracker == "velocity" || tracker == "scalar") {
+            runtime_DISTANCE_TRACKER = tracker == "velocity" ? TRACKER_VELOCITY : TRACKER_SCALAR;
+            Serial.printf("Updated DISTANCE_TRACKER to: %s\n", tracker.c_str());
+            configChanged = true;
+            trackerChanged = true;
+        } else {
+            Serial.printf("ERROR: Unknown tracker '%s' (scalar or velocity)\n", tracker.c_str());
+        }
     }
     
     if (doc.containsKey("window_size")) {
+        // Die Fenster liegen im Geräteeintrag, mehr als MAX_WINDOW_SIZE Werte passen nicht
         runtime_WINDOW_SIZE = doc["window_size"].as<int>();
+        if (runtime_WINDOW_SIZE < 1) {
+            runtime_WINDOW_SIZE = 1;
+        } else if (runtime_WINDOW_SIZE > MAX_WINDOW_SIZE) {
+            runtime_WINDOW_SIZE = MAX_WINDOW_SIZE;
+        }
+        applyWindowSize(runtime_WINDOW_SIZE);
         Serial.printf("Updated WINDOW_SIZE to: %d\n", runtime_WINDOW_SIZE);
         configChanged = true;
     }
@@ -139,29 +290,41 @@ bool ConfigManager::processConfigCommand(const String& jsonString) {
     
     // Process MAC Address Commands
     if (doc.containsKey("mac_add")) {
-        String mac = doc["mac_add"].as<String>();
-        mac.toLowerCase(); // Normalize to lowercase
-        runtime_mac_addresses.insert(mac.c_str());
-        rebuildDeviceFilterString();
-        Serial.printf("Added MAC address: %s\n", mac.c_str());
-        configChanged = true;
+        MacAddress mac;
+        if (!parseMacAddress(doc["mac_add"].as<const char*>(), mac)) {
+            Serial.println("ERROR: Invalid MAC address in mac_add");
+        } else if (filteredDevices.add(mac)) {
+            Serial.printf("Added MAC address: %s (%u total)\n", macToString(mac).text, (unsigned)filteredDevices.size());
+            configChanged = true;
+            macListDirty = true;
+        } else if (filteredDevices.contains(mac)) {
+            // mac_add ist idempotent: wiederholtes Hinzufügen wird bestätigt
+            Serial.printf("MAC address already in filter: %s\n", macToString(mac).text);
+            alreadySet = true;
+        } else {
+            Serial.printf("ERROR: MAC filter full (%u addresses)\n", (unsigned)filteredDevices.maxEntries());
+        }
     }
     
     if (doc.containsKey("mac_remove")) {
-        String mac = doc["mac_remove"].as<String>();
-        mac.toLowerCase(); // Normalize to lowercase
-        runtime_mac_addresses.erase(mac.c_str());
-        rebuildDeviceFilterString();
-        Serial.printf("Removed MAC address: %s\n", mac.c_str());
-        configChanged = true;
+        MacAddress mac;
+        if (!parseMacAddress(doc["mac_remove"].as<const char*>(), mac)) {
+            Serial.println("ERROR: Invalid MAC address in mac_remove");
+        } else if (filteredDevices.remove(mac)) {
+            Serial.printf("Removed MAC address: %s (%u total)\n", macToString(mac).text, (unsigned)filteredDevices.size());
+            configChanged = true;
+            macListDirty = true;
+        } else {
+            Serial.printf("MAC address not in filter: %s\n", macToString(mac).text);
+        }
     }
     
     if (doc.containsKey("mac_clear")) {
         if (doc["mac_clear"].as<bool>()) {
-            runtime_mac_addresses.clear();
-            rebuildDeviceFilterString();
+            filteredDevices.clear();
             Serial.println("Cleared all MAC addresses");
             configChanged = true;
+            macListDirty = true;
         }
     }
     
@@ -171,6 +334,73 @@ bool ConfigManager::processConfigCommand(const String& jsonString) {
         configChanged = true;
     }
     
+    // Uplink-Format: "json" (Voreinstellung) oder "binary" (siehe BinaryUplink.h)
+    if (doc.containsKey("uplink")) {
+        String format = doc["uplink"].as<String>();
+        if (format == "binary" || format == "json") {
+            runtime_UPLINK_FORMAT = format == "binary" ? UPLINK_BINARY : UPLINK_JSON;
+            Serial.printf("Updated UPLINK_FORMAT to: %s\n", format.c_str());
+            configChanged = true;
+        } else {
+            Serial.printf("ERROR: Unknown uplink format '%s' (json or binary)\n", format.c_str());
+        }
+    }
+    
+    if (doc.containsKey("batch_window")) {
+        runtime_BATCH_WINDOW = doc["batch_window"].as<int>();
+        if (runtime_BATCH_WINDOW < 0) {
+            runtime_BATCH_WINDOW = 0;
+        }
+        Serial.printf("Updated BATCH_WINDOW to: %d ms\n", runtime_BATCH_WINDOW);
+        configChanged = true;
+    }
+    
+    // Speicherwächter; eine neue Obergrenze greift bei dessen nächster Prüfung
+    if (doc.containsKey("max_devices")) {
+        runtime_MAX_DEVICES = doc["max_devices"].as<int>();
+        if (runtime_MAX_DEVICES < 1) {
+            runtime_MAX_DEVICES = 1;
+        } else if (runtime_MAX_DEVICES > DEVICE_TABLE_CAPACITY) {
+            runtime_MAX_DEVICES = DEVICE_TABLE_CAPACITY;
+        }
+        Serial.printf("Updated MAX_DEVICES to: %d\n", runtime_MAX_DEVICES);
+        configChanged = true;
+    }
+    
+    if (doc.containsKey("heap_budget")) {
+        runtime_HEAP_BUDGET = doc["heap_budget"].as<int>();
+        if (runtime_HEAP_BUDGET < 0) {
+            runtime_HEAP_BUDGET = 0;
+        }
+        Serial.printf("Updated HEAP_BUDGET to: %d bytes\n", runtime_HEAP_BUDGET);
+        configChanged = true;
+    }
+    
+    // Advertisement-Mitschnitt (wird nicht gespeichert)
+    if (doc.containsKey("capture")) {
+        setCaptureEnabled(doc["capture"].as<bool>());
+        configChanged = true;
+    }
+    
+    // Laufzeitstatistik an Meshtastic (ändert keine Einstellung)
+    if (doc.containsKey("stats") && doc["stats"].as<bool>()) {
+        // Über die Ausgabestufe wie die Beacon-Meldungen; der Befehl läuft
+        // unter DeviceDataLock wie die Verarbeitungsstufe, der Ring hat also
+        // weiterhin nur einen Schreiber zur Zeit
+        for (int part = 0; part < STATS_JSON_PARTS; part++) {
+            char line[sizeof(OutputLine::text)];
+            size_t length = generateStatsJSON(line, sizeof(line), part);
+            if (length >= sizeof(line)) {
+                Serial.printf("WARNING: stats line %d truncated (%u characters)\n", part, (unsigned)length);
+                continue;
+            }
+            Serial.println(line);
+            if (queueOutputLine(line, length)) {
+                statsSent = true;
+            }
+        }
+    }
+    
     // Process Gateway ID Changes
     if (doc.containsKey("gateway_id")) {
         String newGatewayId = doc["gateway_id"].as<String>();
@@ -180,35 +410,42 @@ bool ConfigManager::processConfigCommand(const String& jsonString) {
         configChanged = true;
     }
     
+    if (distanceChanged) {
+        rebuildDistanceTable();
+        Serial.printf("RSSI cutoff for new devices: %d dBm\n", getRssiCutoff());
+    }
+    
+    if (trackerChanged) {
+        applyDistanceTracker(runtime_DISTANCE_TRACKER, runtime_PROCESS_NOISE, runtime_MEASUREMENT_NOISE);
+    }
+    
     // Update BLE scanner settings if scan parameters changed
     if (configChanged) {
         updateBLEScannerSettings();
-        // Save to persistent storage
+        // Filter oder Schwellenwert können sich geändert haben
+        rebuildInRangeIndex();
+        // Gespeichert wird erst, wenn eine Weile Ruhe ist (runPersistence)
+        markChanged();
+    }
+    
+    // Sofort speichern, z.B. am Ende einer Einstellsitzung
+    if (doc.containsKey("commit") && doc["commit"].as<bool>()) {
         saveToNVS();
+        configChanged = true;
     }
     
-    return configChanged;
+    return configChanged || statsSent || alreadySet;
 }
 
-void ConfigManager::rebuildDeviceFilterString() {
-    runtime_DEVICE_FILTER = "";
-    bool first = true;
-    
-    for (const auto& mac : runtime_mac_addresses) {
-        if (!first) {
-            runtime_DEVICE_FILTER += ",";
+String ConfigManager::getDeviceFilter() {
+    String list;
+    for (size_t i = 0; i < filteredDevices.size(); i++) {
+        if (i > 0) {
+            list += ",";
         }
-        runtime_DEVICE_FILTER += mac.c_str();
-        first = false;
-    }
-    
-    // Update the global filteredDevices set used by the BLE scanner
-    filteredDevices.clear();
-    for (const auto& mac : runtime_mac_addresses) {
-        filteredDevices.insert(mac);
+        list += macToString(filteredDevices.at(i)).text;
     }
-    
-    Serial.printf("Updated DEVICE_FILTER to: %s\n", runtime_DEVICE_FILTER.c_str());
+    return list;
 }
 
 void ConfigManager::updateBLEScannerSettings() {
@@ -224,21 +461,154 @@ void ConfigManager::printCurrentConfig() {
     Serial.printf("SCAN_INTERVAL: %d\n", runtime_SCAN_INTERVAL);
     Serial.printf("SCAN_WINDOW: %d\n", runtime_SCAN_WINDOW);
     Serial.printf("ACTIVE_SCAN: %s\n", runtime_ACTIVE_SCAN ? "true" : "false");
+    Serial.printf("ADAPTIVE_SCAN: %s (idle after %d ms, idle latency %d ms)\n", runtime_ADAPTIVE_SCAN ? "true" : "false",
+                  runtime_SCAN_IDLE_DELAY, runtime_SCAN_IDLE_LATENCY);
     Serial.printf("TX_POWER: %d\n", runtime_TX_POWER);
     Serial.printf("ENVIRONMENTAL_FACTOR: %.2f\n", runtime_ENVIRONMENTAL_FACTOR);
     Serial.printf("DISTANCE_THRESHOLD: %.2f\n", runtime_DISTANCE_THRESHOLD);
     Serial.printf("DISTANCE_CORRECTION: %.2f\n", runtime_DISTANCE_CORRECTION);
+    Serial.printf("RSSI_CUTOFF: %d dBm\n", getRssiCutoff());
     Serial.printf("PROCESS_NOISE: %.3f\n", runtime_PROCESS_NOISE);
     Serial.printf("MEASUREMENT_NOISE: %.3f\n", runtime_MEASUREMENT_NOISE);
+    Serial.printf("DISTANCE_TRACKER: %s\n", runtime_DISTANCE_TRACKER == TRACKER_VELOCITY ? "velocity" : "scalar");
     Serial.printf("WINDOW_SIZE: %d\n", runtime_WINDOW_SIZE);
     Serial.printf("BEACON_TIMEOUT_SECONDS: %d\n", runtime_BEACON_TIMEOUT_SECONDS);
     Serial.printf("USE_DEVICE_FILTER: %s\n", runtime_USE_DEVICE_FILTER ? "true" : "false");
-    Serial.printf("DEVICE_FILTER: %s\n", runtime_DEVICE_FILTER.c_str());
-    Serial.printf("MAC addresses count: %d\n", runtime_mac_addresses.size());
+    Serial.printf("UPLINK_FORMAT: %s\n", runtime_UPLINK_FORMAT == UPLINK_BINARY ? "binary" : "json");
+    Serial.printf("BATCH_WINDOW: %d ms\n", runtime_BATCH_WINDOW);
+    Serial.printf("MAX_DEVICES: %d (table capacity %d)\n", runtime_MAX_DEVICES, DEVICE_TABLE_CAPACITY);
+    Serial.printf("HEAP_BUDGET: %d bytes%s\n", runtime_HEAP_BUDGET, runtime_HEAP_BUDGET == 0 ? " (off)" : "");
+    Serial.print("DEVICE_FILTER: ");
+    filteredDevices.printTo(Serial, MAX_PRINTED_MACS);
+    Serial.println();
+    Serial.printf("MAC addresses count: %u\n", (unsigned)filteredDevices.size());
     Serial.println("===============================\n");
 }
 
+void ConfigManager::fillRecord(ConfigRecord& record) {
+    memset(&record, 0, sizeof(record));
+    record.scanTime = runtime_SCAN_TIME;
+    record.scanInterval = runtime_SCAN_INTERVAL;
+    record.scanWindow = runtime_SCAN_WINDOW;
+    record.activeScan = runtime_ACTIVE_SCAN;
+    record.txPower = runtime_TX_POWER;
+    record.environmentalFactor = runtime_ENVIRONMENTAL_FACTOR;
+    record.distanceThreshold = runtime_DISTANCE_THRESHOLD;
+    record.distanceCorrection = runtime_DISTANCE_CORRECTION;
+    record.processNoise = runtime_PROCESS_NOISE;
+    record.measurementNoise = runtime_MEASUREMENT_NOISE;
+    record.windowSize = runtime_WINDOW_SIZE;
+    record.beaconTimeout = runtime_BEACON_TIMEOUT_SECONDS;
+    record.useDeviceFilter = runtime_USE_DEVICE_FILTER;
+    record.uplinkFormat = runtime_UPLINK_FORMAT;
+    record.batchWindow = runtime_BATCH_WINDOW;
+    record.adaptiveScan = runtime_ADAPTIVE_SCAN;
+    record.scanIdleDelay = runtime_SCAN_IDLE_DELAY;
+    record.scanIdleLatency = runtime_SCAN_IDLE_LATENCY;
+    record.maxDevices = runtime_MAX_DEVICES;
+    record.heapBudget = runtime_HEAP_BUDGET;
+    record.distanceTracker = runtime_DISTANCE_TRACKER;
+}
+
+void ConfigManager::applyRecord(const ConfigRecord& record) {
+    runtime_SCAN_TIME = record.scanTime;
+    runtime_SCAN_INTERVAL = record.scanInterval;
+    runtime_SCAN_WINDOW = record.scanWindow;
+    runtime_ACTIVE_SCAN = record.activeScan != 0;
+    runtime_TX_POWER = record.txPower;
+    runtime_ENVIRONMENTAL_FACTOR = record.environmentalFactor;
+    runtime_DISTANCE_THRESHOLD = record.distanceThreshold;
+    runtime_DISTANCE_CORRECTION = record.distanceCorrection;
+    runtime_PROCESS_NOISE = record.processNoise;
+    runtime_MEASUREMENT_NOISE = record.measurementNoise;
+    runtime_WINDOW_SIZE = record.windowSize;
+    runtime_BEACON_TIMEOUT_SECONDS = record.beaconTimeout;
+    runtime_USE_DEVICE_FILTER = record.useDeviceFilter != 0;
+    runtime_UPLINK_FORMAT = record.uplinkFormat == UPLINK_BINARY ? UPLINK_BINARY : UPLINK_JSON;
+    runtime_BATCH_WINDOW = record.batchWindow;
+    runtime_ADAPTIVE_SCAN = record.adaptiveScan != 0;
+    runtime_SCAN_IDLE_DELAY = record.scanIdleDelay;
+    runtime_SCAN_IDLE_LATENCY = record.scanIdleLatency;
+    // Mit anderer DEVICE_TABLE_CAPACITY gespeichert: auf die Tabelle begrenzen
+    runtime_MAX_DEVICES = record.maxDevices < 1 ? 1 :
+                          (record.maxDevices > DEVICE_TABLE_CAPACITY ? DEVICE_TABLE_CAPACITY : record.maxDevices);
+    runtime_HEAP_BUDGET = record.heapBudget < 0 ? 0 : record.heapBudget;
+    runtime_DISTANCE_TRACKER = record.distanceTracker == TRACKER_VELOCITY ? TRACKER_VELOCITY : TRACKER_SCALAR;
+}
+
+bool ConfigManager::loadRecord(Preferences& prefs) {
+    uint8_t blob[CONFIG_BLOB_MAX];
+    size_t length = prefs.getBytesLength("config");
+    if (length < sizeof(ConfigRecordHeader) || length > sizeof(blob) ||
+        prefs.getBytes("config", blob, length) != length) {
+        return false;
+    }
+    
+    ConfigRecordHeader header;
+    memcpy(&header, blob, sizeof(header));
+    const uint8_t* data = blob + sizeof(header);
+    if (header.version != CONFIG_RECORD_VERSION || header.length != length - sizeof(header) ||
+        crc32(data, header.length) != header.crc) {
+        return false;
+    }
+    
+    // Felder, die der gespeicherte Datensatz noch nicht kennt, behalten ihre Voreinstellung
+    ConfigRecord record;
+    fillRecord(record);
+    memcpy(&record, data, header.length < sizeof(record) ? header.length : sizeof(record));
+    applyRecord(record);
+    
+    // Kürzerer Datensatz: beim nächsten Speichern in voller Länge schreiben
+    savedRecord = record;
+    hasSavedRecord = header.length == sizeof(record);
+    return true;
+}
+
+void ConfigManager::loadLegacyKeys(Preferences& prefs) {
+    runtime_SCAN_TIME = prefs.getInt("scan_time", SCAN_TIME);
+    runtime_SCAN_INTERVAL = prefs.getInt("scan_interval", SCAN_INTERVAL);
+    runtime_SCAN_WINDOW = prefs.getInt("scan_window", SCAN_WINDOW);
+    runtime_ACTIVE_SCAN = prefs.getBool("active_scan", ACTIVE_SCAN);
+    runtime_TX_POWER = prefs.getInt("tx_power", TX_POWER);
+    runtime_ENVIRONMENTAL_FACTOR = prefs.getFloat("env_factor", ENVIRONMENTAL_FACTOR);
+    runtime_DISTANCE_THRESHOLD = prefs.getFloat("dist_thresh", DISTANCE_THRESHOLD);
+    runtime_DISTANCE_CORRECTION = prefs.getFloat("dist_corr", DISTANCE_CORRECTION);
+    runtime_PROCESS_NOISE = prefs.getFloat("proc_noise", PROCESS_NOISE);
+    runtime_MEASUREMENT_NOISE = prefs.getFloat("meas_noise", MEASUREMENT_NOISE);
+    runtime_WINDOW_SIZE = prefs.getInt("window_size", WINDOW_SIZE);
+    runtime_BEACON_TIMEOUT_SECONDS = prefs.getInt("beacon_timeout", BEACON_TIMEOUT_SECONDS);
+    runtime_USE_DEVICE_FILTER = prefs.getBool("use_filter", USE_DEVICE_FILTER);
+    runtime_UPLINK_FORMAT = prefs.getUChar("uplink_format", UPLINK_FORMAT) == UPLINK_BINARY ? UPLINK_BINARY : UPLINK_JSON;
+    runtime_BATCH_WINDOW = prefs.getInt("batch_window", REPORT_BATCH_WINDOW);
+}
+
+void ConfigManager::markChanged() {
+    changesPending = true;
+    lastChangeTime = millis();
+}
+
+bool ConfigManager::hasUnsavedChanges() {
+    return changesPending;
+}
+
+void ConfigManager::runPersistence(unsigned long now) {
+    if (changesPending && now - lastChangeTime >= (unsigned long)CONFIG_SAVE_DELAY) {
+        saveToNVS();
+    }
+}
+
 void ConfigManager::saveToNVS() {
+    changesPending = false;
+    
+    // Nur schreiben, was sich gegenüber dem NVS geändert hat
+    ConfigRecord record;
+    fillRecord(record);
+    uint32_t fields = changedFields(record);
+    bool writeList = macListDirty || !hasSavedRecord;
+    if (fields == 0 && !writeList && !legacyKeysPresent) {
+        return;
+    }
+    
     Preferences prefs;
     
     if (!prefs.begin("ble_config", false)) {
@@ -246,23 +616,44 @@ void ConfigManager::saveToNVS() {
         return;
     }
     
-    prefs.putInt("scan_time", runtime_SCAN_TIME);
-    prefs.putInt("scan_interval", runtime_SCAN_INTERVAL);
-    prefs.putInt("scan_window", runtime_SCAN_WINDOW);
-    prefs.putBool("active_scan", runtime_ACTIVE_SCAN);
-    prefs.putInt("tx_power", runtime_TX_POWER);
-    prefs.putFloat("env_factor", runtime_ENVIRONMENTAL_FACTOR);
-    prefs.putFloat("dist_thresh", runtime_DISTANCE_THRESHOLD);
-    prefs.putFloat("dist_corr", runtime_DISTANCE_CORRECTION);
-    prefs.putFloat("proc_noise", runtime_PROCESS_NOISE);
-    prefs.putFloat("meas_noise", runtime_MEASUREMENT_NOISE);
-    prefs.putInt("window_size", runtime_WINDOW_SIZE);
-    prefs.putInt("beacon_timeout", runtime_BEACON_TIMEOUT_SECONDS);
-    prefs.putBool("use_filter", runtime_USE_DEVICE_FILTER);
-    prefs.putString("device_filter", runtime_DEVICE_FILTER);
+    bool ok = true;
+    if (fields != 0) {
+        uint8_t blob[sizeof(ConfigRecordHeader) + sizeof(ConfigRecord)];
+        ConfigRecordHeader header;
+        header.version = CONFIG_RECORD_VERSION;
+        header.length = sizeof(record);
+        header.crc = crc32(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
+        memcpy(blob, &header, sizeof(header));
+        memcpy(blob + sizeof(header), &record, sizeof(record));
+        ok = prefs.putBytes("config", blob, sizeof(blob)) == sizeof(blob);
+    }
+    
+    // MAC-Liste als ein Binär-Blob (6 Byte pro Adresse)
+    if (ok && writeList) {
+        ok = filteredDevices.saveTo(prefs, "mac_list");
+    }
+    
+    if (ok && legacyKeysPresent) {
+        for (const char* key : LEGACY_KEYS) {
+            if (prefs.isKey(key)) {
+                prefs.remove(key);
+            }
+        }
+        legacyKeysPresent = false;
+    }
     
     prefs.end();
-    Serial.println("Configuration saved to NVS");
+    
+    if (!ok) {
+        Serial.println("Failed to write configuration to NVS - will retry");
+        markChanged();
+        return;
+    }
+    savedRecord = record;
+    hasSavedRecord = true;
+    macListDirty = false;
+    Serial.printf("Configuration saved to NVS (%d setting(s)%s)\n", __builtin_popcount(fields),
+                  writeList ? ", MAC list" : "");
 }
 
 void ConfigManager::loadFromNVS() {
@@ -278,29 +669,53 @@ void ConfigManager::loadFromNVS() {
     
     Serial.println("Loading saved configuration from NVS...");
     
-    runtime_SCAN_TIME = prefs.getInt("scan_time", SCAN_TIME);
-    runtime_SCAN_INTERVAL = prefs.getInt("scan_interval", SCAN_INTERVAL);
-    runtime_SCAN_WINDOW = prefs.getInt("scan_window", SCAN_WINDOW);
-    runtime_ACTIVE_SCAN = prefs.getBool("active_scan", ACTIVE_SCAN);
-    runtime_TX_POWER = prefs.getInt("tx_power", TX_POWER);
-    runtime_ENVIRONMENTAL_FACTOR = prefs.getFloat("env_factor", ENVIRONMENTAL_FACTOR);
-    runtime_DISTANCE_THRESHOLD = prefs.getFloat("dist_thresh", DISTANCE_THRESHOLD);
-    runtime_DISTANCE_CORRECTION = prefs.getFloat("dist_corr", DISTANCE_CORRECTION);
-    runtime_PROCESS_NOISE = prefs.getFloat("proc_noise", PROCESS_NOISE);
-    runtime_MEASUREMENT_NOISE = prefs.getFloat("meas_noise", MEASUREMENT_NOISE);
-    runtime_WINDOW_SIZE = prefs.getInt("window_size", WINDOW_SIZE);
-    runtime_BEACON_TIMEOUT_SECONDS = prefs.getInt("beacon_timeout", BEACON_TIMEOUT_SECONDS);
-    runtime_USE_DEVICE_FILTER = prefs.getBool("use_filter", USE_DEVICE_FILTER);
-    runtime_DEVICE_FILTER = prefs.getString("device_filter", DEVICE_FILTER);
+    bool hasConfig = false;
+    if (prefs.isKey("config")) {
+        hasConfig = loadRecord(prefs);
+        if (!hasConfig) {
+            Serial.println("Stored configuration record is corrupt or unknown - using defaults");
+        }
+    } else if (prefs.isKey("scan_time")) {
+        // Ältere Firmware speicherte jede Einstellung unter einem eigenen Schlüssel
+        loadLegacyKeys(prefs);
+        legacyKeysPresent = true;
+        hasConfig = true;
+    }
+    
+    if (prefs.isKey("mac_list")) {
+        if (!filteredDevices.loadFrom(prefs, "mac_list")) {
+            Serial.println("Stored MAC list is corrupt - keeping default filter");
+            macListDirty = true;
+        }
+    } else if (prefs.isKey("device_filter")) {
+        // Ältere Firmware speicherte die Liste als komma-getrennten Text
+        filteredDevices.clear();
+        filteredDevices.parseList(prefs.getString("device_filter", DEVICE_FILTER));
+        Serial.println("Migrated text device_filter to binary MAC list");
+        macListDirty = true;
+        legacyKeysPresent = true;
+    } else if (hasConfig) {
+        // Gespeicherte Konfiguration ohne Liste: die Liste wurde geleert
+        filteredDevices.clear();
+    }
     
     prefs.end();
     
-    // Parse the loaded device filter
-    parseDeviceFilter();
-    runtime_mac_addresses.clear();
-    for (const auto& mac : filteredDevices) {
-        runtime_mac_addresses.insert(mac);
+    // Ältere Firmware hat window_size nicht begrenzt
+    if (runtime_WINDOW_SIZE < 1 || runtime_WINDOW_SIZE > MAX_WINDOW_SIZE) {
+        runtime_WINDOW_SIZE = WINDOW_SIZE;
     }
     
+    // Kalibrierung, Fenstergröße und Filtermodell aus dem NVS können von Config.h abweichen
+    rebuildDistanceTable();
+    applyWindowSize(runtime_WINDOW_SIZE);
+    applyDistanceTracker(runtime_DISTANCE_TRACKER, runtime_PROCESS_NOISE, runtime_MEASUREMENT_NOISE);
+    
     Serial.println("Configuration successfully loaded from NVS");
-}
\ No newline at end of file
+    
+    // Alte Schlüssel einmalig in den Datensatz übernehmen
+    if (legacyKeysPresent) {
+        Serial.println("Migrating configuration keys to a single record");
+        saveToNVS();
+    }
+}
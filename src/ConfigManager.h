@@ -3,8 +3,10 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <set>
-#include <string>
+#include "Config.h"
+
+class Preferences;
+struct ConfigRecord;  // Gespeichertes Abbild der Einstellungen (ConfigManager.cpp)
 
 // ConfigManager class to handle dynamic configuration updates
 class ConfigManager {
@@ -14,53 +16,81 @@ private:
     static int runtime_SCAN_INTERVAL;
     static int runtime_SCAN_WINDOW;
     static bool runtime_ACTIVE_SCAN;
+    static bool runtime_ADAPTIVE_SCAN;
+    static int runtime_SCAN_IDLE_DELAY;
+    static int runtime_SCAN_IDLE_LATENCY;
     static int runtime_TX_POWER;
     static float runtime_ENVIRONMENTAL_FACTOR;
     static float runtime_DISTANCE_THRESHOLD;
     static float runtime_DISTANCE_CORRECTION;
     static float runtime_PROCESS_NOISE;
     static float runtime_MEASUREMENT_NOISE;
+    static DistanceTracker runtime_DISTANCE_TRACKER;
     static int runtime_WINDOW_SIZE;
     static int runtime_BEACON_TIMEOUT_SECONDS;
     
-    // MAC address management
-    static std::set<std::string> runtime_mac_addresses;
+    // MAC address management (the address list itself is filteredDevices)
     static bool runtime_USE_DEVICE_FILTER;
-    static String runtime_DEVICE_FILTER;
+    
+    // Format der Beacon-Meldungen an Meshtastic und Sendefenster
+    static UplinkFormat runtime_UPLINK_FORMAT;
+    static int runtime_BATCH_WINDOW;
+    
+    // Speicherwächter
+    static int runtime_MAX_DEVICES;
+    static int runtime_HEAP_BUDGET;
     
     // Helper functions
-    static void rebuildDeviceFilterString();
     static void updateBLEScannerSettings();
     
+    // Persistenz: ein Datensatz für alle Einstellungen, MAC-Liste getrennt
+    static void fillRecord(ConfigRecord& record);
+    static void applyRecord(const ConfigRecord& record);
+    static bool loadRecord(Preferences& prefs);
+    static void loadLegacyKeys(Preferences& prefs);
+    static void markChanged();
+    
 public:
     // Initialize with default values from Config.h
     static void init();
     
     // Parse and process single JSON configuration command
-    static bool processConfigCommand(const String& jsonString);
+    static bool processConfigCommand(const char* json, size_t length);
     
     // Getters for runtime values (to replace Config.h constants)
     static int getScanTime() { return runtime_SCAN_TIME; }
     static int getScanInterval() { return runtime_SCAN_INTERVAL; }
     static int getScanWindow() { return runtime_SCAN_WINDOW; }
     static bool getActiveScan() { return runtime_ACTIVE_SCAN; }
+    static bool getAdaptiveScan() { return runtime_ADAPTIVE_SCAN; }
+    static int getScanIdleDelay() { return runtime_SCAN_IDLE_DELAY; }
+    static int getScanIdleLatency() { return runtime_SCAN_IDLE_LATENCY; }
     static int getTxPower() { return runtime_TX_POWER; }
     static float getEnvironmentalFactor() { return runtime_ENVIRONMENTAL_FACTOR; }
     static float getDistanceThreshold() { return runtime_DISTANCE_THRESHOLD; }
     static float getDistanceCorrection() { return runtime_DISTANCE_CORRECTION; }
     static float getProcessNoise() { return runtime_PROCESS_NOISE; }
     static float getMeasurementNoise() { return runtime_MEASUREMENT_NOISE; }
+    static DistanceTracker getDistanceTracker() { return runtime_DISTANCE_TRACKER; }
     static int getWindowSize() { return runtime_WINDOW_SIZE; }
     static int getBeaconTimeout() { return runtime_BEACON_TIMEOUT_SECONDS; }
     static bool getUseDeviceFilter() { return runtime_USE_DEVICE_FILTER; }
-    static const String& getDeviceFilter() { return runtime_DEVICE_FILTER; }
+    static String getDeviceFilter();  // Comma-separated, built on demand
+    static UplinkFormat getUplinkFormat() { return runtime_UPLINK_FORMAT; }
+    static int getBatchWindow() { return runtime_BATCH_WINDOW; }
+    static int getMaxDevices() { return runtime_MAX_DEVICES; }
+    static int getHeapBudget() { return runtime_HEAP_BUDGET; }
     
     // Print current configuration
     static void printCurrentConfig();
     
     // Save/Load configuration (optional - for persistent storage)
+    // Befehle ändern nur den RAM; geschrieben wird erst, wenn CONFIG_SAVE_DELAY
+    // lang kein weiterer Befehl kam (runPersistence) oder per {"commit":true}
     static void saveToNVS();
     static void loadFromNVS();
+    static void runPersistence(unsigned long now);
+    static bool hasUnsavedChanges();
 };
 
 #endif // CONFIGMANAGER_H
\ No newline at end of file
@@ -1,11 +1,58 @@
 #include "DeviceInfo.h"
+#include "Config.h"
+#include "BeaconTracker.h"
 #include <Arduino.h>
 
-// Global device map initialization
-std::map<std::string, DeviceInfo> deviceInfoMap;
+bool isProtectedDevice(MacAddress address) {
+  return filteredDevices.contains(address) || address == getCurrentClosestBeaconAddress();
+}
+
+// Global device table initialization (all slots are allocated here)
+DeviceTable deviceTable(DEVICE_TABLE_CAPACITY, isProtectedDevice);
+InRangeIndex inRangeIndex(DEVICE_TABLE_CAPACITY);
+TimerWheel deviceTimers(DEVICE_TABLE_CAPACITY);
+NamePool namePool(NAME_POOL_CAPACITY);
+#if FILTER_BANK
+FilterBank filterBank;
+#endif
+
+BeaconPresence getBeaconPresence(const DeviceInfo& device, float lastSeenOverride) {
+  BeaconPresence presence;
+  presence.forcedAbsent = false;
+  
+  if (lastSeenOverride >= 0) {
+    presence.lastSeen = lastSeenOverride;
+    // Wenn lastSeenOverride > BEACON_TIMEOUT_SECONDS, setzen wir crusher auf false
+    if (lastSeenOverride > BEACON_TIMEOUT_SECONDS) {
+      presence.forcedAbsent = true;
+    }
+  } else {
+    presence.lastSeen = (millis() - device.lastSeen) / 1000.0;
+  }
+  
+  // Anwesend, solange last_seen unter dem Timeout liegt, außer es ist erzwungen
+  presence.present = presence.forcedAbsent ? false : (presence.lastSeen < BEACON_TIMEOUT_SECONDS);
+  return presence;
+}
+
+BeaconReport makeBeaconReport(MacAddress address, const DeviceInfo& device, float lastSeenOverride) {
+  BeaconReport report;
+  report.address = address;
+  report.distance = device.filteredDistance;
+  report.presence = getBeaconPresence(device, lastSeenOverride);
+  report.seenAt = device.lastSeen;
+  strncpy(report.name, getDeviceName(device), sizeof(report.name) - 1);
+  report.name[sizeof(report.name) - 1] = '\0';
+  return report;
+}
+
+const char* getDeviceName(const DeviceInfo& device) {
+  const char* name = namePool.get(device.nameId);
+  return name != nullptr ? name : "Unknown";
+}
 
 // Get manufacturer name from ID
-String getManufacturerName(uint16_t manufacturerId) {
+const char* getManufacturerName(uint16_t manufacturerId) {
   switch (manufacturerId) {
     case 0x004C: return "Apple";
     case 0x0059: return "Nordic";
@@ -18,21 +65,55 @@ String getManufacturerName(uint16_t manufacturerId) {
   }
 }
 
+// 16-Bit-Kurzform einer UUID; 128-Bit-UUIDs nur, wenn sie auf der
+// Bluetooth-Basis-UUID 0000xxxx-0000-1000-8000-00805f9b34fb beruhen
+static bool shortServiceUuid(const ServiceUuid& uuid, uint16_t& shortUuid) {
+  static const uint8_t BASE_UUID[12] = {
+    0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00
+  };
+  if (uuid.bits == 16) {
+    shortUuid = uuid.value[0] | (uuid.value[1] << 8);
+    return true;
+  }
+  if (uuid.bits == 128 && memcmp(uuid.value, BASE_UUID, sizeof(BASE_UUID)) == 0 &&
+      uuid.value[14] == 0 && uuid.value[15] == 0) {
+    shortUuid = uuid.value[12] | (uuid.value[13] << 8);
+    return true;
+  }
+  return false;
+}
+
 // Get service name from UUID
-String getServiceName(std::string uuidStr) {
-  if (uuidStr.find("1800") != std::string::npos) {
-    return "Generic Access Profile";
-  } else if (uuidStr.find("1801") != std::string::npos) {
-    return "Generic Attribute Profile";
-  } else if (uuidStr.find("180F") != std::string::npos) {
-    return "Battery Service";
-  } else if (uuidStr.find("180A") != std::string::npos) {
-    return "Device Information Service";
-  } else if (uuidStr.find("FEAA") != std::string::npos) {
-    return "Eddystone Beacon";
-  } else if (uuidStr.find("FD6F") != std::string::npos) {
-    return "Exposure Notification Service";
-  } else {
+const char* getServiceName(const ServiceUuid& uuid) {
+  uint16_t shortUuid;
+  if (!shortServiceUuid(uuid, shortUuid)) {
     return "Unknown Service";
   }
+  switch (shortUuid) {
+    case 0x1800: return "Generic Access Profile";
+    case 0x1801: return "Generic Attribute Profile";
+    case 0x180F: return "Battery Service";
+    case 0x180A: return "Device Information Service";
+    case 0xFEAA: return "Eddystone Beacon";
+    case 0xFD6F: return "Exposure Notification Service";
+    default: return "Unknown Service";
+  }
+}
+
+size_t formatServiceUuid(const ServiceUuid& uuid, char* buffer, size_t size) {
+  const uint8_t* u = uuid.value;
+  int length;
+  if (uuid.bits == 16) {
+    length = snprintf(buffer, size, "0x%04x", u[0] | (u[1] << 8));
+  } else if (uuid.bits == 32) {
+    length = snprintf(buffer, size, "0x%08lx",
+                      (unsigned long)(u[0] | (u[1] << 8) | (u[2] << 16) | ((uint32_t)u[3] << 24)));
+  } else if (uuid.bits == 128) {
+    length = snprintf(buffer, size, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+                      u[15], u[14], u[13], u[12], u[11], u[10], u[9], u[8],
+                      u[7], u[6], u[5], u[4], u[3], u[2], u[1], u[0]);
+  } else {
+    length = snprintf(buffer, size, "%s", "");
+  }
+  return length > 0 ? (size_t)length : 0;
 }
\ No newline at end of file
@@ -1,9 +1,20 @@
 #ifndef DEVICEINFO_H
 #define DEVICEINFO_H
 
-#include <string>
-#include <map>
+#include <cstddef>
 #include "Filters.h"
+#include "FilterBank.h"
+#include "MacHashTable.h"
+#include "InRangeIndex.h"
+#include "NamePool.h"
+#include "TimerWheel.h"
+
+// Service-UUID in Binärform, Bytes in Little Endian wie im Advertisement.
+// bits ist 16, 32 oder 128; 0 heißt: keine UUID empfangen.
+struct ServiceUuid {
+  uint8_t bits;
+  uint8_t value[16];
+};
 
 // Device information structure
 struct DeviceInfo {
@@ -12,14 +23,21 @@ struct DeviceInfo {
   float filteredDistance;
   float avgRssi;
   float avgDistance;
-  std::string name;
-  std::string manufacturerId;
-  std::string manufacturerName;
-  std::string serviceUUID;
   unsigned long lastSeen;
-  KalmanFilter kalmanFilter;
+  // Metadaten nur als Zahlen; Text entsteht erst bei der Ausgabe
+  uint16_t nameId;          // Eintrag in namePool, NamePool::NO_NAME: kein Name bekannt
+  uint16_t manufacturerId;  // Company ID aus den Herstellerdaten, gültig mit hasManufacturerId
+  bool hasManufacturerId;
+  ServiceUuid serviceUuid;
+  uint16_t timerId;  // Timer in deviceTimers, gehört nur dann zu diesem Gerät, wenn deviceTimers.owns() zustimmt
+#if FILTER_BANK
+  uint16_t filterSlot;  // Platz in filterBank, gehört nur dann zu diesem Gerät, wenn filterBank.owns() zustimmt
+#else
+  KalmanFilter kalmanFilter;            // Nur mit TRACKER_SCALAR aktualisiert
+  VelocityKalmanFilter velocityFilter;  // Nur mit TRACKER_VELOCITY aktualisiert
   MovingAverageFilter rssiFilter;
   MovingAverageFilter distanceFilter;
+#endif
   
   DeviceInfo() : 
     rssi(0), 
@@ -28,16 +46,71 @@ struct DeviceInfo {
     avgRssi(0), 
     avgDistance(0), 
     lastSeen(0),
+    nameId(NamePool::NO_NAME),
+    manufacturerId(0),
+    hasManufacturerId(false),
+    serviceUuid(),
+    timerId(TimerWheel::NO_TIMER),
+#if FILTER_BANK
+    filterSlot(FilterBank::NO_SLOT) {}
+#else
     kalmanFilter(0),
+    velocityFilter(),
     rssiFilter(),
     distanceFilter() {}
+#endif
 };
 
-// Map to store devices and their information
-extern std::map<std::string, DeviceInfo> deviceInfoMap;
+// Table to store devices and their information, keyed by packed MAC address
+typedef MacHashTable<DeviceInfo> DeviceTable;
+extern DeviceTable deviceTable;
+
+// Geräte aus filteredDevices und der verfolgte Beacon: werden erst verdrängt,
+// wenn kein anderes Gerät mehr übrig ist, sonst fehlt der Eintrag für die
+// Meldung presence:false, sobald der Beacon verstummt
+bool isProtectedDevice(MacAddress address);
+
+// Gerätenamen aller Geräte in deviceTable (DeviceInfo::nameId)
+extern NamePool namePool;
+
+#if FILTER_BANK
+// Filterzustand aller Geräte in deviceTable
+extern FilterBank filterBank;
+#endif
+
+// Filtered devices within the distance threshold, nearest first (see BeaconTracker)
+extern InRangeIndex inRangeIndex;
+
+// Anwesenheits- und Löschfristen aller Geräte in deviceTable (siehe expireDevices)
+extern TimerWheel deviceTimers;
+
+// last_seen und Anwesenheit eines Beacons, wie sie an Meshtastic gemeldet werden.
+// lastSeenOverride >= 0 ersetzt die gemessene Zeit; liegt er über
+// BEACON_TIMEOUT_SECONDS, wird der Beacon als verschwunden gemeldet.
+struct BeaconPresence {
+  float lastSeen;     // Sekunden
+  bool present;
+  bool forcedAbsent;  // Durch lastSeenOverride erzwungen
+};
+BeaconPresence getBeaconPresence(const DeviceInfo& device, float lastSeenOverride);
+
+// Momentaufnahme eines Beacons für eine Meldung an Meshtastic; bleibt gültig,
+// auch wenn der Eintrag in deviceTable inzwischen verdrängt wurde
+struct BeaconReport {
+  MacAddress address;
+  float distance;
+  BeaconPresence presence;
+  unsigned long seenAt;  // millis() des letzten Advertisements
+  char name[32];  // BLE-Namen passen in ein Advertisement, also höchstens 29 Zeichen
+};
+BeaconReport makeBeaconReport(MacAddress address, const DeviceInfo& device, float lastSeenOverride);
 
-// Helper functions for device info
-String getManufacturerName(uint16_t manufacturerId);
-String getServiceName(std::string uuidStr);
+// Helper functions for device info (text only at output time)
+const char* getDeviceName(const DeviceInfo& device);  // "Unknown", wenn kein Name bekannt ist
+const char* getManufacturerName(uint16_t manufacturerId);
+const char* getServiceName(const ServiceUuid& uuid);
+// Schreibt die UUID wie NimBLEUUID::toString ("0x180f" bzw. 128 Bit mit
+// Bindestrichen, "" ohne UUID); gibt die Textlänge zurück
+size_t formatServiceUuid(const ServiceUuid& uuid, char* buffer, size_t size);
 
 #endif // DEVICEINFO_H
\ No newline at end of file
@@ -0,0 +1,260 @@
+// Die Schleifen in runRound vektorisiert GCC erst ab -O3; Arduino baut mit -Os
+#pragma GCC optimize("O3")
+
+#include "FilterBank.h"
+#include <cstring>
+
+// active ? a : b, bitgenau und ohne Sprung. Mit dem ?:-Operator verschiebt GCC
+// die Berechnung von a in einen Zweig und vektorisiert die Schleife nicht mehr.
+static inline float selectIf(bool active, float a, float b) {
+  uint32_t bitsA, bitsB;
+  memcpy(&bitsA, &a, sizeof(bitsA));
+  memcpy(&bitsB, &b, sizeof(bitsB));
+  uint32_t mask = 0u - (uint32_t)active;
+  uint32_t bits = (bitsA & mask) | (bitsB & ~mask);
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+static inline uint32_t selectIf(bool active, uint32_t a, uint32_t b) {
+  uint32_t mask = 0u - (uint32_t)active;
+  return (a & mask) | (b & ~mask);
+}
+
+FilterBank::FilterBank()
+  : windowSize_(WINDOW_SIZE), tracker_(DISTANCE_TRACKER), processNoise_(PROCESS_NOISE),
+    measurementNoise_(MEASUREMENT_NOISE), touchedCount_(0), touchedLow_(0), touchedHigh_(0), maxPending_(0), freeCount_(0) {
+  // Niedrige Plätze zuerst vergeben, damit der gerechnete Bereich dicht bleibt
+  for (size_t slot = CAPACITY; slot > 0; slot--) {
+    owners_[slot - 1] = NO_MAC_ADDRESS;
+    pending_[slot - 1] = 0;
+    windowCount_[slot - 1] = 0;
+    freeSlots_[freeCount_++] = (uint16_t)(slot - 1);
+  }
+}
+
+uint16_t FilterBank::acquire(MacAddress address) {
+  if (freeCount_ == 0) {
+    return NO_SLOT;
+  }
+  uint16_t slot = freeSlots_[--freeCount_];
+  owners_[slot] = address;
+
+  // Gleicher Anfangszustand wie KalmanFilter(0) und MovingAverageFilter();
+  // mit TRACKER_VELOCITY beginnt die erste Messung neu (seeded_)
+  kalmanX_[slot] = 0;
+  kalmanP_[slot] = 1.0;
+  velocity_[slot] = 0;
+  kalmanP01_[slot] = 0;
+  kalmanP11_[slot] = TRACKER_SPEED_VARIANCE;
+  lastTime_[slot] = 0;
+  seeded_[slot] = 0;
+  for (int w = 0; w < MAX_WINDOW_SIZE; w++) {
+    rssiWindow_[w][slot] = 0;
+    distanceWindow_[w][slot] = 0;
+  }
+  rssiSum_[slot] = 0;
+  distanceSum_[slot] = 0;
+  windowCount_[slot] = 0;
+  pending_[slot] = 0;
+  return slot;
+}
+
+void FilterBank::release(uint16_t slot) {
+  if (slot >= CAPACITY || owners_[slot] == NO_MAC_ADDRESS) {
+    return;
+  }
+  owners_[slot] = NO_MAC_ADDRESS;
+  pending_[slot] = 0;
+  freeSlots_[freeCount_++] = slot;
+}
+
+void FilterBank::setWindowSize(int size) {
+  size = size < 1 ? 1 : (size > MAX_WINDOW_SIZE ? MAX_WINDOW_SIZE : size);
+  windowSize_ = size;
+  for (size_t slot = 0; slot < CAPACITY; slot++) {
+    int32_t keep = windowCount_[slot] < size ? windowCount_[slot] : size;
+    for (int w = keep; w < MAX_WINDOW_SIZE; w++) {
+      rssiWindow_[w][slot] = 0;
+      distanceWindow_[w][slot] = 0;
+    }
+    // Summen vom ältesten zum neuesten Wert, wie RingFilter::setWindowSize
+    float rssiSum = 0;
+    float distanceSum = 0;
+    for (int w = keep - 1; w >= 0; w--) {
+      rssiSum += rssiWindow_[w][slot];
+      distanceSum += distanceWindow_[w][slot];
+    }
+    rssiSum_[slot] = rssiSum;
+    distanceSum_[slot] = distanceSum;
+    windowCount_[slot] = keep;
+  }
+}
+
+void FilterBank::setDistanceTracker(DistanceTracker tracker, float processNoise, float measurementNoise) {
+  processNoise_ = processNoise;
+  measurementNoise_ = measurementNoise;
+  if (tracker == tracker_) {
+    return;
+  }
+  tracker_ = tracker;
+  if (tracker != TRACKER_VELOCITY) {
+    // KalmanFilter rechnet mit kalmanX_ und kalmanP_ (P00) weiter
+    return;
+  }
+  // Wie VelocityKalmanFilter::seed bei der bisherigen Schätzung
+  for (size_t slot = 0; slot < CAPACITY; slot++) {
+    velocity_[slot] = 0;
+    kalmanP_[slot] = measurementNoise;
+    kalmanP01_[slot] = 0;
+    kalmanP11_[slot] = TRACKER_SPEED_VARIANCE;
+  }
+}
+
+bool FilterBank::stage(uint16_t slot, float rssi, float distance, uint32_t timestamp) {
+  int count = pending_[slot];
+  if (count >= FILTER_BANK_SAMPLES) {
+    return false;
+  }
+  stagedRssi_[count][slot] = rssi;
+  stagedDistance_[count][slot] = distance;
+  stagedTime_[count][slot] = timestamp;
+  pending_[slot] = count + 1;
+
+  if (count == 0) {
+    if (touchedCount_ == 0) {
+      touchedLow_ = slot;
+      touchedHigh_ = slot + 1;
+    } else if (slot < touchedLow_) {
+      touchedLow_ = slot;
+    } else if (slot >= touchedHigh_) {
+      touchedHigh_ = slot + 1;
+    }
+    touched_[touchedCount_++] = slot;
+  }
+  if (count + 1 > maxPending_) {
+    maxPending_ = count + 1;
+  }
+  return true;
+}
+
+void FilterBank::runStagedSamples() {
+  if (touchedCount_ == 0) {
+    return;
+  }
+  for (int round = 0; round < maxPending_; round++) {
+    runRound(round, touchedLow_, touchedHigh_);
+  }
+  for (size_t n = 0; n < touchedCount_; n++) {
+    pending_[touched_[n]] = 0;
+  }
+  maxPending_ = 0;
+}
+
+// Alle Plätze im Bereich werden gerechnet, nur Geräte mit einer Messung in
+// der Runde übernehmen das Ergebnis. Jede Schleife läuft ohne Sprung über
+// flache Arrays, damit der Compiler sie vektorisieren kann.
+void FilterBank::runScalarKalman(int round, size_t low, size_t high) {
+  const float q = processNoise_;
+  const float r = measurementNoise_;
+  const float* measuredDistance = stagedDistance_[round];
+  const uint32_t* measuredTime = stagedTime_[round];
+
+  // Kalman-Filter wie KalmanFilter::update
+  for (size_t i = low; i < high; i++) {
+    const bool active = round < pending_[i];
+    float x = kalmanX_[i];
+    float p = kalmanP_[i];
+    float predicted = p + q;
+    float gain = predicted / (predicted + r);
+    float estimate = x + gain * (measuredDistance[i] - x);
+    kalmanP_[i] = selectIf(active, (1 - gain) * predicted, p);
+    kalmanX_[i] = selectIf(active, estimate, x);
+    // Für einen späteren Wechsel auf TRACKER_VELOCITY
+    lastTime_[i] = selectIf(active, measuredTime[i], lastTime_[i]);
+    seeded_[i] |= (int32_t)active;
+  }
+}
+
+void FilterBank::runVelocityKalman(int round, size_t low, size_t high) {
+  const float q = processNoise_;
+  const float r = measurementNoise_;
+  const float* measuredDistance = stagedDistance_[round];
+  const uint32_t* measuredTime = stagedTime_[round];
+
+  // Kalman-Filter wie VelocityKalmanFilter::update; Neustart als Auswahl
+  // statt als Sprung
+  for (size_t i = low; i < high; i++) {
+    const bool active = round < pending_[i];
+    const float z = measuredDistance[i];
+    int32_t gap = (int32_t)(measuredTime[i] - lastTime_[i]);
+    const bool restart = (seeded_[i] == 0) | (gap < 0) | (gap > (int32_t)TRACKER_MAX_GAP_MS);
+    float dt = (float)gap * 0.001f;
+    float dt2 = dt * dt;
+
+    float x = kalmanX_[i];
+    float v = velocity_[i];
+    float p00 = kalmanP_[i];
+    float p01 = kalmanP01_[i];
+    float p11 = kalmanP11_[i];
+    float predicted = x + v * dt;
+    float q00 = p00 + dt * (2 * p01 + dt * p11) + q * dt2 * dt / 3;
+    float q01 = p01 + dt * p11 + q * dt2 / 2;
+    float q11 = p11 + q * dt;
+    float innovation = z - predicted;
+    float s = q00 + r;
+    float k0 = q00 / s;
+    float k1 = q01 / s;
+    float estimate = predicted + k0 * innovation;
+    estimate = estimate < 0 ? 0 : estimate;
+
+    const bool update = active & !restart;
+    const bool seed = active & restart;
+    kalmanX_[i] = selectIf(seed, z, selectIf(update, estimate, x));
+    velocity_[i] = selectIf(seed, 0.0f, selectIf(update, v + k1 * innovation, v));
+    kalmanP_[i] = selectIf(seed, r, selectIf(update, (1 - k0) * q00, p00));
+    kalmanP01_[i] = selectIf(seed, 0.0f, selectIf(update, (1 - k0) * q01, p01));
+    kalmanP11_[i] = selectIf(seed, TRACKER_SPEED_VARIANCE, selectIf(update, q11 - k1 * q01, p11));
+    lastTime_[i] = selectIf(active, measuredTime[i], lastTime_[i]);
+    seeded_[i] |= (int32_t)active;
+  }
+}
+
+void FilterBank::runRound(int round, size_t low, size_t high) {
+  const float* measuredRssi = stagedRssi_[round];
+  const int windowSize = windowSize_;
+
+  if (tracker_ == TRACKER_VELOCITY) {
+    runVelocityKalman(round, low, high);
+  } else {
+    runScalarKalman(round, low, high);
+  }
+
+  for (size_t i = low; i < high; i++) {
+    const bool active = round < pending_[i];
+    const float estimate = kalmanX_[i];
+
+    // Gleitende Mittelwerte wie MovingAverageFilter::update: der älteste Wert
+    // fällt aus der laufenden Summe, der neue kommt hinzu
+    float rssiSum = rssiSum_[i];
+    float distanceSum = distanceSum_[i];
+    rssiSum_[i] = selectIf(active, (rssiSum - rssiWindow_[windowSize - 1][i]) + measuredRssi[i], rssiSum);
+    distanceSum_[i] = selectIf(active, (distanceSum - distanceWindow_[windowSize - 1][i]) + estimate, distanceSum);
+    windowCount_[i] += (int32_t)(active & (windowCount_[i] < windowSize));
+  }
+
+  // Fenster als Schieberegister eine Position weiterschieben, [0] ist der neueste Wert
+  for (int w = windowSize - 1; w > 0; w--) {
+    for (size_t i = low; i < high; i++) {
+      const bool active = round < pending_[i];
+      rssiWindow_[w][i] = selectIf(active, rssiWindow_[w - 1][i], rssiWindow_[w][i]);
+      distanceWindow_[w][i] = selectIf(active, distanceWindow_[w - 1][i], distanceWindow_[w][i]);
+    }
+  }
+  for (size_t i = low; i < high; i++) {
+    const bool active = round < pending_[i];
+    rssiWindow_[0][i] = selectIf(active, measuredRssi[i], rssiWindow_[0][i]);
+    distanceWindow_[0][i] = selectIf(active, kalmanX_[i], distanceWindow_[0][i]);
+  }
+}
@@ -0,0 +1,137 @@
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Config.h"
+#include "MacAddress.h"
+
+// Kalman-Filter und gleitende Mittelwerte aller Geräte als Struktur aus Arrays.
+//
+// Statt pro Advertisement drei Filterobjekte im jeweiligen DeviceInfo zu
+// aktualisieren, sammelt die Bank die Messungen jedes Geräts (stage) und
+// rechnet sie einmal pro Tracking-Durchlauf für alle Geräte gemeinsam
+// (update). Die Schleifen laufen über zusammenhängende float-Arrays, ohne
+// Sprünge und ohne Aufrufe pro Gerät; der Compiler kann sie vektorisieren.
+// Mehrere Messungen eines Geräts werden in Runden abgearbeitet (Runde n
+// bearbeitet die n-te Messung aller Geräte), die Reihenfolge bleibt also
+// erhalten.
+//
+// Die Rechnung ist dieselbe wie in KalmanFilter::update und
+// MovingAverageFilter::update (Fenster als Schieberegister statt Ring). Auf
+// dem Host sind die Ergebnisse bitgleich; ein Compiler, der a*b+c zu FMA
+// zusammenzieht (Xtensa), kann in den letzten Bits abweichen, höchstens
+// 1e-5 relativ. Filtermodell (KalmanFilter bzw. VelocityKalmanFilter) und
+// Rauschen setzt setDistanceTracker, die Fenstergröße setWindowSize.
+//
+// Mit FILTER_BANK 1 ersetzt die Bank die Filterobjekte in DeviceInfo (siehe
+// processAdvertisement). Gefilterte Werte, Bereichsindex und nächster Beacon
+// sind dann erst nach flushFilterBank() aktuell.
+#ifndef FILTER_BANK
+#define FILTER_BANK 0
+#endif
+
+class FilterBank {
+public:
+  static constexpr uint16_t NO_SLOT = 0xFFFF;
+  static constexpr size_t CAPACITY = DEVICE_TABLE_CAPACITY;
+
+  FilterBank();
+  FilterBank(const FilterBank&) = delete;
+  FilterBank& operator=(const FilterBank&) = delete;
+
+  // Freier Platz mit frischem Filterzustand; NO_SLOT, wenn alle belegt sind
+  uint16_t acquire(MacAddress address);
+  void release(uint16_t slot);
+  bool owns(uint16_t slot, MacAddress address) const {
+    return slot < CAPACITY && owners_[slot] == address;
+  }
+
+  // Gibt Plätze frei, für die isStale(MacAddress, uint16_t slot) true liefert.
+  // Nur ohne gesammelte Messungen aufrufen (nach update).
+  template <typename F>
+  void reclaim(F&& isStale) {
+    for (size_t slot = 0; slot < CAPACITY; slot++) {
+      if (owners_[slot] != NO_MAC_ADDRESS && isStale(owners_[slot], (uint16_t)slot)) {
+        release((uint16_t)slot);
+      }
+    }
+  }
+
+  // Merkt eine Messung vom Zeitpunkt timestamp (millis()) vor; false, wenn für
+  // dieses Gerät schon FILTER_BANK_SAMPLES Messungen warten (erst update aufrufen)
+  bool stage(uint16_t slot, float rssi, float distance, uint32_t timestamp);
+  bool hasStagedSamples() const { return touchedCount_ > 0; }
+
+  // Fenstergröße der gleitenden Mittelwerte (1..MAX_WINDOW_SIZE) für alle
+  // Geräte; behält wie RingFilter::setWindowSize die neuesten Werte.
+  // Nur ohne gesammelte Messungen aufrufen (nach update).
+  void setWindowSize(int size);
+  int getWindowSize() const { return windowSize_; }
+
+  // Filtermodell und Rauschen für alle Geräte; beim Wechsel übernimmt das neue
+  // Modell die bisherige Schätzung wie in applyDistanceTracker.
+  // Nur ohne gesammelte Messungen aufrufen (nach update).
+  void setDistanceTracker(DistanceTracker tracker, float processNoise, float measurementNoise);
+
+  // Rechnet alle vorgemerkten Messungen und ruft danach onUpdated(uint16_t slot)
+  // für jedes betroffene Gerät auf
+  template <typename F>
+  void update(F&& onUpdated) {
+    runStagedSamples();
+    for (size_t n = 0; n < touchedCount_; n++) {
+      onUpdated(touched_[n]);
+    }
+    touchedCount_ = 0;
+  }
+
+  MacAddress owner(uint16_t slot) const { return owners_[slot]; }
+  float distance(uint16_t slot) const { return kalmanX_[slot]; }
+  float averageRssi(uint16_t slot) const { return rssiSum_[slot] / windowDivisor(slot); }
+  float averageDistance(uint16_t slot) const { return distanceSum_[slot] / windowDivisor(slot); }
+  size_t freeSlots() const { return freeCount_; }
+
+private:
+  void runStagedSamples();
+  void runRound(int round, size_t low, size_t high);
+  void runScalarKalman(int round, size_t low, size_t high);
+  void runVelocityKalman(int round, size_t low, size_t high);
+  float windowDivisor(uint16_t slot) const {
+    return (float)(windowCount_[slot] > 0 ? windowCount_[slot] : 1);
+  }
+
+  // Filterzustand, Index = Platz
+  MacAddress owners_[CAPACITY];
+  float kalmanX_[CAPACITY];
+  float kalmanP_[CAPACITY];     // Varianz von kalmanX_ (P00 bei TRACKER_VELOCITY)
+  float velocity_[CAPACITY];    // Nur TRACKER_VELOCITY
+  float kalmanP01_[CAPACITY];
+  float kalmanP11_[CAPACITY];
+  uint32_t lastTime_[CAPACITY];  // millis() der letzten Messung
+  int32_t seeded_[CAPACITY];     // Schon eine Messung gerechnet
+  float rssiWindow_[MAX_WINDOW_SIZE][CAPACITY];  // [0] ist der neueste Wert, ab windowCount_ 0
+  float distanceWindow_[MAX_WINDOW_SIZE][CAPACITY];
+  float rssiSum_[CAPACITY];
+  float distanceSum_[CAPACITY];
+  int32_t windowCount_[CAPACITY];               // Werte im Fenster, höchstens windowSize_
+  int windowSize_;
+  DistanceTracker tracker_;
+  float processNoise_;
+  float measurementNoise_;
+
+  // Vorgemerkte Messungen seit dem letzten update
+  float stagedRssi_[FILTER_BANK_SAMPLES][CAPACITY];
+  float stagedDistance_[FILTER_BANK_SAMPLES][CAPACITY];
+  uint32_t stagedTime_[FILTER_BANK_SAMPLES][CAPACITY];
+  int32_t pending_[CAPACITY];
+  uint16_t touched_[CAPACITY];
+  size_t touchedCount_;
+  size_t touchedLow_;
+  size_t touchedHigh_;
+  int maxPending_;
+
+  uint16_t freeSlots_[CAPACITY];
+  size_t freeCount_;
+};
+
+#endif // FILTERBANK_H
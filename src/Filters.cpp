@@ -24,33 +24,68 @@ float KalmanFilter::getValue() {
   return X;
 }
 
-// MovingAverageFilter implementation
-MovingAverageFilter::MovingAverageFilter(int size) {
-  windowSize = size;
-  window.resize(windowSize, 0);
-  currentIndex = 0;
-  windowFilled = false;
-  sum = 0;
-}
-
-float MovingAverageFilter::update(float newValue) {
-  // Subtract the oldest value from the sum
-  sum -= window[currentIndex];
-  
-  // Add the new value to the window and sum
-  window[currentIndex] = newValue;
-  sum += newValue;
-  
-  // Update index and filled flag
-  currentIndex = (currentIndex + 1) % windowSize;
-  if (currentIndex == 0) {
-    windowFilled = true;
+void KalmanFilter::setNoise(float processNoise, float measurementNoise) {
+  Q = processNoise;
+  R = measurementNoise;
+}
+
+// VelocityKalmanFilter implementation
+VelocityKalmanFilter::VelocityKalmanFilter(float processNoise, float measurementNoise) {
+  Q = processNoise;
+  R = measurementNoise;
+  X = 0;
+  V = 0;
+  P00 = measurementNoise;
+  P01 = 0;
+  P11 = TRACKER_SPEED_VARIANCE;
+  lastTime = 0;
+  seeded = false;
+}
+
+void VelocityKalmanFilter::seed(float value, uint32_t timestamp) {
+  X = value;
+  V = 0;
+  P00 = R;
+  P01 = 0;
+  P11 = TRACKER_SPEED_VARIANCE;
+  lastTime = timestamp;
+  seeded = true;
+}
+
+float VelocityKalmanFilter::update(float measurement, uint32_t timestamp) {
+  int32_t gap = (int32_t)(timestamp - lastTime);
+  if (!seeded || gap < 0 || gap > (int32_t)TRACKER_MAX_GAP_MS) {
+    seed(measurement, timestamp);
+    return X;
   }
-  
-  // Calculate average
-  return sum / (windowFilled ? windowSize : currentIndex);
+  float dt = gap * 0.001f;
+  lastTime = timestamp;
+
+  // Prediction step: X += V*dt, P = F*P*F' + Q(dt)
+  float dt2 = dt * dt;
+  X = X + V * dt;
+  P00 = P00 + dt * (2 * P01 + dt * P11) + Q * dt2 * dt / 3;
+  P01 = P01 + dt * P11 + Q * dt2 / 2;
+  P11 = P11 + Q * dt;
+
+  // Update step, nur die Entfernung wird gemessen
+  float innovation = measurement - X;
+  float s = P00 + R;
+  float k0 = P00 / s;
+  float k1 = P01 / s;
+  X = X + k0 * innovation;
+  V = V + k1 * innovation;
+  P11 = P11 - k1 * P01;
+  P01 = (1 - k0) * P01;
+  P00 = (1 - k0) * P00;
+  if (X < 0) {
+    X = 0;
+  }
+
+  return X;
 }
 
-float MovingAverageFilter::getValue() {
-  return sum / (windowFilled ? windowSize : (currentIndex == 0 ? 1 : currentIndex));
-}
\ No newline at end of file
+void VelocityKalmanFilter::setNoise(float processNoise, float measurementNoise) {
+  Q = processNoise;
+  R = measurementNoise;
+}
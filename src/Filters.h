@@ -1,9 +1,10 @@
 #ifndef FILTERS_H
 #define FILTERS_H
 
-#include <vector>
 #include "Config.h"
 
+static_assert(WINDOW_SIZE >= 1 && WINDOW_SIZE <= MAX_WINDOW_SIZE, "WINDOW_SIZE muss zwischen 1 und MAX_WINDOW_SIZE liegen");
+
 // Simple Kalman Filter implementation
 class KalmanFilter {
 private:
@@ -17,21 +18,128 @@ public:
   KalmanFilter(float initialValue = 0, float processNoise = PROCESS_NOISE, float measurementNoise = MEASUREMENT_NOISE);
   float update(float measurement);
   float getValue();
+  void setNoise(float processNoise, float measurementNoise);
+  // Übernimmt einen Schätzwert samt Varianz (Wechsel des Filtermodells)
+  void seed(float value, float variance) { X = value; P = variance; }
+};
+
+// Kalman-Filter mit Entfernung und Geschwindigkeit (konstante Geschwindigkeit,
+// weißes Beschleunigungsrauschen mit der Dichte processNoise in m²/s³).
+//
+// Anders als KalmanFilter rechnet er mit der tatsächlich vergangenen Zeit
+// zwischen zwei Messungen: seltene Advertisements (Sparbetrieb, verlorene
+// Pakete) bremsen ihn nicht, und ein Beacon, der sich gleichmäßig entfernt,
+// wird ohne Nachlauf verfolgt. Er startet bei der ersten Messung statt bei 0
+// und nach einer Pause über TRACKER_MAX_GAP_MS neu.
+class VelocityKalmanFilter {
+private:
+  float X;    // Entfernung (m), nie negativ
+  float V;    // Geschwindigkeit (m/s), positiv: entfernt sich
+  float P00;  // Kovarianz von X und V
+  float P01;
+  float P11;
+  float Q;
+  float R;
+  uint32_t lastTime;  // millis() der letzten Messung
+  bool seeded;
+
+public:
+  VelocityKalmanFilter(float processNoise = PROCESS_NOISE, float measurementNoise = MEASUREMENT_NOISE);
+  float update(float measurement, uint32_t timestamp);
+  float getValue() const { return X; }
+  float getVelocity() const { return V; }
+  float getVariance() const { return P00; }
+  void setNoise(float processNoise, float measurementNoise);
+  // Startet bei value zum Zeitpunkt timestamp, ohne Geschwindigkeit
+  void seed(float value, uint32_t timestamp);
 };
 
 // Moving Average Filter implementation
-class MovingAverageFilter {
+//
+// Ringpuffer mit fester Kapazität direkt im Objekt, ohne Heap. Die Fenstergröße
+// kann zur Laufzeit zwischen 1 und Capacity liegen und sich ändern
+// (setWindowSize), die neuesten Werte bleiben dabei erhalten.
+template <int Capacity>
+class RingFilter {
 private:
-  std::vector<float> window;
+  float window[Capacity];
   int windowSize;
   int currentIndex;
   bool windowFilled;
   float sum;
 
 public:
-  MovingAverageFilter(int size = WINDOW_SIZE);
+  RingFilter(int size = WINDOW_SIZE);
   float update(float newValue);
   float getValue();
+  void setWindowSize(int size);
+  int getWindowSize() const { return windowSize; }
 };
 
+typedef RingFilter<MAX_WINDOW_SIZE> MovingAverageFilter;
+
+template <int Capacity>
+RingFilter<Capacity>::RingFilter(int size) {
+  windowSize = size < 1 ? 1 : (size > Capacity ? Capacity : size);
+  for (int i = 0; i < Capacity; i++) {
+    window[i] = 0;
+  }
+  currentIndex = 0;
+  windowFilled = false;
+  sum = 0;
+}
+
+template <int Capacity>
+float RingFilter<Capacity>::update(float newValue) {
+  // Subtract the oldest value from the sum
+  sum -= window[currentIndex];
+  
+  // Add the new value to the window and sum
+  window[currentIndex] = newValue;
+  sum += newValue;
+  
+  // Update index and filled flag
+  currentIndex = (currentIndex + 1) % windowSize;
+  if (currentIndex == 0) {
+    windowFilled = true;
+  }
+  
+  // Calculate average
+  return sum / (windowFilled ? windowSize : currentIndex);
+}
+
+template <int Capacity>
+float RingFilter<Capacity>::getValue() {
+  return sum / (windowFilled ? windowSize : (currentIndex == 0 ? 1 : currentIndex));
+}
+
+template <int Capacity>
+void RingFilter<Capacity>::setWindowSize(int size) {
+  size = size < 1 ? 1 : (size > Capacity ? Capacity : size);
+  if (size == windowSize) {
+    return;
+  }
+  
+  // Die neuesten Werte, die ins neue Fenster passen, in zeitlicher Reihenfolge
+  int count = windowFilled ? windowSize : currentIndex;
+  int keep = count < size ? count : size;
+  float newest[Capacity];
+  for (int i = 0; i < keep; i++) {
+    newest[i] = window[(currentIndex - keep + i + windowSize) % windowSize];
+  }
+  
+  // Ab Position 0 neu anlegen; freie Plätze sind 0, wie nach dem Konstruktor
+  for (int i = 0; i < Capacity; i++) {
+    window[i] = 0;
+  }
+  sum = 0;
+  for (int i = 0; i < keep; i++) {
+    window[i] = newest[i];
+    sum += newest[i];
+  }
+  windowSize = size;
+  windowFilled = keep == size;
+  currentIndex = keep % size;
+}
+
 #endif // FILTERS_H
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "InRangeIndex.h"
+#include <cstring>
+
+InRangeIndex::InRangeIndex(size_t capacity) :
+  entries_(new Entry[capacity]),
+  size_(0),
+  capacity_(capacity) {
+}
+
+InRangeIndex::~InRangeIndex() {
+  delete[] entries_;
+}
+
+size_t InRangeIndex::findPosition(MacAddress address) const {
+  for (size_t i = 0; i < size_; i++) {
+    if (entries_[i].address == address) {
+      return i;
+    }
+  }
+  return NOT_FOUND;
+}
+
+void InRangeIndex::removeAt(size_t position) {
+  memmove(&entries_[position], &entries_[position + 1], (size_ - position - 1) * sizeof(Entry));
+  size_--;
+}
+
+void InRangeIndex::update(MacAddress address, float distance, bool inRange) {
+  size_t position = findPosition(address);
+  if (position != NOT_FOUND) {
+    removeAt(position);
+  }
+  if (!inRange || size_ >= capacity_) {
+    return;
+  }
+  
+  // Hinter gleich weit entfernten Geräten einsortieren, damit ein bisher
+  // nächstes Gerät bei Gleichstand vorne bleibt
+  size_t insertAt = size_;
+  while (insertAt > 0 && entries_[insertAt - 1].distance > distance) {
+    insertAt--;
+  }
+  memmove(&entries_[insertAt + 1], &entries_[insertAt], (size_ - insertAt) * sizeof(Entry));
+  entries_[insertAt].address = address;
+  entries_[insertAt].distance = distance;
+  size_++;
+}
+
+bool InRangeIndex::remove(MacAddress address) {
+  size_t position = findPosition(address);
+  if (position == NOT_FOUND) {
+    return false;
+  }
+  removeAt(position);
+  return true;
+}
+
+void InRangeIndex::clear() {
+  size_ = 0;
+}
@@ -0,0 +1,52 @@
+#ifndef INRANGEINDEX_H
+#define INRANGEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include "MacAddress.h"
+
+// Geräte innerhalb des Distanz-Schwellenwerts, aufsteigend nach gefilterter
+// Distanz sortiert. Wird bei jedem verarbeiteten Advertisement nachgeführt,
+// damit Zählung, nächster Beacon (Rang 0) und die JSON-Liste nicht mehr die
+// ganze Gerätetabelle durchlaufen müssen.
+//
+// Ein Eintrag fällt heraus, wenn das Gerät den Schwellenwert überschreitet
+// (update mit inRange=false) oder aus der Tabelle verdrängt wird bzw. zu lange
+// kein Advertisement mehr kam (remove, siehe expireDevices in BLEScanner).
+class InRangeIndex {
+public:
+  explicit InRangeIndex(size_t capacity);
+  ~InRangeIndex();
+  InRangeIndex(const InRangeIndex&) = delete;
+  InRangeIndex& operator=(const InRangeIndex&) = delete;
+
+  // Nimmt das Gerät auf bzw. sortiert es neu ein (inRange) oder entfernt es
+  void update(MacAddress address, float distance, bool inRange);
+  bool remove(MacAddress address);
+  void clear();
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool contains(MacAddress address) const { return findPosition(address) != NOT_FOUND; }
+
+  // Rang 0 ist das nächste Gerät
+  MacAddress addressAt(size_t rank) const { return entries_[rank].address; }
+  float distanceAt(size_t rank) const { return entries_[rank].distance; }
+
+private:
+  struct Entry {
+    MacAddress address;
+    float distance;
+  };
+
+  static constexpr size_t NOT_FOUND = ~(size_t)0;
+
+  size_t findPosition(MacAddress address) const;
+  void removeAt(size_t position);
+
+  Entry* entries_;
+  size_t size_;
+  size_t capacity_;
+};
+
+#endif // INRANGEINDEX_H
@@ -2,91 +2,107 @@
 #include "Config.h"
 #include "DeviceInfo.h"
 #include "BeaconTracker.h"
+#include "BLEScanner.h"
+#include "Log.h"
 
-// Generate JSON for a specific beacon
-String generateBeaconJSON(const std::string& address, DeviceInfo& device, float lastSeenOverride) {
-  // Berechne last_seen Wert
-  float lastSeenValue = 0;
-  bool forceCrusherAbsent = false;
-  
-  if (lastSeenOverride >= 0) {
-    lastSeenValue = lastSeenOverride;
-    // Wenn lastSeenOverride > BEACON_TIMEOUT_SECONDS, setzen wir crusher auf false
-    if (lastSeenOverride > BEACON_TIMEOUT_SECONDS) {
-      forceCrusherAbsent = true;
-    }
-  } else {
-    lastSeenValue = (millis() - device.lastSeen) / 1000.0;
-  }
-  
-  // Bestimme crusher basierend auf last_seen im Vergleich zum Schwellenwert
-  // Aber überschreibe mit forceCrusherAbsent, wenn gesetzt
-  bool isCrusherPresent = forceCrusherAbsent ? false : (lastSeenValue < BEACON_TIMEOUT_SECONDS);
+// Ein Beacon-Objekt aus Name, Distanz und Anwesenheit
+static void writeBeaconObject(JsonWriter& writer, const char* name, float distance, const BeaconPresence& presence) {
+  writer.literal("{\"name\":").string(name);
+  writer.literal(",\"distance\":").fixed<2>(distance);
+  writer.literal(",\"last_seen\":").fixed<1>(presence.lastSeen);
+  writer.literal(",\"crusher\":").boolean(presence.present);
+  writer.literal("}");
+}
+
+// Write JSON for a specific beacon
+void writeBeaconJSON(JsonWriter& writer, MacAddress address, const DeviceInfo& device, float lastSeenOverride) {
+  // last_seen und crusher (Anwesenheit) wie beim Binär-Uplink
+  BeaconPresence presence = getBeaconPresence(device, lastSeenOverride);
   
   // Debug-Ausgabe zur JSON-Generierung
-  Serial.println("UART-DEBUG: JSON-Generierung für Beacon: " + String(address.c_str()));
-  Serial.print("UART-DEBUG: last_seen = "); 
-  Serial.print(lastSeenValue);
-  Serial.print(", forceCrusherAbsent = ");
-  Serial.print(forceCrusherAbsent ? "true" : "false");
-  Serial.print(", crusher = ");
-  Serial.println(isCrusherPresent ? "true" : "false");
+  LOG_DEBUG(LOG_JSON, "JSON für Beacon %s: last_seen = %.2f, forceCrusherAbsent = %s, crusher = %s",
+            macToString(address).text, presence.lastSeen, presence.forcedAbsent ? "true" : "false",
+            presence.present ? "true" : "false");
   
   // Generiere JSON
-  String json = "{";
-  json += "\"name\":\"" + String(device.name.c_str()) + "\",";
-  json += "\"distance\":" + String(device.filteredDistance, 2) + ",";
-  json += "\"last_seen\":" + String(lastSeenValue, 1) + ",";
-  json += "\"crusher\":" + String(isCrusherPresent ? "true" : "false");
-  json += "}";
-  
-  return json;
+  writeBeaconObject(writer, getDeviceName(device), device.filteredDistance, presence);
+}
+
+void writeBeaconReportsJSON(JsonWriter& writer, const BeaconReport* reports, size_t count) {
+  // Eine einzelne Meldung bleibt ein Objekt, mehrere werden ein Array
+  if (count != 1) {
+    writer.literal("[");
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (i > 0) {
+      writer.literal(",");
+    }
+    writeBeaconObject(writer, reports[i].name, reports[i].distance, reports[i].presence);
+  }
+  if (count != 1) {
+    writer.literal("]");
+  }
 }
 
-// Generate JSON string for all devices within threshold
-String generateDevicesJSON() {
-  String json = "{\"devices\":[";
+// Write JSON for all devices within threshold
+void writeDevicesJSON(JsonWriter& writer) {
+  writer.literal("{\"devices\":[");
   
   bool firstDevice = true;
   int deviceCount = 0;
   
-  for (auto const& pair : deviceInfoMap) {
-    std::string address = pair.first;
-    DeviceInfo device = pair.second;
-    
-    // Skip devices not in our filter (if filter is active)
-    if (!isDeviceInFilter(address)) {
+  // Devices within range, nearest first; expired devices were already removed
+  // by countDevicesInRange/findAndTrackClosestBeacon
+  for (size_t rank = 0; rank < inRangeIndex.size(); rank++) {
+    MacAddress address = inRangeIndex.addressAt(rank);
+    DeviceInfo* device = deviceTable.find(address);
+    if (device == nullptr) {
       continue;
     }
     
-    // Only include devices within range and seen in the last 30 seconds
-    if (device.filteredDistance <= DISTANCE_THRESHOLD && (millis() - device.lastSeen) < 30000) {
-      // Add comma separator between devices
-      if (!firstDevice) {
-        json += ",";
-      }
-      firstDevice = false;
-      deviceCount++;
-      
-      // Output device as JSON object
-      json += generateBeaconJSON(address, device);
+    // Add comma separator between devices
+    if (!firstDevice) {
+      writer.literal(",");
     }
+    firstDevice = false;
+    deviceCount++;
+    
+    // Output device as JSON object
+    writeBeaconJSON(writer, address, *device);
   }
   
-  json += "],";
-  json += "\"count\":" + String(deviceCount) + ",";
-  json += "\"timestamp\":" + String(millis() / 1000.0);
-  json += "}";
-  
-  return json;
+  writer.literal("],\"count\":").integer(deviceCount);
+  writer.literal(",\"timestamp\":").fixed<2>(millis() / 1000.0);
+  writer.literal("}");
+}
+
+size_t generateBeaconJSON(char* buffer, size_t size, MacAddress address, const DeviceInfo& device,
+                          float lastSeenOverride) {
+  JsonWriter writer(buffer, size);
+  writeBeaconJSON(writer, address, device, lastSeenOverride);
+  return writer.length();
+}
+
+size_t generateBeaconReportsJSON(char* buffer, size_t size, const BeaconReport* reports, size_t count) {
+  JsonWriter writer(buffer, size);
+  writeBeaconReportsJSON(writer, reports, count);
+  return writer.length();
+}
+
+size_t generateDevicesJSON(char* buffer, size_t size) {
+  JsonWriter writer(buffer, size);
+  writeDevicesJSON(writer);
+  return writer.length();
 }
 
 // Output JSON formatted device data to Serial
 void outputDevicesAsJson() {
-  // Generate JSON string for serial output
-  String jsonStr = generateDevicesJSON();
-  
-  // Print to serial
   Serial.println("Device data:");
-  Serial.println(jsonStr);
-}
\ No newline at end of file
+  
+  // Direkt auf die Schnittstelle, ohne den ganzen Text zwischenzuspeichern
+  {
+    JsonWriter writer(Serial);
+    writeDevicesJSON(writer);
+  }
+  Serial.println();
+}
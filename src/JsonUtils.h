@@ -4,14 +4,24 @@
 #include <Arduino.h>
 #include <string>
 #include "DeviceInfo.h"
+#include "JsonWriter.h"
 
-// Generate JSON for a specific beacon
-String generateBeaconJSON(const std::string& address, DeviceInfo& device, float lastSeenOverride = -1);
+// Write JSON for a specific beacon
+void writeBeaconJSON(JsonWriter& writer, MacAddress address, const DeviceInfo& device, float lastSeenOverride = -1);
 
-// Generate JSON for all devices within threshold
-String generateDevicesJSON();
+// Gesammelte Meldungen: eine als Objekt (wie writeBeaconJSON), mehrere als Array
+void writeBeaconReportsJSON(JsonWriter& writer, const BeaconReport* reports, size_t count);
+
+// Write JSON for all devices within threshold
+void writeDevicesJSON(JsonWriter& writer);
+
+// Puffer-Varianten: Rückgabe wie bei snprintf, ist sie >= size, wurde abgeschnitten
+size_t generateBeaconJSON(char* buffer, size_t size, MacAddress address, const DeviceInfo& device,
+                          float lastSeenOverride = -1);
+size_t generateBeaconReportsJSON(char* buffer, size_t size, const BeaconReport* reports, size_t count);
+size_t generateDevicesJSON(char* buffer, size_t size);
 
 // Output formatted JSON data to Serial
 void outputDevicesAsJson();
 
-#endif // JSONUTILS_H
\ No newline at end of file
+#endif // JSONUTILS_H
@@ -0,0 +1,97 @@
+#include "JsonWriter.h"
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity)
+  : out_(nullptr), buffer_(buffer), capacity_(capacity), used_(0), length_(0) {
+  if (capacity_ > 0) {
+    buffer_[0] = '\0';
+  }
+}
+
+JsonWriter::JsonWriter(Print& out)
+  : out_(&out), buffer_(staging_), capacity_(STAGING_SIZE), used_(0), length_(0) {
+}
+
+JsonWriter& JsonWriter::raw(const char* text, size_t length) {
+  length_ += length;
+
+  if (out_ != nullptr) {
+    while (length > 0) {
+      if (used_ == capacity_) {
+        flush();
+      }
+      size_t chunk = capacity_ - used_;
+      if (chunk > length) {
+        chunk = length;
+      }
+      memcpy(buffer_ + used_, text, chunk);
+      used_ += chunk;
+      text += chunk;
+      length -= chunk;
+    }
+    return *this;
+  }
+
+  // Puffer-Ziel: ein Zeichen bleibt für den Nullterminator
+  if (capacity_ == 0) {
+    return *this;
+  }
+  size_t room = capacity_ - 1 - used_;
+  if (length > room) {
+    length = room;
+  }
+  memcpy(buffer_ + used_, text, length);
+  used_ += length;
+  buffer_[used_] = '\0';
+  return *this;
+}
+
+JsonWriter& JsonWriter::raw(char c) {
+  return raw(&c, 1);
+}
+
+JsonWriter& JsonWriter::string(const char* text) {
+  raw('"');
+  const char* run = text;
+  const char* p = text;
+  for (; *p != '\0'; p++) {
+    unsigned char c = (unsigned char)*p;
+    if (c != '"' && c != '\\' && c >= 0x20) {
+      continue;
+    }
+    // Unkritische Zeichen am Stück übernehmen, dann das Escape
+    raw(run, p - run);
+    run = p + 1;
+    if (c == '"' || c == '\\') {
+      char escaped[2] = {'\\', (char)c};
+      raw(escaped, 2);
+    } else {
+      static const char HEX_DIGITS[] = "0123456789abcdef";
+      char escaped[6] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F]};
+      raw(escaped, 6);
+    }
+  }
+  raw(run, p - run);
+  return raw('"');
+}
+
+JsonWriter& JsonWriter::integer(long value) {
+  // Von hinten nach vorne, wie ltoa(value, ..., 10)
+  char digits[21];
+  char* p = digits + sizeof(digits);
+  unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+  do {
+    *--p = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (value < 0) {
+    *--p = '-';
+  }
+  return raw(p, digits + sizeof(digits) - p);
+}
+
+void JsonWriter::flush() {
+  if (out_ != nullptr && used_ > 0) {
+    out_->write((const uint8_t*)buffer_, used_);
+    used_ = 0;
+  }
+}
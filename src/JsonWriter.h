@@ -0,0 +1,62 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <Arduino.h>
+
+// Schreibt JSON ohne Heap, entweder in einen Puffer des Aufrufers oder direkt
+// auf einen Print-Stream (Serial, UART).
+//
+// Zahlen werden mit dtostrf() formatiert, genau wie String(float, n) - die
+// Ausgabe ist also byte-identisch zur früheren String-Verkettung. Die Anzahl
+// der Nachkommastellen ist ein Template-Parameter, Schlüssel werden als
+// Literale mit zur Übersetzungszeit bekannter Länge übergeben.
+class JsonWriter {
+public:
+  // Puffer-Ziel: der Text bleibt immer nullterminiert. Was nicht passt, wird
+  // abgeschnitten, length() zählt aber weiter (wie bei snprintf)
+  JsonWriter(char* buffer, size_t capacity);
+  // Stream-Ziel: wird in Blöcken von STAGING_SIZE Byte geschrieben
+  explicit JsonWriter(Print& out);
+  ~JsonWriter() { flush(); }
+  JsonWriter(const JsonWriter&) = delete;
+  JsonWriter& operator=(const JsonWriter&) = delete;
+
+  // Unveränderter Text, z.B. literal("\"distance\":")
+  template <size_t N>
+  JsonWriter& literal(const char (&text)[N]) { return raw(text, N - 1); }
+  JsonWriter& raw(const char* text, size_t length);
+  JsonWriter& raw(char c);
+
+  // String in Anführungszeichen; ", \ und Steuerzeichen werden maskiert
+  JsonWriter& string(const char* text);
+
+  // Festkomma wie String(value, Decimals)
+  template <unsigned char Decimals>
+  JsonWriter& fixed(double value) {
+    char digits[Decimals + 42];
+    dtostrf(value, Decimals + 2, Decimals, digits);
+    return raw(digits, strlen(digits));
+  }
+
+  JsonWriter& integer(long value);
+  JsonWriter& boolean(bool value) { return value ? literal("true") : literal("false"); }
+
+  // Gibt gesammelte Zeichen an den Stream weiter (Puffer-Ziel: ohne Wirkung)
+  void flush();
+
+  // Anzahl geschriebener Zeichen, auch abgeschnittener
+  size_t length() const { return length_; }
+  bool overflowed() const { return out_ == nullptr && length_ >= capacity_; }
+
+private:
+  static constexpr size_t STAGING_SIZE = 64;
+
+  Print* out_;
+  char* buffer_;
+  size_t capacity_;
+  size_t used_;  // Belegte Zeichen in buffer_
+  size_t length_;
+  char staging_[STAGING_SIZE];
+};
+
+#endif // JSONWRITER_H
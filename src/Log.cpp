@@ -0,0 +1,129 @@
+#include "Log.h"
+#include "Config.h"
+#include "Pipeline.h"
+#include <atomic>
+#include <cstdarg>
+
+// Begrenzter Ring für mehrere Schreiber und einen Leser (Verfahren nach
+// D. Vyukov): jeder Platz trägt eine Sequenznummer, die anzeigt, ob er frei
+// oder beschrieben ist. Schreiber reservieren einen Platz per CAS auf
+// writePosition und geben ihn nach dem Formatieren über die Sequenz frei.
+struct LogSlot {
+  std::atomic<uint32_t> sequence;
+  uint32_t timestamp;
+  uint8_t level;
+  uint8_t category;
+  char text[LOG_MESSAGE_LENGTH];
+};
+
+static_assert((LOG_QUEUE_LENGTH & (LOG_QUEUE_LENGTH - 1)) == 0, "LOG_QUEUE_LENGTH must be a power of two");
+
+static LogSlot logSlots[LOG_QUEUE_LENGTH];
+static std::atomic<uint32_t> writePosition(0);
+static uint32_t readPosition = 0;
+static std::atomic<uint32_t> droppedMessages(0);
+static uint32_t reportedDrops = 0;
+
+static const char LEVEL_TAGS[] = {'-', 'E', 'W', 'I', 'D'};
+static const char* const CATEGORY_NAMES[LOG_CATEGORY_COUNT] = {
+  "system", "scan", "track", "json", "uart", "config"
+};
+
+static TaskHandle_t logTask = nullptr;
+
+#if PIPELINE_USE_TASK
+static void logTaskMain(void* parameter) {
+  (void)parameter;
+  while (true) {
+    // Blockiert bis zum Intervall oder bis logWrite den halb vollen Ring meldet
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_DRAIN_INTERVAL));
+    runLogDrain();
+  }
+}
+#endif
+
+void initLog() {
+  for (uint32_t i = 0; i < LOG_QUEUE_LENGTH; i++) {
+    logSlots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  
+#if PIPELINE_USE_TASK
+  xTaskCreatePinnedToCore(logTaskMain, "log_drain", LOG_TASK_STACK, nullptr,
+                          LOG_TASK_PRIORITY, &logTask, LOG_TASK_CORE);
+#endif
+}
+
+void logWrite(uint8_t level, uint8_t category, const char* format, ...) {
+  uint32_t position = writePosition.load(std::memory_order_relaxed);
+  LogSlot* slot;
+  while (true) {
+    slot = &logSlots[position & (LOG_QUEUE_LENGTH - 1)];
+    int32_t diff = (int32_t)(slot->sequence.load(std::memory_order_acquire) - position);
+    if (diff == 0) {
+      if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // Ring voll: lieber verlieren als warten
+      droppedMessages.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      position = writePosition.load(std::memory_order_relaxed);
+    }
+  }
+  
+  slot->timestamp = millis();
+  slot->level = level;
+  slot->category = category;
+  va_list args;
+  va_start(args, format);
+  vsnprintf(slot->text, sizeof(slot->text), format, args);
+  va_end(args);
+  
+  slot->sequence.store(position + 1, std::memory_order_release);
+  
+  // Bei jeder halben Ringlänge den Ausgabe-Task wecken, nicht bei jeder Meldung
+  if (((position + 1) & (LOG_QUEUE_LENGTH / 2 - 1)) == 0 && logTask != nullptr) {
+    xTaskNotifyGive(logTask);
+  }
+}
+
+int runLogDrain() {
+  // Zeitstempel, Stufe, Kategorie, Text und Zeilenende
+  char line[LOG_MESSAGE_LENGTH + 32];
+  int written = 0;
+  
+  while (true) {
+    LogSlot& slot = logSlots[readPosition & (LOG_QUEUE_LENGTH - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1) {
+      break;
+    }
+    int length = snprintf(line, sizeof(line), "[%lu] %c %s: %s\r\n", (unsigned long)slot.timestamp,
+                          LEVEL_TAGS[slot.level <= LOG_LEVEL_DEBUG ? slot.level : 0],
+                          slot.category < LOG_CATEGORY_COUNT ? CATEGORY_NAMES[slot.category] : "?",
+                          slot.text);
+    slot.sequence.store(readPosition + LOG_QUEUE_LENGTH, std::memory_order_release);
+    readPosition++;
+    
+    if (length >= (int)sizeof(line)) {
+      // Abgeschnittene Meldung trotzdem mit Zeilenende abschließen
+      length = sizeof(line) - 1;
+      line[length - 2] = '\r';
+      line[length - 1] = '\n';
+    }
+    Serial.write((const uint8_t*)line, length);
+    written++;
+  }
+  
+  uint32_t dropped = droppedMessages.load(std::memory_order_relaxed);
+  if (dropped != reportedDrops) {
+    Serial.printf("[%lu] W system: %lu Protokollmeldungen verworfen (Ring voll)\r\n",
+                  (unsigned long)millis(), (unsigned long)(dropped - reportedDrops));
+    reportedDrops = dropped;
+  }
+  return written;
+}
+
+uint32_t getDroppedLogMessages() {
+  return droppedMessages.load(std::memory_order_relaxed);
+}
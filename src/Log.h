@@ -0,0 +1,67 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Protokollierung mit Stufen und Kategorien.
+//
+// Stufe und Kategorien werden beim Bauen festgelegt (LOG_LEVEL, LOG_CATEGORIES,
+// z.B. build_flags = -DLOG_LEVEL=4). Abgeschaltete Aufrufe fallen komplett
+// weg, auch ihre Argumente werden nicht ausgewertet. Aktive Meldungen werden
+// ohne Heap in einen lock-freien Ring formatiert und von einem eigenen Task
+// unterhalb der Verarbeitung auf Serial ausgegeben, damit das Tracking nie auf
+// die serielle Schnittstelle wartet. Der Task schläft zwischen zwei Ausgaben
+// (LOG_DRAIN_INTERVAL) und wird bei halb vollem Ring früher geweckt. Ist der
+// Ring voll, wird die Meldung gezählt und verworfen.
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+enum LogCategory {
+  LOG_SYSTEM = 0,
+  LOG_SCAN,     // BLE-Scan und Advertisements
+  LOG_TRACK,    // Beacon-Tracking
+  LOG_JSON,     // JSON-Erzeugung
+  LOG_UART,     // Meshtastic-UART
+  LOG_CONFIG,   // Konfiguration
+  LOG_CATEGORY_COUNT
+};
+
+// Bitmaske der aktiven Kategorien (Bit n = LogCategory n)
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES 0xFFFFFFFFu
+#endif
+
+#define LOG_ENABLED(level, category) ((level) <= LOG_LEVEL && ((LOG_CATEGORIES >> (category)) & 1u))
+
+#define LOG_AT(level, category, ...)                \
+  do {                                              \
+    if (LOG_ENABLED(level, category)) {             \
+      logWrite(level, category, __VA_ARGS__);       \
+    }                                               \
+  } while (0)
+
+#define LOG_ERROR(category, ...) LOG_AT(LOG_LEVEL_ERROR, category, __VA_ARGS__)
+#define LOG_WARN(category, ...)  LOG_AT(LOG_LEVEL_WARN, category, __VA_ARGS__)
+#define LOG_INFO(category, ...)  LOG_AT(LOG_LEVEL_INFO, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_AT(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+
+// Startet den Ausgabe-Task (ohne PIPELINE_USE_TASK ruft loop() runLogDrain() auf)
+void initLog();
+
+// Formatiert die Meldung in den Ring; aus jedem Task aufrufbar
+void logWrite(uint8_t level, uint8_t category, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+// Gibt alle wartenden Meldungen aus, liefert deren Anzahl
+int runLogDrain();
+
+uint32_t getDroppedLogMessages();
+
+#endif // LOG_H
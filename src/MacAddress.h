@@ -0,0 +1,79 @@
+#ifndef MACADDRESS_H
+#define MACADDRESS_H
+
+#include <cstdint>
+#include <cstdio>
+
+// 48-bit BLE address packed into an integer in text order:
+// "aa:bb:cc:dd:ee:ff" -> 0xaabbccddeeff
+typedef uint64_t MacAddress;
+
+// Never a valid 48-bit address - marks "no address"
+static constexpr MacAddress NO_MAC_ADDRESS = ~0ULL;
+
+// Text form without heap allocation, e.g. macToString(mac).text
+struct MacString {
+  char text[18];
+};
+
+// NimBLE stores the address little-endian (native[0] is the last octet)
+inline MacAddress macFromNative(const uint8_t* native) {
+  MacAddress mac = 0;
+  for (int i = 5; i >= 0; i--) {
+    mac = (mac << 8) | native[i];
+  }
+  return mac;
+}
+
+inline MacString macToString(MacAddress mac) {
+  MacString str;
+  snprintf(str.text, sizeof(str.text), "%02x:%02x:%02x:%02x:%02x:%02x",
+           (unsigned)((mac >> 40) & 0xFF), (unsigned)((mac >> 32) & 0xFF),
+           (unsigned)((mac >> 24) & 0xFF), (unsigned)((mac >> 16) & 0xFF),
+           (unsigned)((mac >> 8) & 0xFF), (unsigned)(mac & 0xFF));
+  return str;
+}
+
+// Parses "aa:bb:cc:dd:ee:ff" (also '-' separated, any case).
+// Surrounding whitespace is ignored. Returns false on malformed input.
+inline bool parseMacAddress(const char* text, MacAddress& out) {
+  if (text == nullptr) {
+    return false;
+  }
+  while (*text == ' ' || *text == '\t') {
+    text++;
+  }
+  MacAddress mac = 0;
+  for (int octet = 0; octet < 6; octet++) {
+    for (int nibble = 0; nibble < 2; nibble++) {
+      char c = *text++;
+      int value;
+      if (c >= '0' && c <= '9') {
+        value = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        value = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        value = c - 'A' + 10;
+      } else {
+        return false;
+      }
+      mac = (mac << 4) | (MacAddress)value;
+    }
+    if (octet < 5) {
+      if (*text != ':' && *text != '-') {
+        return false;
+      }
+      text++;
+    }
+  }
+  while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n') {
+    text++;
+  }
+  if (*text != '\0') {
+    return false;
+  }
+  out = mac;
+  return true;
+}
+
+#endif // MACADDRESS_H
@@ -0,0 +1,144 @@
+#include "MacAllowlist.h"
+#include <cstring>
+
+MacAllowlist::MacAllowlist(size_t maxEntries) : maxEntryCount(maxEntries) {
+}
+
+void MacAllowlist::pack(MacAddress mac, uint8_t* out) {
+  for (int i = RECORD_SIZE - 1; i >= 0; i--) {
+    out[i] = mac & 0xFF;
+    mac >>= 8;
+  }
+}
+
+MacAddress MacAllowlist::at(size_t index) const {
+  MacAddress mac = 0;
+  const uint8_t* record = &records[index * RECORD_SIZE];
+  for (size_t i = 0; i < RECORD_SIZE; i++) {
+    mac = (mac << 8) | record[i];
+  }
+  return mac;
+}
+
+size_t MacAllowlist::lowerBound(const uint8_t* key) const {
+  size_t low = 0;
+  size_t high = size();
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (memcmp(&records[mid * RECORD_SIZE], key, RECORD_SIZE) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+bool MacAllowlist::contains(MacAddress mac) const {
+  uint8_t key[RECORD_SIZE];
+  pack(mac, key);
+  size_t index = lowerBound(key);
+  return index < size() && memcmp(&records[index * RECORD_SIZE], key, RECORD_SIZE) == 0;
+}
+
+bool MacAllowlist::add(MacAddress mac) {
+  uint8_t key[RECORD_SIZE];
+  pack(mac, key);
+  size_t index = lowerBound(key);
+  if (index < size() && memcmp(&records[index * RECORD_SIZE], key, RECORD_SIZE) == 0) {
+    return false;
+  }
+  if (size() >= maxEntryCount) {
+    return false;
+  }
+  records.insert(records.begin() + index * RECORD_SIZE, key, key + RECORD_SIZE);
+  return true;
+}
+
+bool MacAllowlist::remove(MacAddress mac) {
+  uint8_t key[RECORD_SIZE];
+  pack(mac, key);
+  size_t index = lowerBound(key);
+  if (index >= size() || memcmp(&records[index * RECORD_SIZE], key, RECORD_SIZE) != 0) {
+    return false;
+  }
+  auto first = records.begin() + index * RECORD_SIZE;
+  records.erase(first, first + RECORD_SIZE);
+  return true;
+}
+
+void MacAllowlist::clear() {
+  records.clear();
+}
+
+size_t MacAllowlist::parseList(const String& list) {
+  size_t added = 0;
+  int start = 0;
+  while (start <= (int)list.length()) {
+    int comma = list.indexOf(',', start);
+    int end = comma >= 0 ? comma : list.length();
+    
+    // Einzelne Adresse ohne String-Kopie parsen
+    char text[24];
+    int len = end - start;
+    if (len > 0 && len < (int)sizeof(text)) {
+      memcpy(text, list.c_str() + start, len);
+      text[len] = '\0';
+      MacAddress mac;
+      if (parseMacAddress(text, mac)) {
+        if (add(mac)) {
+          added++;
+        }
+      } else {
+        Serial.printf("Ungültige MAC-Adresse im Filter ignoriert: %s\n", text);
+      }
+    }
+    if (comma < 0) {
+      break;
+    }
+    start = comma + 1;
+  }
+  return added;
+}
+
+void MacAllowlist::printTo(Print& out, size_t maxListed) const {
+  if (size() > maxListed) {
+    out.printf("(%u Adressen)", (unsigned)size());
+    return;
+  }
+  for (size_t i = 0; i < size(); i++) {
+    if (i > 0) {
+      out.print(",");
+    }
+    out.print(macToString(at(i)).text);
+  }
+}
+
+bool MacAllowlist::saveTo(Preferences& prefs, const char* key) const {
+  if (records.empty()) {
+    // NVS speichert keine leeren Blobs - Schlüssel entfernen
+    prefs.remove(key);
+    return true;
+  }
+  return prefs.putBytes(key, records.data(), records.size()) == records.size();
+}
+
+bool MacAllowlist::loadFrom(Preferences& prefs, const char* key) {
+  size_t length = prefs.getBytesLength(key);
+  if (length % RECORD_SIZE != 0 || length / RECORD_SIZE > maxEntryCount) {
+    return false;
+  }
+  std::vector<uint8_t> loaded(length);
+  if (length > 0 && prefs.getBytes(key, loaded.data(), length) != length) {
+    return false;
+  }
+  
+  // Sortierung prüfen, damit die Binärsuche auf beschädigten Daten nicht fehlschlägt
+  for (size_t i = RECORD_SIZE; i < length; i += RECORD_SIZE) {
+    if (memcmp(&loaded[i - RECORD_SIZE], &loaded[i], RECORD_SIZE) >= 0) {
+      return false;
+    }
+  }
+  records.swap(loaded);
+  return true;
+}
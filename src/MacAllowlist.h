@@ -0,0 +1,45 @@
+#ifndef MACALLOWLIST_H
+#define MACALLOWLIST_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <vector>
+#include "MacAddress.h"
+
+// Sorted set of 48-bit MAC addresses, stored as packed 6-byte big-endian
+// records. Byte order equals numeric order, so membership is a binary search
+// with memcmp, and the record array is persisted to NVS as-is in one blob.
+class MacAllowlist {
+public:
+  static constexpr size_t RECORD_SIZE = 6;
+
+  explicit MacAllowlist(size_t maxEntries);
+
+  bool contains(MacAddress mac) const;
+  bool add(MacAddress mac);     // false if already present or full
+  bool remove(MacAddress mac);  // false if not present
+  void clear();
+
+  size_t size() const { return records.size() / RECORD_SIZE; }
+  size_t maxEntries() const { return maxEntryCount; }
+  MacAddress at(size_t index) const;
+
+  // Adds every address of a comma-separated list, returns the number added
+  size_t parseList(const String& list);
+
+  // Prints the list comma-separated, or only the count above maxListed entries
+  void printTo(Print& out, size_t maxListed) const;
+
+  bool saveTo(Preferences& prefs, const char* key) const;
+  bool loadFrom(Preferences& prefs, const char* key);
+
+private:
+  // Index of the first record >= key
+  size_t lowerBound(const uint8_t* key) const;
+  static void pack(MacAddress mac, uint8_t* out);
+
+  std::vector<uint8_t> records;
+  size_t maxEntryCount;
+};
+
+#endif // MACALLOWLIST_H
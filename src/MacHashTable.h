@@ -0,0 +1,257 @@
+#ifndef MACHASHTABLE_H
+#define MACHASHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "MacAddress.h"
+
+// Fixed-capacity open-addressing hash table keyed by packed MAC address.
+//
+// All slots are allocated once in the constructor, lookups and inserts never
+// allocate. Keys live in their own array, so linear probing only touches
+// 8 bytes per slot. The slot count is a power of two with a load factor of
+// at most 3/4. Eviction policy: when maxEntries is reached, inserting a new
+// address evicts the entry with the oldest access stamp (least recently seen).
+// Entries for which the optional guard returns true are only evicted when no
+// unguarded entry is left.
+template <typename T>
+class MacHashTable {
+public:
+  typedef bool (*EvictionGuard)(MacAddress mac);
+
+  explicit MacHashTable(size_t capacity, EvictionGuard guard = nullptr);
+  ~MacHashTable();
+  MacHashTable(const MacHashTable&) = delete;
+  MacHashTable& operator=(const MacHashTable&) = delete;
+
+  // Returns nullptr if the address is not in the table
+  T* find(MacAddress mac);
+
+  // Returns the entry for mac, default-constructing it if needed. stamp is the
+  // access time (e.g. millis()) that LRU eviction compares.
+  T& findOrInsert(MacAddress mac, uint32_t stamp, bool* inserted = nullptr);
+
+  bool erase(MacAddress mac);
+  void clear();
+
+  // Calls f(MacAddress, T&) for every entry, in slot order
+  template <typename F>
+  void forEach(F&& f) {
+    for (size_t i = 0; i <= mask_; i++) {
+      if (keys_[i] != EMPTY) {
+        f(keys_[i], values_[i]);
+      }
+    }
+  }
+
+  // Lowers or raises the entry limit (at most capacity()), evicting least
+  // recently seen entries down to the new limit. Returns the number evicted.
+  size_t setMaxEntries(size_t maxEntries, uint32_t now);
+
+  size_t size() const { return size_; }
+  size_t maxEntries() const { return maxEntries_; }
+  size_t capacity() const { return capacity_; }
+  size_t slotCount() const { return mask_ + 1; }
+  uint32_t evictions() const { return evictions_; }
+  // Address removed by the most recent eviction (NO_MAC_ADDRESS if none yet)
+  MacAddress lastEvicted() const { return lastEvicted_; }
+
+private:
+  static constexpr MacAddress EMPTY = NO_MAC_ADDRESS;
+  static constexpr size_t NOT_FOUND = ~(size_t)0;
+
+  size_t homeSlot(MacAddress mac) const {
+    // Fibonacci hashing spreads vendor-prefix clusters over the table
+    return (size_t)((mac * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+  size_t findSlot(MacAddress mac) const;
+  void eraseSlot(size_t slot);
+  void evictOldest(uint32_t now);
+
+  MacAddress* keys_;
+  uint32_t* stamps_;
+  T* values_;
+  size_t mask_;
+  unsigned shift_;
+  size_t size_;
+  size_t capacity_;
+  size_t maxEntries_;
+  EvictionGuard guard_;
+  uint32_t evictions_;
+  MacAddress lastEvicted_;
+};
+
+template <typename T>
+MacHashTable<T>::MacHashTable(size_t capacity, EvictionGuard guard)
+  : size_(0), capacity_(capacity), maxEntries_(capacity), guard_(guard), evictions_(0),
+    lastEvicted_(NO_MAC_ADDRESS) {
+  if (capacity_ == 0) {
+    capacity_ = 1;
+    maxEntries_ = 1;
+  }
+  size_t slots = 2;
+  unsigned bits = 1;
+  while (slots < capacity_ + capacity_ / 3 + 1) {
+    slots <<= 1;
+    bits++;
+  }
+  mask_ = slots - 1;
+  shift_ = 64 - bits;
+  keys_ = new MacAddress[slots];
+  stamps_ = new uint32_t[slots];
+  values_ = new T[slots];
+  for (size_t i = 0; i < slots; i++) {
+    keys_[i] = EMPTY;
+    stamps_[i] = 0;
+  }
+}
+
+template <typename T>
+MacHashTable<T>::~MacHashTable() {
+  delete[] keys_;
+  delete[] stamps_;
+  delete[] values_;
+}
+
+template <typename T>
+size_t MacHashTable<T>::findSlot(MacAddress mac) const {
+  size_t i = homeSlot(mac);
+  while (keys_[i] != EMPTY) {
+    if (keys_[i] == mac) {
+      return i;
+    }
+    i = (i + 1) & mask_;
+  }
+  return NOT_FOUND;
+}
+
+template <typename T>
+T* MacHashTable<T>::find(MacAddress mac) {
+  size_t slot = findSlot(mac);
+  return slot == NOT_FOUND ? nullptr : &values_[slot];
+}
+
+template <typename T>
+T& MacHashTable<T>::findOrInsert(MacAddress mac, uint32_t stamp, bool* inserted) {
+  size_t i = homeSlot(mac);
+  while (keys_[i] != EMPTY) {
+    if (keys_[i] == mac) {
+      stamps_[i] = stamp;
+      if (inserted) *inserted = false;
+      return values_[i];
+    }
+    i = (i + 1) & mask_;
+  }
+
+  if (size_ >= maxEntries_) {
+    // Eviction may shift entries, so search the free slot again afterwards
+    evictOldest(stamp);
+    i = homeSlot(mac);
+    while (keys_[i] != EMPTY) {
+      i = (i + 1) & mask_;
+    }
+  }
+
+  keys_[i] = mac;
+  stamps_[i] = stamp;
+  values_[i] = T();
+  size_++;
+  if (inserted) *inserted = true;
+  return values_[i];
+}
+
+template <typename T>
+bool MacHashTable<T>::erase(MacAddress mac) {
+  size_t slot = findSlot(mac);
+  if (slot == NOT_FOUND) {
+    return false;
+  }
+  eraseSlot(slot);
+  return true;
+}
+
+template <typename T>
+size_t MacHashTable<T>::setMaxEntries(size_t maxEntries, uint32_t now) {
+  maxEntries_ = maxEntries == 0 ? 1 : (maxEntries > capacity_ ? capacity_ : maxEntries);
+  size_t evicted = 0;
+  while (size_ > maxEntries_) {
+    evictOldest(now);
+    evicted++;
+  }
+  return evicted;
+}
+
+template <typename T>
+void MacHashTable<T>::clear() {
+  for (size_t i = 0; i <= mask_; i++) {
+    if (keys_[i] != EMPTY) {
+      keys_[i] = EMPTY;
+      values_[i] = T();
+    }
+  }
+  size_ = 0;
+}
+
+template <typename T>
+void MacHashTable<T>::eraseSlot(size_t slot) {
+  // Backward-shift deletion keeps probe chains intact without tombstones
+  size_t hole = slot;
+  size_t j = slot;
+  while (true) {
+    j = (j + 1) & mask_;
+    if (keys_[j] == EMPTY) {
+      break;
+    }
+    size_t home = homeSlot(keys_[j]);
+    // The entry at j may move into the hole unless its home lies cyclically in (hole, j]
+    bool homeBetween = (hole <= j) ? (home > hole && home <= j) : (home > hole || home <= j);
+    if (!homeBetween) {
+      keys_[hole] = keys_[j];
+      stamps_[hole] = stamps_[j];
+      values_[hole] = std::move(values_[j]);
+      hole = j;
+    }
+  }
+  keys_[hole] = EMPTY;
+  values_[hole] = T();
+  size_--;
+}
+
+template <typename T>
+void MacHashTable<T>::evictOldest(uint32_t now) {
+  // Oldest unguarded entry, and the oldest overall as a fallback. The guard is
+  // only asked for entries that would beat the current unguarded candidate.
+  size_t oldest = NOT_FOUND;
+  uint32_t oldestAge = 0;
+  size_t oldestGuarded = NOT_FOUND;
+  uint32_t oldestGuardedAge = 0;
+  for (size_t i = 0; i <= mask_; i++) {
+    if (keys_[i] == EMPTY) {
+      continue;
+    }
+    uint32_t age = now - stamps_[i];
+    if (oldest != NOT_FOUND && age <= oldestAge) {
+      continue;
+    }
+    if (guard_ != nullptr && guard_(keys_[i])) {
+      if (oldestGuarded == NOT_FOUND || age > oldestGuardedAge) {
+        oldestGuarded = i;
+        oldestGuardedAge = age;
+      }
+      continue;
+    }
+    oldest = i;
+    oldestAge = age;
+  }
+  if (oldest == NOT_FOUND) {
+    oldest = oldestGuarded;
+  }
+  if (oldest != NOT_FOUND) {
+    lastEvicted_ = keys_[oldest];
+    eraseSlot(oldest);
+    evictions_++;
+  }
+}
+
+#endif // MACHASHTABLE_H
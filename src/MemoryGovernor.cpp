@@ -0,0 +1,99 @@
+#include "MemoryGovernor.h"
+#include "Config.h"
+#include "ConfigManager.h"
+#include "DeviceInfo.h"
+#include "BLEScanner.h"
+#include "BeaconTracker.h"
+#include "Stats.h"
+#include "Log.h"
+#include <atomic>
+
+// Von der Verarbeitungsstufe geschrieben, von loop() gelesen
+static std::atomic<int> pressure(MEMORY_NORMAL);
+static std::atomic<bool> scanReleasePending(false);
+
+// Nur aus der Verarbeitungsstufe
+static size_t pressureCap = 0;  // Obergrenze durch Speicherdruck, 0: keine
+static unsigned long lastCheck = 0;
+static uint32_t metadataSheds = 0;
+
+static void applyDeviceCap(unsigned long now) {
+  size_t cap = (size_t)ConfigManager::getMaxDevices();
+  if (pressureCap != 0 && pressureCap < cap) {
+    cap = pressureCap;
+  }
+  if (cap == deviceTable.maxEntries()) {
+    return;
+  }
+  size_t evicted = deviceTable.setMaxEntries(cap, now);
+  if (evicted > 0) {
+    noteDeviceEvictions(EVICT_CAP, evicted);
+    // Verdrängte Geräte aus dem Bereichsindex nehmen; Timer, Filterplätze
+    // und Namen holen sich die Besitzer beim nächsten Engpass zurück
+    rebuildInRangeIndex();
+    LOG_INFO(LOG_SCAN, "Geräteobergrenze %u: %u Geräte verdrängt", (unsigned)cap, (unsigned)evicted);
+  }
+}
+
+void runMemoryGovernor(unsigned long now) {
+  if (now - lastCheck < (unsigned long)MEMORY_CHECK_INTERVAL) {
+    return;
+  }
+  lastCheck = now;
+
+  uint32_t budget = (uint32_t)ConfigManager::getHeapBudget();
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t largestBlock = ESP.getMaxAllocHeap();
+  bool memoryShort = budget > 0 && (freeHeap < budget || largestBlock < HEAP_MIN_BLOCK);
+  bool relieved = budget == 0 || (freeHeap >= budget + budget / 4 && largestBlock >= HEAP_MIN_BLOCK);
+
+  int level = pressure.load(std::memory_order_relaxed);
+  if (memoryShort) {
+#if !STREAMING_SCAN
+    scanReleasePending.store(true, std::memory_order_relaxed);
+#endif
+    if (level == MEMORY_NORMAL) {
+      level = MEMORY_SHED_METADATA;
+      size_t dropped = dropUnlistedMetadata();
+      metadataSheds += dropped;
+      LOG_WARN(LOG_SCAN, "Heap knapp (%u frei, Block %u): Metadaten von %u Geräten verworfen",
+               (unsigned)freeHeap, (unsigned)largestBlock, (unsigned)dropped);
+    } else {
+      level = MEMORY_SHED_DEVICES;
+      size_t cap = pressureCap != 0 ? pressureCap : deviceTable.size();
+      cap -= cap / 4;
+      pressureCap = cap > (size_t)MIN_DEVICE_CAP ? cap : (size_t)MIN_DEVICE_CAP;
+      LOG_WARN(LOG_SCAN, "Heap weiter knapp (%u frei, Block %u): Obergrenze %u Geräte",
+               (unsigned)freeHeap, (unsigned)largestBlock, (unsigned)pressureCap);
+    }
+  } else if (relieved && level != MEMORY_NORMAL) {
+    level--;
+    if (level < MEMORY_SHED_DEVICES) {
+      pressureCap = 0;
+    }
+    LOG_INFO(LOG_SCAN, "Heap wieder ausreichend (%u frei), Stufe %d", (unsigned)freeHeap, level);
+  }
+  pressure.store(level, std::memory_order_relaxed);
+
+  applyDeviceCap(now);
+}
+
+MemoryPressure getMemoryPressure() {
+  return (MemoryPressure)pressure.load(std::memory_order_relaxed);
+}
+
+bool keepDeviceMetadata(MacAddress address) {
+  return getMemoryPressure() == MEMORY_NORMAL || isProtectedDevice(address);
+}
+
+bool takeScanResultRelease() {
+  return scanReleasePending.exchange(false, std::memory_order_relaxed);
+}
+
+uint32_t getMetadataSheds() {
+  return metadataSheds;
+}
+
+size_t getDeviceCap() {
+  return deviceTable.maxEntries();
+}
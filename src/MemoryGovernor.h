@@ -0,0 +1,50 @@
+#ifndef MEMORYGOVERNOR_H
+#define MEMORYGOVERNOR_H
+
+#include <Arduino.h>
+#include "MacAddress.h"
+
+// Speicherwächter: hält freien Heap und größten freien Block über dem Budget
+// (ConfigManager::getHeapBudget(), HEAP_MIN_BLOCK) und setzt die
+// Geräteobergrenze (ConfigManager::getMaxDevices()) in deviceTable durch.
+//
+// Gerätetabelle, Namensvorrat, Timer und Filterbank sind seit dem Start fest
+// belegt. Ohne STREAMING_SCAN wachsen dagegen NimBLEs Scan-Ergebnisse mit der
+// Zahl der Adressen (ein NimBLEAdvertisedDevice pro neuer Adresse im laufenden
+// Scan-Fenster); bei Speicherdruck endet dann immer auch das laufende Fenster
+// vorzeitig, damit NimBLE die Ergebnisse freigibt.
+//
+// Last wird in fester Reihenfolge abgebaut, eine Stufe pro Prüfung
+// (MEMORY_CHECK_INTERVAL), solange der Druck anhält:
+//  1. MEMORY_SHED_METADATA: Name und Service-UUID nur noch für Geräte aus
+//     filteredDevices; die der übrigen werden verworfen.
+//  2. MEMORY_SHED_DEVICES: die Geräteobergrenze sinkt bei jeder weiteren
+//     Prüfung um ein Viertel, höchstens bis MIN_DEVICE_CAP. Verdrängt werden
+//     die am längsten nicht gesehenen Geräte, solche aus filteredDevices zuletzt.
+// Liegt der Heap wieder ein Viertel über dem Budget, geht es Stufe für Stufe
+// zurück.
+
+enum MemoryPressure {
+  MEMORY_NORMAL = 0,
+  MEMORY_SHED_METADATA = 1,
+  MEMORY_SHED_DEVICES = 2
+};
+
+// Aus der Verarbeitungsstufe vor jedem Tracking-Durchlauf (unter DeviceDataLock);
+// prüft höchstens alle MEMORY_CHECK_INTERVAL. Eine geänderte max_devices greift
+// bei der nächsten Prüfung.
+void runMemoryGovernor(unsigned long now);
+
+MemoryPressure getMemoryPressure();
+// Name und Service-UUID für dieses Gerät speichern? Unter Speicherdruck nur
+// für Geräte aus filteredDevices und den verfolgten Beacon
+bool keepDeviceMetadata(MacAddress address);
+// true, wenn loop() das Scan-Fenster beenden soll, damit NimBLE seine
+// Ergebnisse freigibt (nie mit STREAMING_SCAN); setzt die Anforderung zurück
+bool takeScanResultRelease();
+
+// Telemetrie seit dem Start
+uint32_t getMetadataSheds();  // Geräte, deren Name bzw. UUID verworfen wurde
+size_t getDeviceCap();        // Aktuelle Obergrenze in deviceTable
+
+#endif // MEMORYGOVERNOR_H
@@ -1,92 +1,86 @@
 #include "MeshtasticComm.h"
 #include "Config.h"
-#include "JsonUtils.h"
 #include "ConfigManager.h"
+#include "Pipeline.h"
+#include "Log.h"
+#include "ReportBatch.h"
+#include "CommandReader.h"
 
 // UART für Meshtastic
 HardwareSerial MeshtasticSerial(1); // Use UART1
 
 void initMeshtasticComm() {
   // Initialisiere UART für Meshtastic-Kommunikation
+  initCommandReader(MeshtasticSerial);
   MeshtasticSerial.begin(UART_BAUD_RATE, SERIAL_8N1, UART_RX_PIN, UART_TX_PIN);
   Serial.println("Meshtastic UART initialized - ready to receive config commands");
   Serial.printf("Gateway ID: %s - Only processing commands with matching target field\n", GATEWAY_ID.c_str());
 }
 
-void sendBeaconToMeshtastic(const std::string& address, DeviceInfo& device, float lastSeenOverride) {
-  String json = generateBeaconJSON(address, device, lastSeenOverride);
+void sendBeaconToMeshtastic(MacAddress address, DeviceInfo& device, float lastSeenOverride) {
+  // Wird pro Sendefenster gesammelt und von flushBeaconReports() gesendet
+  queueBeaconReport(address, device, lastSeenOverride);
+}
+
+// Kurze Quittung an Meshtastic
+static void sendAcknowledgment(bool ok) {
+  char ack[64];
+  snprintf(ack, sizeof(ack), "{\"ack\":\"%s\",\"ok\":%s}", GATEWAY_ID.c_str(), ok ? "true" : "false");
+  MeshtasticSerial.println(ack);
+  LOG_DEBUG(LOG_UART, "Acknowledgment sent: %s", ack);
+}
+
+static void handleCommandLine(const CommandLine& line) {
+  LOG_INFO(LOG_UART, "Received from Meshtastic: %s", line.text);
   
-  // Debug-Ausgabe vor dem Senden
-  Serial.println("----------------------------------------");
-  Serial.println("UART-DEBUG: Sende Beacon-Daten an Meshtastic:");
-  Serial.println(json);
-  Serial.println("----------------------------------------");
+  // Extract JSON from the received data (Meshtastic may prefix the sender)
+  const char* jsonStart = strchr(line.text, '{');
+  const char* jsonEnd = strrchr(line.text, '}');
+  if (jsonStart == nullptr || jsonEnd == nullptr || jsonEnd < jsonStart) {
+    LOG_WARN(LOG_UART, "No valid JSON found in received data ('{' at %d, '}' at %d) - ignoring",
+             jsonStart ? (int)(jsonStart - line.text) : -1, jsonEnd ? (int)(jsonEnd - line.text) : -1);
+    return;
+  }
+  size_t jsonLength = jsonEnd - jsonStart + 1;
+  LOG_DEBUG(LOG_UART, "Extracted JSON: %.*s", (int)jsonLength, jsonStart);
   
-  // Sende über UART
-  MeshtasticSerial.println(json);
+  // Parse JSON to check target field properly
+  StaticJsonDocument<200> doc;
+  DeserializationError error = deserializeJson(doc, jsonStart, jsonLength);
+  if (error || !doc.containsKey("target")) {
+    LOG_WARN(LOG_UART, "JSON parsing failed or no target field found - ignoring");
+    return;
+  }
   
-  // Debug-Bestätigung
-  Serial.println("UART-DEBUG: Daten gesendet!");
+  const char* targetGateway = doc["target"].as<const char*>();
+  if (targetGateway == nullptr || strcmp(targetGateway, GATEWAY_ID.c_str()) != 0) {
+    LOG_INFO(LOG_UART, "Message not for this gateway (%s) - target: %s", GATEWAY_ID.c_str(),
+             targetGateway ? targetGateway : "null");
+    return;
+  }
+  LOG_DEBUG(LOG_UART, "Message for this gateway (%s) - processing", GATEWAY_ID.c_str());
+  
+  bool success;
+  {
+    // Konfiguration und Filterliste werden auch von der Verarbeitungsstufe gelesen
+    DeviceDataLock lock;
+    success = ConfigManager::processConfigCommand(jsonStart, jsonLength);
+  }
+  
+  if (success) {
+    LOG_INFO(LOG_CONFIG, "Configuration updated successfully");
+  } else {
+    LOG_WARN(LOG_CONFIG, "Configuration update failed");
+  }
+  sendAcknowledgment(success);
 }
 
 void checkForMeshtasticCommands() {
-  if (MeshtasticSerial.available()) {
-    String receivedData = MeshtasticSerial.readStringUntil('\n');
-    receivedData.trim(); // Remove whitespace and newlines
-    
-    if (receivedData.length() > 0) {
-      Serial.println("========================================");
-      Serial.println("UART-DEBUG: Received from Meshtastic:");
-      Serial.println(receivedData);
-      Serial.println("========================================");
-      
-      // Extract JSON from the received data
-      String jsonData = "";
-      int jsonStart = receivedData.indexOf('{');
-      int jsonEnd = receivedData.lastIndexOf('}');
-      
-      if (jsonStart >= 0 && jsonEnd > jsonStart) {
-        jsonData = receivedData.substring(jsonStart, jsonEnd + 1);
-        Serial.println("UART-DEBUG: Extracted JSON: " + jsonData);
-        
-        // Parse JSON to check target field properly
-        StaticJsonDocument<200> doc;
-        DeserializationError error = deserializeJson(doc, jsonData);
-        
-        if (!error && doc.containsKey("target")) {
-          String targetGateway = doc["target"].as<String>();
-          
-          if (targetGateway == GATEWAY_ID) {
-            Serial.println("UART-DEBUG: Message for this gateway (" + String(GATEWAY_ID) + ") - processing...");
-            
-            bool success = ConfigManager::processConfigCommand(jsonData);
-            
-            if (success) {
-              Serial.println("UART-DEBUG: Configuration updated successfully!");
-              
-              // Send short acknowledgment back to Meshtastic
-              String ack = "{\"ack\":\"" + String(GATEWAY_ID) + "\",\"ok\":true}";
-              MeshtasticSerial.println(ack);
-              Serial.println("UART-DEBUG: Acknowledgment sent: " + ack);
-              
-            } else {
-              Serial.println("UART-DEBUG: Configuration update failed!");
-              
-              // Send short error acknowledgment
-              String error = "{\"ack\":\"" + String(GATEWAY_ID) + "\",\"ok\":false}";
-              MeshtasticSerial.println(error);
-              Serial.println("UART-DEBUG: Error response sent: " + error);
-            }
-          } else {
-            Serial.println("UART-DEBUG: Message not for this gateway (" + String(GATEWAY_ID) + ") - target: " + targetGateway);
-          }
-        } else {
-          Serial.println("UART-DEBUG: JSON parsing failed or no target field found - ignoring");
-        }
-      } else {
-        Serial.println("UART-DEBUG: No valid JSON found in received data - ignoring");
-        Serial.println("UART-DEBUG: Looking for '{' at position " + String(jsonStart) + " and '}' at position " + String(jsonEnd));
-      }
-    }
+  // Nur fertige Zeilen; eine halbe Zeile wartet im CommandReader
+  pollCommandReader();
+  
+  CommandLine line;
+  while (takeCommandLine(line)) {
+    handleCommandLine(line);
   }
-}
\ No newline at end of file
+}
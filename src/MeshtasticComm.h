@@ -6,13 +6,16 @@
 #include <string>
 #include "DeviceInfo.h"
 
+// UART zum Meshtastic-Gerät
+extern HardwareSerial MeshtasticSerial;
+
 // Initialisiere die UART-Kommunikation für Meshtastic
 void initMeshtasticComm();
 
-// Sende Beacon-Daten an Meshtastic
-void sendBeaconToMeshtastic(const std::string& address, DeviceInfo& device, float lastSeenOverride = -1);
+// Sende Beacon-Daten an Meshtastic (gesammelt pro Sendefenster, siehe ReportBatch.h)
+void sendBeaconToMeshtastic(MacAddress address, DeviceInfo& device, float lastSeenOverride = -1);
 
-// Prüfe auf eingehende Konfigurationsbefehle von Meshtastic
+// Verarbeitet vollständig empfangene Konfigurationsbefehle von Meshtastic (wartet nie auf den UART)
 void checkForMeshtasticCommands();
 
 #endif // MESHTASTICCOMM_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "NamePool.h"
+#include <cstring>
+
+// FNV-1a, nie 0 (0 markiert freie Einträge)
+static uint32_t nameHash(const char* name, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+  }
+  return hash != 0 ? hash : 1;
+}
+
+static size_t boundedLength(const char* name) {
+  size_t length = 0;
+  while (length < NamePool::MAX_NAME_LENGTH && name[length] != '\0') {
+    length++;
+  }
+  return length;
+}
+
+NamePool::NamePool(size_t capacity) :
+  entries_(new Entry[capacity]),
+  capacity_(capacity < NO_NAME ? capacity : NO_NAME),
+  size_(0),
+  rejected_(0) {
+  for (size_t i = 0; i < capacity_; i++) {
+    entries_[i].hash = 0;
+    entries_[i].marked = false;
+    entries_[i].text[0] = '\0';
+  }
+}
+
+NamePool::~NamePool() {
+  delete[] entries_;
+}
+
+uint16_t NamePool::intern(const char* name) {
+  size_t length = boundedLength(name);
+  uint32_t hash = nameHash(name, length);
+
+  size_t freeEntry = capacity_;
+  for (size_t i = 0; i < capacity_; i++) {
+    const Entry& entry = entries_[i];
+    if (entry.hash == hash && strncmp(entry.text, name, length) == 0 && entry.text[length] == '\0') {
+      return (uint16_t)i;
+    }
+    if (entry.hash == 0 && freeEntry == capacity_) {
+      freeEntry = i;
+    }
+  }
+  if (freeEntry == capacity_) {
+    rejected_++;
+    return NO_NAME;
+  }
+
+  Entry& entry = entries_[freeEntry];
+  memcpy(entry.text, name, length);
+  entry.text[length] = '\0';
+  entry.hash = hash;
+  size_++;
+  return (uint16_t)freeEntry;
+}
+
+const char* NamePool::get(uint16_t id) const {
+  if (id >= capacity_ || entries_[id].hash == 0) {
+    return nullptr;
+  }
+  return entries_[id].text;
+}
+
+bool NamePool::equals(uint16_t id, const char* name) const {
+  const char* text = get(id);
+  if (text == nullptr) {
+    return false;
+  }
+  size_t length = boundedLength(name);
+  return strncmp(text, name, length) == 0 && text[length] == '\0';
+}
+
+void NamePool::beginCollect() {
+  for (size_t i = 0; i < capacity_; i++) {
+    entries_[i].marked = false;
+  }
+}
+
+size_t NamePool::sweep() {
+  size_t freed = 0;
+  for (size_t i = 0; i < capacity_; i++) {
+    if (entries_[i].hash != 0 && !entries_[i].marked) {
+      entries_[i].hash = 0;
+      entries_[i].text[0] = '\0';
+      freed++;
+    }
+  }
+  size_ -= freed;
+  return freed;
+}
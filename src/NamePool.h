@@ -0,0 +1,62 @@
+#ifndef NAMEPOOL_H
+#define NAMEPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Begrenzter Vorrat an Gerätenamen. Geräte speichern nur die Nummer eines
+// Eintrags; gleiche Namen teilen sich einen Eintrag.
+//
+// Einträge werden nicht gezählt. Ist der Vorrat voll, gibt sweep() alle
+// Einträge frei, die der Aufrufer nicht mehr als benutzt markiert (z.B. die
+// Namen verdrängter Geräte). Passt ein Name danach immer noch nicht, liefert
+// intern() NO_NAME und das Gerät bleibt ohne Namen.
+class NamePool {
+public:
+  static constexpr uint16_t NO_NAME = 0xFFFF;
+  static constexpr size_t MAX_NAME_LENGTH = 31;  // BLE-Namen passen in ein Advertisement, also höchstens 29 Zeichen
+
+  explicit NamePool(size_t capacity);
+  ~NamePool();
+  NamePool(const NamePool&) = delete;
+  NamePool& operator=(const NamePool&) = delete;
+
+  // Nummer des Eintrags für name (längere Namen werden abgeschnitten),
+  // NO_NAME, wenn kein Platz frei ist
+  uint16_t intern(const char* name);
+  // nullptr für NO_NAME oder einen freigegebenen Eintrag
+  const char* get(uint16_t id) const;
+  // true, wenn id genau diesen Namen enthält (vergleicht nur diesen einen Eintrag)
+  bool equals(uint16_t id, const char* name) const;
+
+  // Aufräumen in drei Schritten: beginCollect(), dann mark(id) für jeden noch
+  // benutzten Eintrag, dann sweep(). sweep() gibt alle nicht markierten
+  // Einträge frei und liefert deren Anzahl.
+  void beginCollect();
+  void mark(uint16_t id) {
+    if (id < capacity_) {
+      entries_[id].marked = true;
+    }
+  }
+  size_t sweep();
+
+  size_t size() const { return size_; }
+  bool full() const { return size_ == capacity_; }
+  size_t capacity() const { return capacity_; }
+  size_t bytes() const { return capacity_ * sizeof(Entry); }
+  uint32_t rejected() const { return rejected_; }  // intern()-Aufrufe ohne freien Platz
+
+private:
+  struct Entry {
+    uint32_t hash;  // 0: frei
+    bool marked;
+    char text[MAX_NAME_LENGTH + 1];
+  };
+
+  Entry* entries_;
+  size_t capacity_;
+  size_t size_;
+  uint32_t rejected_;
+};
+
+#endif // NAMEPOOL_H
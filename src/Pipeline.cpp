@@ -0,0 +1,129 @@
+#include "Pipeline.h"
+#include "Config.h"
+#include "BLEScanner.h"
+#include "BeaconTracker.h"
+#include "MeshtasticComm.h"
+#include "ReportBatch.h"
+#include "AdaptiveScan.h"
+#include "Log.h"
+#include "Stats.h"
+#include "MemoryGovernor.h"
+
+static SemaphoreHandle_t deviceDataMutex = nullptr;
+static TaskHandle_t processingTask = nullptr;
+static TaskHandle_t loopTask = nullptr;
+static SpscRing<OutputLine, OUTPUT_QUEUE_LENGTH> outputRing;
+static unsigned long lastTrackingRun = 0;
+
+#if PIPELINE_USE_TASK
+static void processingTaskMain(void* parameter) {
+  (void)parameter;
+  while (true) {
+    // Aufwachen bei neuen Advertisements, spätestens zum nächsten Tracking-Termin
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TRACKING_INTERVAL / 4));
+    runProcessingStage();
+  }
+}
+#endif
+
+void initPipeline() {
+  deviceDataMutex = xSemaphoreCreateRecursiveMutex();
+  lastTrackingRun = millis();
+  // setup() läuft im Task von loop()
+  loopTask = xTaskGetCurrentTaskHandle();
+  
+#if PIPELINE_USE_TASK
+  if (bleScanner.isContinuous()) {
+    xTaskCreatePinnedToCore(processingTaskMain, "ble_processing", PROCESSING_TASK_STACK, nullptr,
+                            PROCESSING_TASK_PRIORITY, &processingTask, PROCESSING_CORE);
+    Serial.printf("Verarbeitungs-Task auf Kern %d gestartet\n", PROCESSING_CORE);
+  }
+#endif
+}
+
+void notifyProcessingStage() {
+  if (processingTask != nullptr) {
+    xTaskNotifyGive(processingTask);
+  } else {
+    // Ohne eigenen Task verarbeitet loop() die Advertisements
+    notifyLoop();
+  }
+}
+
+void notifyLoop() {
+  if (loopTask != nullptr) {
+    xTaskNotifyGive(loopTask);
+  }
+}
+
+void waitForLoopWork(uint32_t timeoutMs) {
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+}
+
+void runProcessingStage() {
+  DeviceDataLock lock;
+  
+  bleScanner.processEvents();
+  
+  if (millis() - lastTrackingRun >= TRACKING_INTERVAL) {
+    lastTrackingRun = millis();
+    runMemoryGovernor(millis());
+    flushFilterBank();
+    countDevicesInRange();
+    findAndTrackClosestBeacon();
+    if (isTrackingBeacon()) {
+      noteTrackedBeacon(millis());
+    }
+  }
+  
+  // Gesammelte Beacon-Meldungen, sobald das Sendefenster es erlaubt
+  flushBeaconReports(millis());
+}
+
+bool queueOutputLine(const char* text, size_t length, unsigned long advertisedAt) {
+  OutputLine out;
+  if (length >= sizeof(out.text)) {
+    LOG_ERROR(LOG_UART, "Ausgabezeile zu lang (%u Zeichen), verworfen", (unsigned)length);
+    return false;
+  }
+  out.length = length;
+  out.advertisedAt = advertisedAt;
+  memcpy(out.text, text, out.length);
+  out.text[out.length] = '\0';
+  if (!outputRing.push(out)) {
+    return false;
+  }
+  notifyLoop();
+  return true;
+}
+
+int runOutputStage() {
+  int sent = 0;
+  OutputLine out;
+  while (outputRing.pop(out)) {
+    unsigned long started = micros();
+    MeshtasticSerial.println(out.text);
+    recordStat(STATS_UART_TX, micros() - started);
+    if (out.advertisedAt != NO_ADVERTISEMENT_TIME) {
+      recordStat(STATS_REPORT_LATENCY, millis() - out.advertisedAt);
+    }
+    sent++;
+  }
+  return sent;
+}
+
+uint32_t getDroppedOutputLines() {
+  return outputRing.dropped();
+}
+
+void lockDeviceData() {
+  if (deviceDataMutex != nullptr) {
+    xSemaphoreTakeRecursive(deviceDataMutex, portMAX_DELAY);
+  }
+}
+
+void unlockDeviceData() {
+  if (deviceDataMutex != nullptr) {
+    xSemaphoreGiveRecursive(deviceDataMutex);
+  }
+}
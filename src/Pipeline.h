@@ -0,0 +1,63 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <Arduino.h>
+#include "SpscRing.h"
+
+// Dreistufige Verarbeitung im Dauerscan:
+//  1. NimBLE-Callback (Host-Task, Kern 0): kopiert nur ein AdvertisementEvent
+//     in den lock-freien Ring von BLEScanner
+//  2. Verarbeitungs-Task (PROCESSING_CORE): Filter, Distanz, Kalman,
+//     Gerätetabelle und Beacon-Tracking
+//  3. Ausgabe in loop(): fertige Meldungen per UART senden, Kommandos,
+//     Statusausgaben
+//
+// Ohne eigenen Task (PIPELINE_USE_TASK 0, z.B. Host-Build) ruft loop() die
+// Verarbeitungsstufe direkt auf - der Ablauf bleibt dann deterministisch.
+#ifndef PIPELINE_USE_TASK
+#define PIPELINE_USE_TASK 1
+#endif
+
+// Fertig formatierte Zeile für die Ausgabestufe
+struct OutputLine {
+  uint16_t length;
+  unsigned long advertisedAt;  // millis() des ältesten gemeldeten Advertisements, NO_ADVERTISEMENT_TIME: keins
+  char text[190];
+};
+static constexpr unsigned long NO_ADVERTISEMENT_TIME = ~0UL;
+
+void initPipeline();
+
+// Weckt die Verarbeitungsstufe (aus dem BLE-Callback)
+void notifyProcessingStage();
+
+// Weckt loop() (Scan-Fenster beendet, Ausgabezeile oder Befehl wartet)
+void notifyLoop();
+// Blockiert loop() bis zu notifyLoop(), höchstens timeoutMs; gibt die Zeit
+// damit an die übrigen Tasks auf diesem Kern ab, statt zu pollen
+void waitForLoopWork(uint32_t timeoutMs);
+
+// Eine Runde der Verarbeitungsstufe: Ring leeren, bei Bedarf Tracking
+void runProcessingStage();
+
+// Ausgabestufe: legt eine Zeile für den UART ab (aus der Verarbeitungsstufe
+// oder wie die Befehle unter DeviceDataLock, damit der Ring nur einen
+// Schreiber zur Zeit hat)
+bool queueOutputLine(const char* text, size_t length, unsigned long advertisedAt = NO_ADVERTISEMENT_TIME);
+// Sendet alle wartenden Zeilen, gibt deren Anzahl zurück
+int runOutputStage();
+uint32_t getDroppedOutputLines();
+
+// Schützt deviceTable, Tracking-Zustand und Filterliste zwischen den Tasks
+void lockDeviceData();
+void unlockDeviceData();
+
+class DeviceDataLock {
+public:
+  DeviceDataLock() { lockDeviceData(); }
+  ~DeviceDataLock() { unlockDeviceData(); }
+  DeviceDataLock(const DeviceDataLock&) = delete;
+  DeviceDataLock& operator=(const DeviceDataLock&) = delete;
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,116 @@
+#include "ReportBatch.h"
+#include "Config.h"
+#include "ConfigManager.h"
+#include "JsonUtils.h"
+#include "BinaryUplink.h"
+#include "Pipeline.h"
+#include "Log.h"
+#include "Stats.h"
+
+static BeaconReport pendingReports[REPORT_BATCH_CAPACITY];
+static size_t pendingCount = 0;
+static bool hasSent = false;
+static unsigned long lastSendTime = 0;
+
+static uint32_t queuedReports = 0;
+static uint32_t coalescedReports = 0;
+static uint32_t sentMessages = 0;
+
+static size_t formatReports(char* line, size_t size, const BeaconReport* reports, size_t count) {
+  if (ConfigManager::getUplinkFormat() == UPLINK_BINARY) {
+    return generateBeaconFrameText(line, size, reports, count);
+  }
+  return generateBeaconReportsJSON(line, size, reports, count);
+}
+
+// Sendet alle wartenden Meldungen, so viele pro Nachricht, wie in eine Zeile passen
+static int sendPendingReports(unsigned long now) {
+  char line[sizeof(OutputLine::text)];
+  int messages = 0;
+
+  size_t first = 0;
+  while (first < pendingCount) {
+    size_t count = pendingCount - first;
+    unsigned long started = micros();
+    size_t length = formatReports(line, sizeof(line), &pendingReports[first], count);
+    while (length >= sizeof(line) && count > 1) {
+      count--;
+      length = formatReports(line, sizeof(line), &pendingReports[first], count);
+    }
+    recordStat(STATS_REPORT_FORMAT, micros() - started);
+
+    // Latenz ab dem ältesten Advertisement, das als anwesend gemeldet wird
+    unsigned long advertisedAt = NO_ADVERTISEMENT_TIME;
+    for (size_t i = first; i < first + count; i++) {
+      const BeaconReport& report = pendingReports[i];
+      if (report.presence.present &&
+          (advertisedAt == NO_ADVERTISEMENT_TIME || (long)(report.seenAt - advertisedAt) < 0)) {
+        advertisedAt = report.seenAt;
+      }
+    }
+
+    // An die Ausgabestufe übergeben, die den UART bedient
+    if (queueOutputLine(line, length, advertisedAt)) {
+      LOG_INFO(LOG_UART, "Sende Beacon-Daten an Meshtastic (%u): %s", (unsigned)count, line);
+    } else {
+      LOG_WARN(LOG_UART, "Meldung verworfen: %s", line);
+    }
+    sentMessages++;
+    messages++;
+    first += count;
+  }
+
+  pendingCount = 0;
+  hasSent = true;
+  lastSendTime = now;
+  return messages;
+}
+
+void queueBeaconReport(MacAddress address, const DeviceInfo& device, float lastSeenOverride) {
+  BeaconReport report = makeBeaconReport(address, device, lastSeenOverride);
+  queuedReports++;
+
+  // Eine neuere Meldung für denselben Beacon ersetzt die wartende
+  for (size_t i = 0; i < pendingCount; i++) {
+    if (pendingReports[i].address == address) {
+      pendingReports[i] = report;
+      coalescedReports++;
+      LOG_DEBUG(LOG_UART, "Meldung für %s ersetzt die wartende", macToString(address).text);
+      return;
+    }
+  }
+
+  if (pendingCount == REPORT_BATCH_CAPACITY) {
+    sendPendingReports(millis());
+  }
+  pendingReports[pendingCount++] = report;
+  LOG_DEBUG(LOG_UART, "Meldung für %s gesammelt (%u wartend)", macToString(address).text, (unsigned)pendingCount);
+}
+
+int flushBeaconReports(unsigned long now) {
+  if (pendingCount == 0) {
+    return 0;
+  }
+  if (hasSent && now - lastSendTime < (unsigned long)ConfigManager::getBatchWindow()) {
+    return 0;
+  }
+  return sendPendingReports(now);
+}
+
+uint32_t getQueuedBeaconReports() {
+  return queuedReports;
+}
+
+uint32_t getCoalescedBeaconReports() {
+  return coalescedReports;
+}
+
+uint32_t getSentReportMessages() {
+  return sentMessages;
+}
+
+uint32_t getSavedReportMessages() {
+  // Wartende Meldungen zählen erst, wenn sie gesendet sind
+  uint32_t handled = queuedReports - (uint32_t)pendingCount;
+  return handled > sentMessages ? handled - sentMessages : 0;
+}
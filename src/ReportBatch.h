@@ -0,0 +1,33 @@
+#ifndef REPORTBATCH_H
+#define REPORTBATCH_H
+
+#include <Arduino.h>
+#include "DeviceInfo.h"
+
+// Sammelt Beacon-Meldungen an Meshtastic pro Sendefenster.
+//
+// Zwei Meldungen verlassen das Gateway frühestens im Abstand des Sendefensters
+// (ConfigManager::getBatchWindow()). Was dazwischen anfällt, wird gesammelt:
+// eine neuere Meldung für denselben Beacon ersetzt die ältere (z.B. "neuer
+// nächster Beacon" und gleich danach "verschwunden"), alle übrigen gehen
+// zusammen als eine Nachricht hinaus - als JSON-Array bzw. Binärrahmen
+// Version 2. Eine einzelne Meldung sieht aus wie bisher. Nach längerer Ruhe
+// geht die erste Meldung sofort hinaus; Meldungen aus demselben
+// Tracking-Durchlauf landen trotzdem in einer Nachricht.
+//
+// Alle Funktionen laufen in der Verarbeitungsstufe (unter DeviceDataLock).
+
+// Legt eine Meldung ab; ist der Puffer voll, wird sofort gesendet
+void queueBeaconReport(MacAddress address, const DeviceInfo& device, float lastSeenOverride);
+
+// Übergibt gesammelte Meldungen der Ausgabestufe, sobald das Sendefenster
+// abgelaufen ist. Gibt die Anzahl der erzeugten Nachrichten zurück.
+int flushBeaconReports(unsigned long now);
+
+// Zähler seit dem Start
+uint32_t getQueuedBeaconReports();     // Abgelegte Meldungen
+uint32_t getCoalescedBeaconReports();  // Durch eine neuere für denselben Beacon ersetzt
+uint32_t getSentReportMessages();      // Erzeugte Nachrichten
+uint32_t getSavedReportMessages();     // Nachrichten, die ohne Sammeln mehr gesendet worden wären
+
+#endif // REPORTBATCH_H
@@ -0,0 +1,65 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer ring buffer with a fixed number
+// of slots (power of two). push() must only be called from one task and
+// pop() only from one other task. A full ring drops the new item and counts
+// it instead of blocking the producer.
+template <typename T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+  SpscRing() : head(0), tail(0), droppedCount(0), highWater(0) {}
+
+  bool push(const T& item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    uint32_t used = h - t;
+    if (used >= N) {
+      droppedCount.store(droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    items[h & (N - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    if (used + 1 > highWater.load(std::memory_order_relaxed)) {
+      highWater.store(used + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  bool pop(T& item) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (h == t) {
+      return false;
+    }
+    item = items[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+  static constexpr size_t capacity() { return N; }
+
+  // Statistics, readable from any task
+  uint32_t pushed() const { return head.load(std::memory_order_relaxed); }
+  uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+  uint32_t maxFill() const { return highWater.load(std::memory_order_relaxed); }
+
+private:
+  // Producer and consumer indices on separate cache lines
+  alignas(64) std::atomic<uint32_t> head;
+  alignas(64) std::atomic<uint32_t> tail;
+  alignas(64) std::atomic<uint32_t> droppedCount;
+  std::atomic<uint32_t> highWater;
+  T items[N];
+};
+
+#endif // SPSCRING_H
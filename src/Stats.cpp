@@ -0,0 +1,125 @@
+#include "Stats.h"
+#include "Config.h"
+#include "JsonWriter.h"
+#include <atomic>
+
+static LatencyHistogram histograms[STATS_HISTOGRAM_COUNT];
+
+// Vom BLE-Callback bzw. der Verarbeitungsstufe geschrieben
+static std::atomic<uint32_t> receivedAdvertisements(0);
+static std::atomic<uint32_t> filteredOutAdvertisements(0);
+
+static uint32_t deviceEvictions[DEVICE_EVICTION_COUNT];
+
+// Ein Schreiber: Laden und Speichern statt Read-Modify-Write
+void LatencyHistogram::record(uint32_t value) {
+  int bucket = value == 0 ? 0 : 32 - __builtin_clz(value);
+  counts_[bucket].store(counts_[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::clear() {
+  for (int bucket = 0; bucket < BUCKETS; bucket++) {
+    counts_[bucket].store(0, std::memory_order_relaxed);
+  }
+  max_.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+  Snapshot copy;
+  copy.count = 0;
+  for (int bucket = 0; bucket < BUCKETS; bucket++) {
+    copy.counts[bucket] = counts_[bucket].load(std::memory_order_relaxed);
+    copy.count += copy.counts[bucket];
+  }
+  copy.max = max_.load(std::memory_order_relaxed);
+  return copy;
+}
+
+uint32_t LatencyHistogram::Snapshot::percentile(uint32_t perMille) const {
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t rank = ((uint64_t)count * perMille + 999) / 1000;
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint64_t seen = 0;
+  for (int bucket = 0; bucket < BUCKETS; bucket++) {
+    seen += counts[bucket];
+    if (seen >= rank) {
+      uint32_t upper = bucket == 0 ? 0 : (uint32_t)((1ULL << bucket) - 1);
+      return upper < max ? upper : max;
+    }
+  }
+  return max;
+}
+
+void recordStat(StatsHistogram histogram, uint32_t value) {
+  histograms[histogram].record(value);
+}
+
+LatencyHistogram::Snapshot getStatSnapshot(StatsHistogram histogram) {
+  return histograms[histogram].snapshot();
+}
+
+void noteAdvertisementReceived() {
+  receivedAdvertisements.fetch_add(1, std::memory_order_relaxed);
+}
+
+void noteAdvertisementFilteredOut() {
+  filteredOutAdvertisements.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t getReceivedAdvertisements() {
+  return receivedAdvertisements.load(std::memory_order_relaxed);
+}
+
+uint32_t getFilteredOutAdvertisements() {
+  return filteredOutAdvertisements.load(std::memory_order_relaxed);
+}
+
+void noteDeviceEvictions(DeviceEviction reason, uint32_t count) {
+  deviceEvictions[reason] += count;
+}
+
+uint32_t getDeviceEvictions(DeviceEviction reason) {
+  return deviceEvictions[reason];
+}
+
+// "key":[p50,p99,max]
+template <size_t N>
+static void writeHistogram(JsonWriter& writer, const char (&key)[N], StatsHistogram histogram) {
+  LatencyHistogram::Snapshot h = histograms[histogram].snapshot();
+  writer.literal(",").literal(key).literal(":[");
+  writer.integer((long)h.percentile(500)).raw(',');
+  writer.integer((long)h.percentile(990)).raw(',');
+  writer.integer((long)h.max).raw(']');
+}
+
+size_t generateStatsJSON(char* buffer, size_t size, int part) {
+  JsonWriter writer(buffer, size);
+  writer.literal("{\"stats\":").string(GATEWAY_ID.c_str());
+  if (part == 0) {
+    writer.literal(",\"up\":").integer((long)(millis() / 1000));
+    writer.literal(",\"rx\":").integer((long)getReceivedAdvertisements());
+    writer.literal(",\"out\":").integer((long)getFilteredOutAdvertisements());
+    writer.literal(",\"heap\":").integer((long)ESP.getFreeHeap());
+    writer.literal(",\"blk\":").integer((long)ESP.getMaxAllocHeap());
+    writer.literal(",\"ev\":[").integer((long)deviceEvictions[EVICT_TABLE_FULL]).raw(',');
+    writer.integer((long)deviceEvictions[EVICT_IDLE]).raw(',');
+    writer.integer((long)deviceEvictions[EVICT_CAP]).raw(']');
+  } else if (part == 1) {
+    writeHistogram(writer, "\"loop\"", STATS_LOOP);
+    writeHistogram(writer, "\"scan\"", STATS_SCAN);
+    writeHistogram(writer, "\"track\"", STATS_TRACKING);
+  } else {
+    writeHistogram(writer, "\"fmt\"", STATS_REPORT_FORMAT);
+    writeHistogram(writer, "\"tx\"", STATS_UART_TX);
+    writeHistogram(writer, "\"lat\"", STATS_REPORT_LATENCY);
+  }
+  writer.literal("}");
+  return writer.length();
+}
@@ -0,0 +1,85 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Laufzeitstatistik mit festem Speicher: Zähler und Histogramme mit
+// logarithmischen Klassen für Dauern und Latenzen. Abfrage über Meshtastic
+// mit {"target":"<GATEWAY_ID>","stats":true}, siehe generateStatsJSON().
+//
+// Jedes Histogramm hat genau einen Schreiber: einen Task oder alles, was unter
+// DeviceDataLock läuft. Gelesen wird nur über snapshot(), aus jedem Task.
+
+// Histogramm über Zweierpotenzen: Klasse k zählt Werte mit k signifikanten
+// Bits (0, 1, 2-3, 4-7, ...). 33 Klassen decken den ganzen uint32_t ab,
+// Quantile sind also auf einen Faktor 2 genau.
+class LatencyHistogram {
+public:
+  static constexpr int BUCKETS = 33;
+
+  // Kopie zum Auswerten; count ist die Summe der kopierten Klassen
+  struct Snapshot {
+    uint32_t counts[BUCKETS];
+    uint32_t count;
+    uint32_t max;
+
+    // Obergrenze der Klasse mit dem perMille-Quantil, höchstens max
+    uint32_t percentile(uint32_t perMille) const;
+  };
+
+  LatencyHistogram() { clear(); }
+
+  // Nur vom Schreiber des Histogramms
+  void record(uint32_t value);
+  void clear();
+
+  // Aus jedem Task; Werte, die der Schreiber gerade einträgt, fehlen
+  // höchstens, zerrissen wird nichts
+  Snapshot snapshot() const;
+
+private:
+  std::atomic<uint32_t> counts_[BUCKETS];
+  std::atomic<uint32_t> max_;
+};
+
+enum StatsHistogram {
+  STATS_LOOP = 0,        // Ein Durchlauf von loop(), µs
+  STATS_SCAN,            // Ein Scan-Fenster bzw. blockierender Scan, ms
+  STATS_TRACKING,        // findAndTrackClosestBeacon(), µs
+  STATS_REPORT_FORMAT,   // Beacon-Meldung als JSON bzw. Binärrahmen formatieren, µs
+  STATS_UART_TX,         // Eine Zeile an Meshtastic schreiben, µs
+  STATS_REPORT_LATENCY,  // Advertisement bis zur Meldung am UART, ms
+  STATS_HISTOGRAM_COUNT
+};
+
+void recordStat(StatsHistogram histogram, uint32_t value);
+LatencyHistogram::Snapshot getStatSnapshot(StatsHistogram histogram);
+
+// Advertisements aus onResult bzw. vom MAC-Filter verworfen; aus jedem Task aufrufbar
+void noteAdvertisementReceived();
+void noteAdvertisementFilteredOut();
+uint32_t getReceivedAdvertisements();
+uint32_t getFilteredOutAdvertisements();
+
+// Aus deviceTable gelöschte Geräte nach Grund (nur unter DeviceDataLock)
+enum DeviceEviction {
+  EVICT_TABLE_FULL = 0,  // Tabelle voll, neues Gerät verdrängt das älteste
+  EVICT_IDLE,            // DEVICE_IDLE_EVICT_MS nicht gesehen
+  EVICT_CAP,             // Obergrenze gesenkt (max_devices, Speicherwächter)
+  DEVICE_EVICTION_COUNT
+};
+
+void noteDeviceEvictions(DeviceEviction reason, uint32_t count = 1);
+uint32_t getDeviceEvictions(DeviceEviction reason);
+
+// Kompakte Momentaufnahme für Meshtastic in STATS_JSON_PARTS Zeilen, jede
+// auch mit zehnstelligen Werten kürzer als eine Ausgabezeile (OutputLine):
+// 0: {"stats":"<GATEWAY_ID>","up":s,"rx":n,"out":n,"heap":B,"blk":B,"ev":[voll,inaktiv,grenze]}
+// 1: {"stats":"<GATEWAY_ID>","loop":[p50,p99,max],"scan":[...],"track":[...]}
+// 2: {"stats":"<GATEWAY_ID>","fmt":[...],"tx":[...],"lat":[...]}
+// Einheiten wie bei StatsHistogram. Rückgabe wie bei snprintf.
+static constexpr int STATS_JSON_PARTS = 3;
+size_t generateStatsJSON(char* buffer, size_t size, int part);
+
+#endif // STATS_H
@@ -0,0 +1,148 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(size_t capacity) :
+  timers_(new Timer[capacity < NO_TIMER ? capacity : NO_TIMER]),
+  heads_(new uint16_t[BUCKETS + 1]),
+  freeIds_(new uint16_t[capacity < NO_TIMER ? capacity : NO_TIMER]),
+  freeCount_(0),
+  capacity_(capacity < NO_TIMER ? capacity : NO_TIMER),
+  armedCount_(0),
+  current_(0) {
+  for (size_t bucket = 0; bucket <= BUCKETS; bucket++) {
+    heads_[bucket] = NO_TIMER;
+  }
+  // Niedrige Nummern zuerst vergeben
+  for (size_t id = capacity_; id > 0; id--) {
+    Timer& timer = timers_[id - 1];
+    timer.owner = NO_MAC_ADDRESS;
+    timer.deadline = 0;
+    timer.next = NO_TIMER;
+    timer.prev = NO_TIMER;
+    timer.bucket = NO_BUCKET;
+    timer.tag = 0;
+    freeIds_[freeCount_++] = (uint16_t)(id - 1);
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  delete[] timers_;
+  delete[] heads_;
+  delete[] freeIds_;
+}
+
+uint16_t TimerWheel::acquire(MacAddress address) {
+  if (freeCount_ == 0) {
+    return NO_TIMER;
+  }
+  uint16_t id = freeIds_[--freeCount_];
+  timers_[id].owner = address;
+  return id;
+}
+
+void TimerWheel::release(uint16_t id) {
+  if (id >= capacity_ || timers_[id].owner == NO_MAC_ADDRESS) {
+    return;
+  }
+  cancel(id);
+  timers_[id].owner = NO_MAC_ADDRESS;
+  freeIds_[freeCount_++] = id;
+}
+
+void TimerWheel::arm(uint16_t id, uint32_t deadline, uint8_t tag) {
+  if (id >= capacity_) {
+    return;
+  }
+  cancel(id);
+  timers_[id].deadline = deadline;
+  timers_[id].tag = tag;
+  place(id);
+  armedCount_++;
+}
+
+void TimerWheel::cancel(uint16_t id) {
+  if (id >= capacity_ || timers_[id].bucket == NO_BUCKET) {
+    return;
+  }
+  unlink(id);
+}
+
+size_t TimerWheel::bucketFor(uint32_t deadline) const {
+  int32_t signedDelta = (int32_t)(deadline - current_);
+  if (signedDelta < 0) {
+    return FIRING_BUCKET;  // Millisekunde schon bearbeitet
+  }
+  uint32_t delta = (uint32_t)signedDelta;
+  if (delta < LEVEL0_SIZE) {
+    return deadline & LEVEL0_MASK;
+  }
+  if (delta > MAX_DELTA) {
+    delta = MAX_DELTA;
+    deadline = current_ + MAX_DELTA;
+  }
+  for (int level = 1; level < LEVELS; level++) {
+    int shift = levelShift(level);
+    if (delta < (1u << (shift + LEVEL_BITS)) || level == LEVELS - 1) {
+      return LEVEL0_SIZE + (level - 1) * LEVEL_SIZE + ((deadline >> shift) & (LEVEL_SIZE - 1));
+    }
+  }
+  return 0;  // nicht erreichbar
+}
+
+void TimerWheel::link(uint16_t id, size_t bucket) {
+  Timer& timer = timers_[id];
+  timer.bucket = (uint16_t)bucket;
+  timer.prev = NO_TIMER;
+  timer.next = heads_[bucket];
+  if (timer.next != NO_TIMER) {
+    timers_[timer.next].prev = id;
+  }
+  heads_[bucket] = id;
+}
+
+void TimerWheel::unlink(uint16_t id) {
+  Timer& timer = timers_[id];
+  if (timer.prev != NO_TIMER) {
+    timers_[timer.prev].next = timer.next;
+  } else {
+    heads_[timer.bucket] = timer.next;
+  }
+  if (timer.next != NO_TIMER) {
+    timers_[timer.next].prev = timer.prev;
+  }
+  timer.next = NO_TIMER;
+  timer.prev = NO_TIMER;
+  timer.bucket = NO_BUCKET;
+  armedCount_--;
+}
+
+void TimerWheel::place(uint16_t id) {
+  link(id, bucketFor(timers_[id].deadline));
+}
+
+void TimerWheel::moveBucket(size_t from, size_t to) {
+  for (uint16_t id = heads_[from]; id != NO_TIMER; id = timers_[id].next) {
+    timers_[id].bucket = (uint16_t)to;
+  }
+  heads_[to] = heads_[from];
+  heads_[from] = NO_TIMER;
+}
+
+void TimerWheel::cascade() {
+  // Ebene für Ebene: den Platz des gerade beginnenden Umlaufs neu einsortieren;
+  // die nächste Ebene nur, wenn auch diese Ebene gerade von vorn beginnt
+  for (int level = 1; level < LEVELS; level++) {
+    int shift = levelShift(level);
+    uint32_t index = (current_ >> shift) & (LEVEL_SIZE - 1);
+    size_t bucket = LEVEL0_SIZE + (level - 1) * LEVEL_SIZE + index;
+    uint16_t id = heads_[bucket];
+    heads_[bucket] = NO_TIMER;
+    while (id != NO_TIMER) {
+      uint16_t next = timers_[id].next;
+      place(id);
+      id = next;
+    }
+    if (index != 0) {
+      break;
+    }
+  }
+}
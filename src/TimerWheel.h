@@ -0,0 +1,139 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "MacAddress.h"
+
+// Hierarchisches Zeitrad mit 1 ms Auflösung für die Fristen der Geräte in
+// deviceTable.
+//
+// Jeder Timer gehört einer Adresse (acquire) und hat höchstens eine Frist mit
+// einer frei wählbaren Marke (tag). arm() und cancel() kosten O(1): der Timer
+// wird in eine doppelt verkettete Liste umgehängt. Ebene 0 hat einen Platz pro
+// Millisekunde (256 ms), jede weitere Ebene 64 Plätze für je einen ganzen
+// Umlauf der Ebene darunter (16 s, 17 min, 18 h). Fernere Fristen werden bei
+// jedem Umlauf eine Ebene tiefer einsortiert; Fristen über 18 h hinaus
+// werden auf 18 h gekürzt und dann neu einsortiert.
+//
+// advance(now) läuft Millisekunde für Millisekunde bis now und ruft für jeden
+// fälligen Timer onExpired auf. Die Kosten hängen von der vergangenen Zeit und
+// der Zahl der fälligen Timer ab, nicht von der Zahl der Timer insgesamt. Ohne
+// laufende Timer springt das Rad direkt nach now.
+class TimerWheel {
+public:
+  static constexpr uint16_t NO_TIMER = 0xFFFF;
+
+  explicit TimerWheel(size_t capacity);
+  ~TimerWheel();
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Freier Timer für address (nicht gestellt); NO_TIMER, wenn alle vergeben sind
+  uint16_t acquire(MacAddress address);
+  void release(uint16_t id);
+  bool owns(uint16_t id, MacAddress address) const {
+    return id < capacity_ && timers_[id].owner == address;
+  }
+
+  // Gibt Timer frei, für die isStale(MacAddress, uint16_t id) true liefert
+  template <typename F>
+  void reclaim(F&& isStale) {
+    for (size_t id = 0; id < capacity_; id++) {
+      if (timers_[id].owner != NO_MAC_ADDRESS && isStale(timers_[id].owner, (uint16_t)id)) {
+        release((uint16_t)id);
+      }
+    }
+  }
+
+  // Stellt den Timer (neu) auf deadline (millis()); eine schon vergangene Frist
+  // läuft beim nächsten advance ab, auch wenn now gleich bleibt
+  void arm(uint16_t id, uint32_t deadline, uint8_t tag);
+  void cancel(uint16_t id);
+  bool armed(uint16_t id) const { return timers_[id].bucket != NO_BUCKET; }
+
+  // Ruft onExpired(uint16_t id) für jeden Timer mit deadline <= now auf. Der
+  // Timer ist dabei schon abgelaufen und darf neu gestellt oder freigegeben werden.
+  template <typename F>
+  size_t advance(uint32_t now, F&& onExpired) {
+    if (armedCount_ == 0) {
+      current_ = now + 1;
+      return 0;
+    }
+    size_t fired = fireDue(onExpired);
+    while ((int32_t)(now - current_) >= 0) {
+      if (armedCount_ == 0) {
+        current_ = now + 1;
+        break;
+      }
+      if ((current_ & LEVEL0_MASK) == 0) {
+        cascade();
+      }
+      moveBucket(current_ & LEVEL0_MASK, FIRING_BUCKET);
+      // Erst weiterzählen: was onExpired auf diese Millisekunde stellt, ist
+      // damit schon fällig und landet nicht einen Umlauf später in Ebene 0
+      current_++;
+      fired += fireDue(onExpired);
+    }
+    return fired;
+  }
+
+  MacAddress owner(uint16_t id) const { return timers_[id].owner; }
+  uint32_t deadline(uint16_t id) const { return timers_[id].deadline; }
+  uint8_t tag(uint16_t id) const { return timers_[id].tag; }
+  size_t armedCount() const { return armedCount_; }
+  size_t capacity() const { return capacity_; }
+
+private:
+  static constexpr int LEVEL0_BITS = 8;
+  static constexpr int LEVEL_BITS = 6;
+  static constexpr int LEVELS = 4;
+  static constexpr uint32_t LEVEL0_SIZE = 1u << LEVEL0_BITS;
+  static constexpr uint32_t LEVEL0_MASK = LEVEL0_SIZE - 1;
+  static constexpr uint32_t LEVEL_SIZE = 1u << LEVEL_BITS;
+  static constexpr uint32_t MAX_DELTA = (1u << (LEVEL0_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+  static constexpr size_t BUCKETS = LEVEL0_SIZE + (LEVELS - 1) * LEVEL_SIZE;
+  static constexpr size_t FIRING_BUCKET = BUCKETS;  // Fällige Timer, auch schon beim Stellen
+  static constexpr uint16_t NO_BUCKET = 0xFFFF;
+
+  struct Timer {
+    MacAddress owner;
+    uint32_t deadline;
+    uint16_t next;
+    uint16_t prev;
+    uint16_t bucket;
+    uint8_t tag;
+  };
+
+  static int levelShift(int level) { return LEVEL0_BITS + (level - 1) * LEVEL_BITS; }
+  size_t bucketFor(uint32_t deadline) const;
+  void link(uint16_t id, size_t bucket);
+  void unlink(uint16_t id);
+  void place(uint16_t id);
+  void moveBucket(size_t from, size_t to);
+  void cascade();
+
+  // Arbeitet FIRING_BUCKET ab. Was onExpired mit vergangener Frist neu stellt,
+  // landet wieder dort und läuft noch in derselben Schleife ab.
+  template <typename F>
+  size_t fireDue(F& onExpired) {
+    size_t fired = 0;
+    while (heads_[FIRING_BUCKET] != NO_TIMER) {
+      uint16_t id = heads_[FIRING_BUCKET];
+      unlink(id);
+      fired++;
+      onExpired(id);
+    }
+    return fired;
+  }
+
+  Timer* timers_;
+  uint16_t* heads_;  // BUCKETS + 1 Listenköpfe
+  uint16_t* freeIds_;
+  size_t freeCount_;
+  size_t capacity_;
+  size_t armedCount_;
+  uint32_t current_;  // Nächste zu bearbeitende Millisekunde
+};
+
+#endif // TIMERWHEEL_H
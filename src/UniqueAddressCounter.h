@@ -0,0 +1,67 @@
+#ifndef UNIQUEADDRESSCOUNTER_H
+#define UNIQUEADDRESSCOUNTER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "MacAddress.h"
+
+// Counts distinct MAC addresses in a fixed bitmap of 2^LOG2_BITS bits
+// (linear counting): add() sets one hashed bit, count() estimates the number
+// of distinct addresses from the share of bits still clear. Memory and cost
+// per address are constant however many devices are around; the estimate is
+// exact as long as no two addresses share a bit and within a few percent up
+// to about as many addresses as there are bits.
+//
+// Not synchronized: add() must only be called from one task, clear() and
+// count() only while no add() can run (e.g. between two scan windows).
+template <unsigned LOG2_BITS>
+class UniqueAddressCounter {
+  static_assert(LOG2_BITS >= 5 && LOG2_BITS <= 16, "UniqueAddressCounter: 32 to 65536 bits");
+
+public:
+  static constexpr size_t BITS = (size_t)1 << LOG2_BITS;
+
+  UniqueAddressCounter() { clear(); }
+
+  void add(MacAddress mac) {
+    // The estimate assumes randomly placed bits. Fibonacci hashing (as in
+    // MacHashTable) spreads consecutive addresses more evenly than that and
+    // would overcount, so use the full MurmurHash3 finalizer instead.
+    uint64_t h = mac;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    uint32_t bit = (uint32_t)(h >> (64 - LOG2_BITS));
+    uint32_t mask = 1u << (bit & 31);
+    uint32_t& word = words_[bit >> 5];
+    if ((word & mask) == 0) {
+      word |= mask;
+      setBits_++;
+    }
+  }
+
+  void clear() {
+    memset(words_, 0, sizeof(words_));
+    setBits_ = 0;
+  }
+
+  size_t count() const {
+    if (setBits_ == 0) {
+      return 0;
+    }
+    // All bits set: the estimate is unbounded, report the saturation point
+    size_t clearBits = setBits_ < BITS ? BITS - setBits_ : 1;
+    double estimate = -(double)BITS * log((double)clearBits / BITS);
+    return (size_t)(estimate + 0.5);
+  }
+
+private:
+  uint32_t words_[BITS / 32];
+  size_t setBits_;
+};
+
+#endif // UNIQUEADDRESSCOUNTER_H
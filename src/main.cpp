@@ -6,12 +6,34 @@
 #include "JsonUtils.h"
 #include "MeshtasticComm.h"
 #include "ConfigManager.h"
+#include "Pipeline.h"
+#include "AdvertisementCapture.h"
+#include "Log.h"
+#include "ReportBatch.h"
+#include "AdaptiveScan.h"
+#include "Stats.h"
+#include "MemoryGovernor.h"
 
 // Last time JSON was output
 unsigned long lastJsonOutput = 0;
 
+// Print brief summary to serial
+static void printScanSummary(int deviceCount) {
+  Serial.print("Geräte gefunden: ");
+  Serial.print(deviceCount);
+  Serial.print(" (");
+  Serial.print(devicesInRangeCount);
+  Serial.print(" innerhalb Schwellenwert)");
+  if (bleScanner.isContinuous()) {
+    Serial.printf(", Ring: max %u/%u belegt, %u verworfen", (unsigned)bleScanner.getMaxQueueFill(),
+                  (unsigned)ADVERTISEMENT_QUEUE_LENGTH, (unsigned)bleScanner.getDroppedEvents());
+  }
+  Serial.println();
+}
+
 void setup() {
   Serial.begin(115200);
+  initLog();
   // Warte kurz, aber nicht endlos auf die serielle Verbindung
   delay(1000);
   
@@ -44,8 +66,11 @@ void setup() {
   Serial.println("Dynamische Konfiguration über Meshtastic: Aktiv");
   Serial.println("Bereit zum Empfang von Konfigurationsbefehlen über Meshtastic UART...");
   
-  // Initialize device filter (now managed by ConfigManager)
-  parseDeviceFilter();
+  // Device filter is initialized and loaded by ConfigManager
+  Serial.printf("MAC-Filter: %s, %u Adresse(n)\n", ConfigManager::getUseDeviceFilter() ? "aktiv" : "inaktiv",
+                (unsigned)filteredDevices.size());
+  Serial.printf("Gerätetabelle: %u Geräte, %u Byte pro Eintrag, Namensvorrat %u Byte\n",
+                (unsigned)deviceTable.capacity(), (unsigned)sizeof(DeviceInfo), (unsigned)namePool.bytes());
   
   Serial.println("=====================================================");
   
@@ -59,55 +84,80 @@ void setup() {
   // Initialize tracking variables
   initBeaconTracking();
   
+  // Verarbeitungsstufe (eigener Task im Dauerscan) vorbereiten
+  initPipeline();
+  
+  // Im Dauerscan läuft der Scan ab hier im Hintergrund
+  if (bleScanner.isContinuous()) {
+    bleScanner.startContinuous();
+  }
+  
   // Initialize timing
   lastJsonOutput = millis();
 }
 
 void loop() {
+  unsigned long loopStart = micros();
+  
   // Check for incoming Meshtastic configuration commands
   checkForMeshtasticCommands();
-  
-  // Reset counter for devices in range
-  devicesInRangeCount = 0;
-  
-  // Start scanning
-  int deviceCount = bleScanner.scan();
-  
-  // Count devices within threshold (using dynamic threshold)
-  for (auto const& pair : deviceInfoMap) {
-    std::string address = pair.first;
-    DeviceInfo device = pair.second;
+  // Geänderte Konfiguration erst nach einer Ruhephase ins NVS schreiben
+  ConfigManager::runPersistence(millis());
+  
+  if (bleScanner.isContinuous()) {
+#if !PIPELINE_USE_TASK
+    // Ohne eigenen Task läuft die Verarbeitungsstufe hier
+    runProcessingStage();
+#endif
+    
+    // Beacon im Sparbetrieb gehört: Fenster abbrechen und mit voller Leistung neu starten.
+    // Ebenso bei Speicherdruck, damit NimBLE die Ergebnisse des Fensters freigibt.
+    if (isScanRampUpPending() || takeScanResultRelease()) {
+      bleScanner.stopScanWindow();
+    }
     
-    // Skip devices not in our filter (if filter is active)
-    if (!isDeviceInFilter(address)) {
-      continue;
+    // Abgelaufenes Scan-Fenster sofort neu starten, damit das Radio kaum pausiert
+    int deviceCount = 0;
+    if (bleScanner.pollScanWindow(deviceCount)) {
+      bleScanner.clearResults();
+      bleScanner.startContinuous();
+      printScanSummary(deviceCount);
     }
+  } else {
+    // Start scanning
+    int deviceCount = bleScanner.scan();
+    
+    runMemoryGovernor(millis());
+    flushFilterBank();
+    countDevicesInRange();
     
-    if (device.filteredDistance <= ConfigManager::getDistanceThreshold() && 
-        (millis() - device.lastSeen) < 30000) {
-      devicesInRangeCount++;
+    // Find and track closest beacon for UART output
+    findAndTrackClosestBeacon();
+    if (isTrackingBeacon()) {
+      noteTrackedBeacon(millis());
     }
+    flushBeaconReports(millis());
+    
+    printScanSummary(deviceCount);
   }
   
-  // Find and track closest beacon for UART output
-  findAndTrackClosestBeacon();
-  
-  // Print brief summary to serial
-  Serial.print("Geräte gefunden: ");
-  Serial.print(deviceCount);
-  Serial.print(" (");
-  Serial.print(devicesInRangeCount);
-  Serial.println(" innerhalb Schwellenwert)");
+  // Ausgabestufe: fertige Meldungen an Meshtastic senden
+  runOutputStage();
+  runCaptureOutput(Serial);
+#if !PIPELINE_USE_TASK
+  runLogDrain();
+#endif
   
   // Print status at regular intervals
   static unsigned long lastStatusPrint = 0;
   unsigned long currentMillis = millis();
   if (currentMillis - lastStatusPrint > 10000) {
     lastStatusPrint = currentMillis;
+    DeviceDataLock lock;
     
-    if (!getCurrentClosestBeaconAddress().empty()) {
+    if (getCurrentClosestBeaconAddress() != NO_MAC_ADDRESS) {
       Serial.print("Aktuell verfolgter Beacon: ");
-      Serial.print(getCurrentClosestBeaconAddress().c_str());
+      Serial.print(macToString(getCurrentClosestBeaconAddress()).text);
       Serial.print(" (Distanz: ");
       Serial.print(getCurrentClosestBeaconDistance());
       Serial.println(" m)");
@@ -117,14 +167,46 @@ void loop() {
     
     // Show current threshold and gateway info for reference
     Serial.printf("Gateway: %s, Distanz-Schwellenwert: %.2fm\n", GATEWAY_ID.c_str(), ConfigManager::getDistanceThreshold());
+    
+    // Wirkung des Sendefensters
+    Serial.printf("Beacon-Meldungen: %u, davon %u ersetzt; %u Nachrichten gesendet, %u eingespart\n",
+                  (unsigned)getQueuedBeaconReports(), (unsigned)getCoalescedBeaconReports(),
+                  (unsigned)getSentReportMessages(), (unsigned)getSavedReportMessages());
+    
+    // Geschätzte Empfangszeit des Funkteils seit dem Start
+    unsigned long uptime = currentMillis > 0 ? currentMillis : 1;
+    Serial.printf("Scan: %s, Funk an ca. %lu von %lu s (%u%%), davon %lu s im Sparbetrieb; %.1f Beacon-Adv/s\n",
+                  getScanMode() == SCAN_MODE_IDLE ? "Sparbetrieb" : "volle Leistung",
+                  (unsigned long)(getRadioOnMs() / 1000), uptime / 1000,
+                  (unsigned)((uint64_t)getRadioOnMs() * 100 / uptime), (unsigned long)(getScanIdleMs() / 1000),
+                  getFilteredAdvertisementRate());
+    
+    // Speicherwächter: freier Heap, Stufe und Grund der gelöschten Geräte
+    Serial.printf("Heap: %u frei, größter Block %u; Stufe %d, %u/%u Geräte (max %u); "
+                  "gelöscht: %u voll, %u inaktiv, %u Obergrenze\n",
+                  (unsigned)ESP.getFreeHeap(), (unsigned)ESP.getMaxAllocHeap(), (int)getMemoryPressure(),
+                  (unsigned)deviceTable.size(), (unsigned)getDeviceCap(), (unsigned)deviceTable.capacity(),
+                  (unsigned)getDeviceEvictions(EVICT_TABLE_FULL), (unsigned)getDeviceEvictions(EVICT_IDLE),
+                  (unsigned)getDeviceEvictions(EVICT_CAP));
   }
   
   // Output detailed JSON at intervals to serial
   if (millis() - lastJsonOutput >= JSON_OUTPUT_INTERVAL) {
+    DeviceDataLock lock;
     outputDevicesAsJson();
     lastJsonOutput = millis();
   }
   
   // Clear scan results to free memory
-  bleScanner.clearResults();
+  if (!bleScanner.isContinuous()) {
+    bleScanner.clearResults();
+  }
+  
+  recordStat(STATS_LOOP, micros() - loopStart);
+  
+  // Im Dauerscan kehrt loop() sofort zurück: bis zur nächsten Arbeit schlafen
+  // statt Kern 1 für Tasks niedrigerer Priorität (Protokoll, IDLE) zu blockieren
+  if (bleScanner.isContinuous()) {
+    waitForLoopWork(LOOP_IDLE_WAIT);
+  }
 }
\ No newline at end of file
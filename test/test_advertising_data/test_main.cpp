@@ -0,0 +1,257 @@
+// Host-Tests fuer parseAdvertisingData mit fehlerhaften und Grenzfall-Payloads:
+// abgeschnittene AD-Strukturen, Felder ohne Daten, die Laengenpruefung des
+// iBeacon-Rahmens, zu kurze Eddystone-Rahmen und die Reihenfolge von
+// verkuerztem und vollstaendigem Namen.
+//
+//   pio test -e native_test -f test_advertising_data
+
+#include <unity.h>
+#include <cstring>
+#include <vector>
+#include "AdvertisingData.h"
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+// AD-Struktur: Laenge (Typ + Daten), Typ, Daten
+Bytes field(uint8_t type, const Bytes& data) {
+  Bytes result;
+  result.push_back((uint8_t)(data.size() + 1));
+  result.push_back(type);
+  result.insert(result.end(), data.begin(), data.end());
+  return result;
+}
+
+Bytes join(std::initializer_list<Bytes> parts) {
+  Bytes result;
+  for (const Bytes& part : parts) {
+    result.insert(result.end(), part.begin(), part.end());
+  }
+  return result;
+}
+
+Bytes text(const char* value) {
+  return Bytes(value, value + strlen(value));
+}
+
+// Herstellerdaten eines iBeacons: 4C 00 02 15, UUID, Major, Minor, Leistung
+Bytes iBeaconData() {
+  Bytes data = {0x4C, 0x00, 0x02, 0x15};
+  for (uint8_t i = 0; i < 16; i++) {
+    data.push_back((uint8_t)(0xA0 + i));
+  }
+  data.insert(data.end(), {0x12, 0x34, 0x56, 0x78, 0xC5});
+  return data;
+}
+
+// Die Felder zeigen in den Payload; er muss bis zur Pruefung leben
+Bytes parsedPayload;
+
+bool parse(const Bytes& payload, AdvertisingData& out) {
+  parsedPayload = payload;
+  return parseAdvertisingData(parsedPayload.data(), parsedPayload.size(), out);
+}
+
+bool viewEquals(const ByteView& view, const Bytes& expected) {
+  return view.present() && view.length == expected.size() &&
+         memcmp(view.data, expected.data(), expected.size()) == 0;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_payload() {
+  AdvertisingData data;
+  TEST_ASSERT_TRUE(parseAdvertisingData(nullptr, 0, data));
+  TEST_ASSERT_FALSE(data.name.present());
+  TEST_ASSERT_FALSE(data.manufacturerData.present());
+  TEST_ASSERT_FALSE(data.hasTxPower);
+
+  // Nur ein Laengenbyte
+  Bytes lone = {0x05};
+  TEST_ASSERT_TRUE(parse(lone, data));
+  TEST_ASSERT_FALSE(data.name.present());
+}
+
+void test_truncated_structure_keeps_earlier_fields() {
+  Bytes payload = join({field(0x0A, {0xF4}), field(0x09, text("Beacon"))});
+  payload.pop_back();
+
+  AdvertisingData data;
+  TEST_ASSERT_FALSE(parse(payload, data));
+  TEST_ASSERT_TRUE(data.hasTxPower);
+  TEST_ASSERT_EQUAL_INT(-12, data.txPower);
+  TEST_ASSERT_FALSE(data.name.present());
+}
+
+void test_length_beyond_payload() {
+  // Laenge 0xFF, aber nur zwei Bytes folgen
+  Bytes payload = join({field(0x08, text("ab")), {0xFF, 0xFF, 0x4C, 0x00}});
+
+  AdvertisingData data;
+  TEST_ASSERT_FALSE(parse(payload, data));
+  TEST_ASSERT_TRUE(viewEquals(data.name, text("ab")));
+  TEST_ASSERT_FALSE(data.manufacturerData.present());
+  TEST_ASSERT_FALSE(data.hasManufacturerId);
+}
+
+void test_zero_length_ends_payload() {
+  // Laenge 0 ist Auffuellung; was danach kommt, zaehlt nicht
+  Bytes payload = join({field(0x0A, {0x04}), {0x00}, field(0x09, text("late"))});
+
+  AdvertisingData data;
+  TEST_ASSERT_TRUE(parse(payload, data));
+  TEST_ASSERT_TRUE(data.hasTxPower);
+  TEST_ASSERT_EQUAL_INT(4, data.txPower);
+  TEST_ASSERT_FALSE(data.name.present());
+}
+
+void test_fields_without_data() {
+  // Nur das Typbyte: Laenge 1
+  Bytes payload = join({field(0x09, {}), field(0xFF, {}), field(0x0A, {}), field(0x03, {}),
+                        field(0x03, {0xAA, 0xFE}), field(0x16, {})});
+
+  AdvertisingData data;
+  TEST_ASSERT_TRUE(parse(payload, data));
+  TEST_ASSERT_TRUE(data.name.present());
+  TEST_ASSERT_EQUAL_UINT8(0, data.name.length);
+  TEST_ASSERT_TRUE(data.manufacturerData.present());
+  TEST_ASSERT_FALSE(data.hasManufacturerId);
+  TEST_ASSERT_FALSE(data.hasTxPower);
+  TEST_ASSERT_FALSE(data.isEddystone);
+  // Die leere Liste zaehlt nicht, die folgende ersetzt sie
+  TEST_ASSERT_EQUAL_size_t(1, data.serviceUuid16Count());
+  TEST_ASSERT_TRUE(viewEquals(data.serviceUuids16, {0xAA, 0xFE}));
+}
+
+void test_uuid_list_ignores_partial_uuid() {
+  Bytes payload = join({field(0x03, {0x0D, 0x18, 0x0F}), field(0x07, Bytes(15, 0x11))});
+
+  AdvertisingData data;
+  TEST_ASSERT_TRUE(parse(payload, data));
+  TEST_ASSERT_EQUAL_size_t(1, data.serviceUuid16Count());
+  TEST_ASSERT_EQUAL_UINT8(2, data.serviceUuids16.length);
+  TEST_ASSERT_FALSE(data.serviceUuids128.present());
+}
+
+void test_ibeacon_requires_25_bytes() {
+  AdvertisingData data;
+  TEST_ASSERT_TRUE(parse(field(0xFF, iBeaconData()), data));
+  TEST_ASSERT_TRUE(data.isIBeacon);
+  TEST_ASSERT_EQUAL_HEX16(0x004C, data.manufacturerId);
+  TEST_ASSERT_EQUAL_HEX8(0xA0, data.iBeacon.uuid[0]);
+  TEST_ASSERT_EQUAL_HEX8(0xAF, data.iBeacon.uuid[15]);
+  TEST_ASSERT_EQUAL_HEX16(0x1234, data.iBeacon.major);
+  TEST_ASSERT_EQUAL_HEX16(0x5678, data.iBeacon.minor);
+  TEST_ASSERT_EQUAL_INT(-59, data.iBeacon.measuredPower);
+  TEST_ASSERT_TRUE(data.hasMeasuredPower);
+  TEST_ASSERT_EQUAL_INT(-59, data.measuredPower);
+
+  Bytes shorter = iBeaconData();
+  shorter.pop_back();
+  TEST_ASSERT_TRUE(parse(field(0xFF, shorter), data));
+  TEST_ASSERT_FALSE(data.isIBeacon);
+  TEST_ASSERT_TRUE(data.hasManufacturerId);
+  TEST_ASSERT_FALSE(data.hasMeasuredPower);
+
+  Bytes longer = iBeaconData();
+  longer.push_back(0x00);
+  TEST_ASSERT_TRUE(parse(field(0xFF, longer), data));
+  TEST_ASSERT_FALSE(data.isIBeacon);
+
+  Bytes otherType = iBeaconData();
+  otherType[2] = 0x03;
+  TEST_ASSERT_TRUE(parse(field(0xFF, otherType), data));
+  TEST_ASSERT_FALSE(data.isIBeacon);
+
+  Bytes otherCompany = iBeaconData();
+  otherCompany[0] = 0x59;
+  TEST_ASSERT_TRUE(parse(field(0xFF, otherCompany), data));
+  TEST_ASSERT_FALSE(data.isIBeacon);
+  TEST_ASSERT_EQUAL_HEX16(0x0059, data.manufacturerId);
+}
+
+void test_manufacturer_data_with_one_byte() {
+  AdvertisingData data;
+  TEST_ASSERT_TRUE(parse(field(0xFF, {0x4C}), data));
+  TEST_ASSERT_TRUE(data.manufacturerData.present());
+  TEST_ASSERT_EQUAL_UINT8(1, data.manufacturerData.length);
+  TEST_ASSERT_FALSE(data.hasManufacturerId);
+  TEST_ASSERT_FALSE(data.isIBeacon);
+}
+
+void test_eddystone_short_frames() {
+  AdvertisingData data;
+
+  // Nur die Service-UUID, kein Rahmentyp
+  TEST_ASSERT_TRUE(parse(field(0x16, {0xAA, 0xFE}), data));
+  TEST_ASSERT_FALSE(data.isEddystone);
+
+  // UID-Typ ohne Sendeleistung (3 Byte)
+  TEST_ASSERT_TRUE(parse(field(0x16, {0xAA, 0xFE, EDDYSTONE_UID}), data));
+  TEST_ASSERT_TRUE(data.isEddystone);
+  TEST_ASSERT_EQUAL_HEX8(EDDYSTONE_UID, data.eddystone.frameType);
+  TEST_ASSERT_FALSE(data.eddystone.hasTxPower);
+  TEST_ASSERT_EQUAL_UINT8(0, data.eddystone.data.length);
+  TEST_ASSERT_FALSE(data.hasMeasuredPower);
+
+  // Kleinster UID-Rahmen mit Sendeleistung (4 Byte)
+  TEST_ASSERT_TRUE(parse(field(0x16, {0xAA, 0xFE, EDDYSTONE_UID, 0xEE}), data));
+  TEST_ASSERT_TRUE(data.eddystone.hasTxPower);
+  TEST_ASSERT_EQUAL_INT(-18, data.eddystone.txPowerAt0m);
+  TEST_ASSERT_EQUAL_UINT8(0, data.eddystone.data.length);
+  TEST_ASSERT_TRUE(data.hasMeasuredPower);
+  TEST_ASSERT_EQUAL_INT(-59, data.measuredPower);
+
+  // TLM hat keine Sendeleistung, das vierte Byte gehoert zu den Daten
+  TEST_ASSERT_TRUE(parse(field(0x16, {0xAA, 0xFE, EDDYSTONE_TLM, 0x00}), data));
+  TEST_ASSERT_TRUE(data.isEddystone);
+  TEST_ASSERT_FALSE(data.eddystone.hasTxPower);
+  TEST_ASSERT_EQUAL_UINT8(1, data.eddystone.data.length);
+  TEST_ASSERT_FALSE(data.hasMeasuredPower);
+
+  // Andere Service-UUID
+  TEST_ASSERT_TRUE(parse(field(0x16, {0x0F, 0x18, EDDYSTONE_UID, 0xEE}), data));
+  TEST_ASSERT_FALSE(data.isEddystone);
+}
+
+void test_complete_name_wins_over_short_name() {
+  AdvertisingData data;
+  TEST_ASSERT_TRUE(parse(join({field(0x08, text("Bcn")), field(0x09, text("Beacon 1"))}), data));
+  TEST_ASSERT_TRUE(viewEquals(data.name, text("Beacon 1")));
+
+  TEST_ASSERT_TRUE(parse(join({field(0x09, text("Beacon 1")), field(0x08, text("Bcn"))}), data));
+  TEST_ASSERT_TRUE(viewEquals(data.name, text("Beacon 1")));
+
+  // Nur der verkuerzte Name
+  TEST_ASSERT_TRUE(parse(field(0x08, text("Bcn")), data));
+  TEST_ASSERT_TRUE(viewEquals(data.name, text("Bcn")));
+
+  // Mehrere vollstaendige Namen: der erste
+  TEST_ASSERT_TRUE(parse(join({field(0x09, text("first")), field(0x09, text("second"))}), data));
+  TEST_ASSERT_TRUE(viewEquals(data.name, text("first")));
+
+  // Verkuerzter Name, dann abgeschnittener vollstaendiger Name
+  Bytes truncated = join({field(0x08, text("Bcn")), field(0x09, text("Beacon 1"))});
+  truncated.resize(truncated.size() - 3);
+  TEST_ASSERT_FALSE(parse(truncated, data));
+  TEST_ASSERT_TRUE(viewEquals(data.name, text("Bcn")));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_payload);
+  RUN_TEST(test_truncated_structure_keeps_earlier_fields);
+  RUN_TEST(test_length_beyond_payload);
+  RUN_TEST(test_zero_length_ends_payload);
+  RUN_TEST(test_fields_without_data);
+  RUN_TEST(test_uuid_list_ignores_partial_uuid);
+  RUN_TEST(test_ibeacon_requires_25_bytes);
+  RUN_TEST(test_manufacturer_data_with_one_byte);
+  RUN_TEST(test_eddystone_short_frames);
+  RUN_TEST(test_complete_name_wins_over_short_name);
+  return UNITY_END();
+}
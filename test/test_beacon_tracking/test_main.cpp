@@ -0,0 +1,165 @@
+// Host-Tests fuer das Beacon-Tracking: der verfolgte Beacon meldet sich mit
+// presence:false ("crusher":false) ab, auch wenn die Geraetetabelle waehrend
+// seiner Stille voll laeuft (MAC-Filter aus, belebte Halle) oder der
+// Speicherwaechter Metadaten verwirft und die Geraeteobergrenze senkt.
+//
+//   pio test -e native_test -f test_beacon_tracking
+
+#include <Arduino.h>
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "NativeHAL.h"
+#include "Config.h"
+#include "ConfigManager.h"
+#include "BLEScanner.h"
+#include "BeaconTracker.h"
+#include "DeviceInfo.h"
+#include "MemoryGovernor.h"
+#include "MeshtasticComm.h"
+#include "Pipeline.h"
+
+namespace {
+
+const MacAddress TRACKED = 0xC0FFEE000001ULL;
+const MacAddress CROWD = 0xAA0000000000ULL;  // Weitere Geraete ab hier, jeweils +1
+const int NEAR_RSSI = -50;  // Deutlich innerhalb des Schwellenwerts
+const int CROWD_RSSI = -57;  // Knapp innerhalb, weiter weg als der Beacon
+const uint32_t PLENTY = 1u << 20;  // Heap ohne Speicherdruck
+
+uint32_t now = 100000;
+std::string uart;
+
+void command(const std::string& fields) {
+  std::string json = std::string("{\"target\":\"") + GATEWAY_ID.c_str() + "\"," + fields + "}";
+  ConfigManager::processConfigCommand(json.c_str(), json.length());
+}
+
+void advertise(MacAddress address, int rssi, const char* name) {
+  AdvertisementEvent event;
+  memset(&event, 0, sizeof(event));
+  event.address = address;
+  event.rssi = rssi;
+  event.timestamp = now;
+  if (name != nullptr) {
+    event.hasName = true;
+    strncpy(event.name, name, sizeof(event.name) - 1);
+  }
+  processAdvertisement(event);
+}
+
+// Zeit weiterstellen, dann Verarbeitungs- und Ausgabestufe wie in loop()
+void step(uint32_t ms) {
+  now += ms;
+  NativeHAL::setMicros((uint64_t)now * 1000);
+  runProcessingStage();
+  runOutputStage();
+  uart += MeshtasticSerial.hostTakeOutput();
+}
+
+// Beacon naehert sich und wird verfolgt
+void trackBeacon(const char* name) {
+  for (int i = 0; i < 30; i++) {
+    advertise(TRACKED, NEAR_RSSI, name);
+    step(100);
+  }
+  TEST_ASSERT_TRUE(getCurrentClosestBeaconAddress() == TRACKED);
+  TEST_ASSERT_TRUE(isTrackingBeacon());
+}
+
+// Bis IN_RANGE_MAX_AGE_MS abgelaufen ist, alle 100 ms neue Geraete in der Naehe
+void crowdWhileSilent(MacAddress& next, size_t perStep) {
+  uart.clear();
+  for (uint32_t waited = 0; waited <= IN_RANGE_MAX_AGE_MS + 2 * (uint32_t)REPORT_BATCH_WINDOW; waited += 100) {
+    for (size_t i = 0; i < perStep; i++) {
+      advertise(next++, CROWD_RSSI, nullptr);
+    }
+    step(100);
+  }
+}
+
+// Eine Meldung fuer name mit "crusher":false auf dem UART
+bool reportedAbsent(const char* name) {
+  std::string expected = std::string("{\"name\":\"") + name + "\"";
+  for (size_t at = uart.find(expected); at != std::string::npos; at = uart.find(expected, at + 1)) {
+    std::string report = uart.substr(at, uart.find('}', at) - at);
+    if (report.find("\"crusher\":false") != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_full_table_keeps_tracked_beacon() {
+  trackBeacon("Tracked");
+
+  // Mehr neue Geraete, als die Tabelle fasst: ohne Schutz wuerde der
+  // stille Beacon als am laengsten nicht gesehener verdraengt
+  MacAddress next = CROWD;
+  crowdWhileSilent(next, 1);
+  TEST_ASSERT_TRUE(next - CROWD > (MacAddress)DEVICE_TABLE_CAPACITY);
+  TEST_ASSERT_TRUE(deviceTable.evictions() > 0);
+
+  TEST_ASSERT_TRUE_MESSAGE(reportedAbsent("Tracked"), uart.c_str());
+  // Danach wird ein Geraet aus der Menge verfolgt oder das Verschwinden ist erledigt
+  TEST_ASSERT_TRUE(getCurrentClosestBeaconAddress() != TRACKED || getBeaconDisappearanceReported());
+}
+
+void test_memory_pressure_keeps_tracked_beacon() {
+  trackBeacon("Shed");
+  MacAddress other = CROWD + 0x10000;
+  advertise(other, CROWD_RSSI, "Other");
+
+  // Heap knapp: erst Metadaten verwerfen, nur nicht die des Beacons
+  NativeHAL::setHeap(1024, 1024);
+  for (int i = 0; i < 20 && getMemoryPressure() == MEMORY_NORMAL; i++) {
+    advertise(TRACKED, NEAR_RSSI, "Shed");
+    step(100);
+  }
+  TEST_ASSERT_EQUAL(MEMORY_SHED_METADATA, getMemoryPressure());
+  TEST_ASSERT_EQUAL_STRING("Shed", getDeviceName(*deviceTable.find(TRACKED)));
+  TEST_ASSERT_EQUAL_STRING("Unknown", getDeviceName(*deviceTable.find(other)));
+
+  // Neuer Name wird unter Speicherdruck noch uebernommen, dann sinkt die Obergrenze
+  for (int i = 0; i < 20 && getMemoryPressure() != MEMORY_SHED_DEVICES; i++) {
+    advertise(TRACKED, NEAR_RSSI, "Renamed");
+    step(100);
+  }
+  TEST_ASSERT_EQUAL(MEMORY_SHED_DEVICES, getMemoryPressure());
+  TEST_ASSERT_EQUAL_STRING("Renamed", getDeviceName(*deviceTable.find(TRACKED)));
+
+  MacAddress next = CROWD + 0x20000;
+  size_t evictions = deviceTable.evictions();
+  crowdWhileSilent(next, 1);
+  TEST_ASSERT_EQUAL((size_t)MIN_DEVICE_CAP, getDeviceCap());
+  TEST_ASSERT_TRUE(deviceTable.evictions() > evictions);
+  TEST_ASSERT_TRUE_MESSAGE(reportedAbsent("Renamed"), uart.c_str());
+
+  NativeHAL::setHeap(PLENTY, PLENTY);
+  for (int i = 0; i < 40 && getMemoryPressure() != MEMORY_NORMAL; i++) {
+    step(100);
+  }
+  TEST_ASSERT_EQUAL(MEMORY_NORMAL, getMemoryPressure());
+}
+
+int main() {
+  FILE* devnull = fopen("/dev/null", "w");
+  Serial.hostSetSink(devnull);
+  NativeHAL::setMicros((uint64_t)now * 1000);
+  NativeHAL::setHeap(PLENTY, PLENTY);
+
+  ConfigManager::init();
+  initPipeline();
+  command("\"mac_enable\":false");
+
+  UNITY_BEGIN();
+  RUN_TEST(test_full_table_keeps_tracked_beacon);
+  RUN_TEST(test_memory_pressure_keeps_tracked_beacon);
+  return UNITY_END();
+}
@@ -0,0 +1,235 @@
+// Host-Tests fuer die Persistenz von ConfigManager gegen den Preferences-Ersatz
+// aus lib/NativeHAL: Datensatz mit Kopf und CRC-32, Zurueckweisen defekter
+// oder unbekannter Datensaetze, kuerzere Datensaetze aelterer Firmware und die
+// Migration der einzelnen Schluessel (Version 0).
+//
+// ConfigManager haelt seinen Zustand prozessweit; die Tests bauen daher
+// aufeinander auf und laufen in der Reihenfolge von main().
+//
+//   pio test -e native_test -f test_config_record
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "ConfigManager.h"
+
+namespace {
+
+const char* const NAMESPACE = "ble_config";
+const size_t HEADER_SIZE = 8;  // version (2), length (2), crc (4)
+const size_t TX_POWER_OFFSET = HEADER_SIZE + 4 * 4;  // Fuenftes Feld des Datensatzes
+const size_t LEGACY_FIELDS = 14;  // scanTime bis uplinkFormat
+
+void command(const std::string& fields) {
+  std::string json = std::string("{\"target\":\"") + GATEWAY_ID.c_str() + "\"," + fields + "}";
+  ConfigManager::processConfigCommand(json.c_str(), json.length());
+}
+
+// Gleiche CRC wie ConfigManager (CRC-32, Polynom 0xEDB88320)
+uint32_t crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+std::vector<uint8_t> readBlob() {
+  Preferences prefs;
+  prefs.begin(NAMESPACE, true);
+  std::vector<uint8_t> blob(prefs.getBytesLength("config"));
+  prefs.getBytes("config", blob.data(), blob.size());
+  prefs.end();
+  return blob;
+}
+
+void writeBlob(const std::vector<uint8_t>& blob) {
+  Preferences prefs;
+  prefs.begin(NAMESPACE, false);
+  prefs.putBytes("config", blob.data(), blob.size());
+  prefs.end();
+}
+
+// Laenge und CRC im Kopf passend zum Datensatz setzen
+void sealBlob(std::vector<uint8_t>& blob) {
+  uint16_t length = (uint16_t)(blob.size() - HEADER_SIZE);
+  uint32_t crc = crc32(blob.data() + HEADER_SIZE, length);
+  memcpy(blob.data() + 2, &length, sizeof(length));
+  memcpy(blob.data() + 4, &crc, sizeof(crc));
+}
+
+bool hasKey(const char* key) {
+  Preferences prefs;
+  prefs.begin(NAMESPACE, true);
+  bool present = prefs.isKey(key);
+  prefs.end();
+  return present;
+}
+
+MacAddress mac(const char* text) {
+  MacAddress address = NO_MAC_ADDRESS;
+  parseMacAddress(text, address);
+  return address;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// Version 0: jede Einstellung unter einem eigenen Schluessel, Liste als Text
+void test_migrates_legacy_keys() {
+  Preferences::hostReset();
+  Preferences prefs;
+  prefs.begin(NAMESPACE, false);
+  prefs.putInt("scan_time", 7);
+  prefs.putInt("scan_interval", 120);
+  prefs.putInt("scan_window", 60);
+  prefs.putBool("active_scan", false);
+  prefs.putInt("tx_power", -65);
+  prefs.putFloat("env_factor", 3.1f);
+  prefs.putFloat("dist_thresh", 2.5f);
+  prefs.putFloat("dist_corr", -0.2f);
+  prefs.putFloat("proc_noise", 0.05f);
+  prefs.putFloat("meas_noise", 0.9f);
+  prefs.putInt("window_size", 8);
+  prefs.putInt("beacon_timeout", 20);
+  prefs.putBool("use_filter", false);
+  prefs.putString("device_filter", "aa:bb:cc:dd:ee:01,aa:bb:cc:dd:ee:02");
+  prefs.end();
+
+  ConfigManager::loadFromNVS();
+
+  TEST_ASSERT_EQUAL_INT(7, ConfigManager::getScanTime());
+  TEST_ASSERT_EQUAL_INT(120, ConfigManager::getScanInterval());
+  TEST_ASSERT_EQUAL_INT(60, ConfigManager::getScanWindow());
+  TEST_ASSERT_FALSE(ConfigManager::getActiveScan());
+  TEST_ASSERT_EQUAL_INT(-65, ConfigManager::getTxPower());
+  TEST_ASSERT_EQUAL_FLOAT(3.1f, ConfigManager::getEnvironmentalFactor());
+  TEST_ASSERT_EQUAL_FLOAT(2.5f, ConfigManager::getDistanceThreshold());
+  TEST_ASSERT_EQUAL_FLOAT(-0.2f, ConfigManager::getDistanceCorrection());
+  TEST_ASSERT_EQUAL_FLOAT(0.05f, ConfigManager::getProcessNoise());
+  TEST_ASSERT_EQUAL_FLOAT(0.9f, ConfigManager::getMeasurementNoise());
+  TEST_ASSERT_EQUAL_INT(8, ConfigManager::getWindowSize());
+  TEST_ASSERT_EQUAL_INT(20, ConfigManager::getBeaconTimeout());
+  TEST_ASSERT_FALSE(ConfigManager::getUseDeviceFilter());
+  TEST_ASSERT_EQUAL_size_t(2, filteredDevices.size());
+  TEST_ASSERT_TRUE(filteredDevices.contains(mac("aa:bb:cc:dd:ee:01")));
+  TEST_ASSERT_TRUE(filteredDevices.contains(mac("aa:bb:cc:dd:ee:02")));
+
+  // Einmalig in Datensatz und Binaerliste umgeschrieben, alte Schluessel entfernt
+  TEST_ASSERT_TRUE(hasKey("config"));
+  TEST_ASSERT_TRUE(hasKey("mac_list"));
+  TEST_ASSERT_FALSE(hasKey("scan_time"));
+  TEST_ASSERT_FALSE(hasKey("tx_power"));
+  TEST_ASSERT_FALSE(hasKey("device_filter"));
+
+  // Der neue Datensatz liefert beim naechsten Start dieselben Werte
+  command("\"tx_power\":-40");
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-65, ConfigManager::getTxPower());
+  TEST_ASSERT_EQUAL_INT(8, ConfigManager::getWindowSize());
+  TEST_ASSERT_EQUAL_size_t(2, filteredDevices.size());
+}
+
+void test_round_trip() {
+  command("\"tx_power\":-71,\"window_size\":6,\"tracker\":\"velocity\",\"commit\":true");
+  command("\"tx_power\":-40,\"window_size\":3,\"tracker\":\"scalar\"");
+
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-71, ConfigManager::getTxPower());
+  TEST_ASSERT_EQUAL_INT(6, ConfigManager::getWindowSize());
+  TEST_ASSERT_EQUAL_INT(TRACKER_VELOCITY, ConfigManager::getDistanceTracker());
+}
+
+void test_rejects_corrupt_crc() {
+  std::vector<uint8_t> valid = readBlob();
+  TEST_ASSERT_TRUE(valid.size() > TX_POWER_OFFSET + 4);
+
+  // Ein gekipptes Bit im Datensatz, Kopf unveraendert
+  std::vector<uint8_t> corrupt = valid;
+  corrupt[TX_POWER_OFFSET] ^= 0x01;
+  writeBlob(corrupt);
+  command("\"tx_power\":-44");
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-44, ConfigManager::getTxPower());
+
+  // Laenge im Kopf passt nicht zum Blob
+  std::vector<uint8_t> truncated(valid.begin(), valid.end() - 4);
+  writeBlob(truncated);
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-44, ConfigManager::getTxPower());
+
+  // Kuerzer als der Kopf
+  writeBlob(std::vector<uint8_t>(valid.begin(), valid.begin() + 3));
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-44, ConfigManager::getTxPower());
+
+  writeBlob(valid);
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-71, ConfigManager::getTxPower());
+}
+
+void test_rejects_unknown_version() {
+  std::vector<uint8_t> valid = readBlob();
+  uint16_t version;
+  memcpy(&version, valid.data(), sizeof(version));
+
+  // Gueltige CRC, aber eine Version, die diese Firmware nicht kennt
+  std::vector<uint8_t> newer = valid;
+  uint16_t nextVersion = version + 1;
+  memcpy(newer.data(), &nextVersion, sizeof(nextVersion));
+  writeBlob(newer);
+  command("\"tx_power\":-44");
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-44, ConfigManager::getTxPower());
+
+  // Version 0 gibt es nur als einzelne Schluessel
+  std::vector<uint8_t> legacy = valid;
+  uint16_t zero = 0;
+  memcpy(legacy.data(), &zero, sizeof(zero));
+  writeBlob(legacy);
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-44, ConfigManager::getTxPower());
+
+  writeBlob(valid);
+}
+
+// Aeltere Firmware derselben Version schrieb weniger Felder
+void test_short_record_keeps_later_fields() {
+  std::vector<uint8_t> blob = readBlob();
+  blob.resize(HEADER_SIZE + LEGACY_FIELDS * 4);
+  sealBlob(blob);
+  writeBlob(blob);
+
+  command("\"tx_power\":-44,\"heap_budget\":12345");
+  ConfigManager::loadFromNVS();
+  TEST_ASSERT_EQUAL_INT(-71, ConfigManager::getTxPower());
+  TEST_ASSERT_EQUAL_INT(12345, ConfigManager::getHeapBudget());
+
+  // Beim naechsten Speichern in voller Laenge
+  ConfigManager::saveToNVS();
+  TEST_ASSERT_TRUE(readBlob().size() > blob.size());
+}
+
+int main() {
+  FILE* devnull = fopen("/dev/null", "w");
+  Serial.hostSetSink(devnull);
+  ConfigManager::init();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_migrates_legacy_keys);
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_rejects_corrupt_crc);
+  RUN_TEST(test_rejects_unknown_version);
+  RUN_TEST(test_short_record_keeps_later_fields);
+  return UNITY_END();
+}
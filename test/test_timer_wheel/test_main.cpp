@@ -0,0 +1,212 @@
+// Host-Tests fuer TimerWheel: advance() gegen eine einfache Fristenliste, die
+// bei jedem Schritt alle Timer durchsucht. Zufaellige Folgen aus arm, cancel
+// und advance, Fristen an den Grenzen der Ebenen und jenseits von MAX_DELTA,
+// Neustellen aus onExpired heraus und der Ueberlauf von millis() nach 2^32 ms.
+//
+//   pio test -e native_test -f test_timer_wheel
+
+#include <unity.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "TimerWheel.h"
+
+namespace {
+
+const size_t TIMERS = 64;
+const uint32_t LEVEL0_SPAN = 1u << 8;   // Ebene 0: 256 ms
+const uint32_t LEVEL1_SPAN = 1u << 14;  // Ebene 1: 16 s
+const uint32_t LEVEL2_SPAN = 1u << 20;  // Ebene 2: 17 min
+const uint32_t LEVEL3_SPAN = 1u << 26;  // Ebene 3: 18 h, groesser als MAX_DELTA
+
+bool isDue(uint32_t deadline, uint32_t now) {
+  return (int32_t)(now - deadline) >= 0;
+}
+
+// Zeitrad und Vergleichsliste nebeneinander
+struct Harness {
+  TimerWheel wheel;
+  std::vector<uint16_t> ids;
+  std::vector<bool> armed;
+  std::vector<uint32_t> deadlines;
+  std::vector<uint8_t> tags;
+  std::mt19937 random;
+  int rearmPercent = 0;  // So oft stellt onExpired den Timer neu
+  uint32_t now = 0;
+
+  Harness(uint32_t start, uint32_t seed) :
+    wheel(TIMERS), armed(TIMERS, false), deadlines(TIMERS, 0), tags(TIMERS, 0), random(seed) {
+    for (size_t i = 0; i < TIMERS; i++) {
+      ids.push_back(wheel.acquire(0x100000 + i));
+    }
+    now = start;
+    wheel.advance(now, [](uint16_t) {});
+  }
+
+  void arm(size_t i, uint32_t deadline) {
+    uint8_t tag = (uint8_t)random();
+    wheel.arm(ids[i], deadline, tag);
+    armed[i] = true;
+    deadlines[i] = deadline;
+    tags[i] = tag;
+  }
+
+  void cancel(size_t i) {
+    wheel.cancel(ids[i]);
+    armed[i] = false;
+  }
+
+  size_t indexOf(uint16_t id) const {
+    for (size_t i = 0; i < TIMERS; i++) {
+      if (ids[i] == id) {
+        return i;
+      }
+    }
+    return TIMERS;
+  }
+
+  // advance bis to; jeder Timer laeuft genau dann ab, wenn seine Frist erreicht ist
+  void advanceTo(uint32_t to) {
+    now = to;
+    size_t callbacks = 0;
+    size_t fired = wheel.advance(now, [&](uint16_t id) {
+      callbacks++;
+      size_t i = indexOf(id);
+      TEST_ASSERT_TRUE_MESSAGE(i < TIMERS, "unbekannter Timer");
+      TEST_ASSERT_TRUE_MESSAGE(armed[i], "Timer war nicht gestellt");
+      TEST_ASSERT_TRUE_MESSAGE(isDue(deadlines[i], now), "Timer zu frueh abgelaufen");
+      TEST_ASSERT_EQUAL(tags[i], wheel.tag(id));
+      TEST_ASSERT_FALSE(wheel.armed(id));
+      armed[i] = false;
+      if ((int)(random() % 100) < rearmPercent) {
+        // Auch schon faellige Fristen: die laufen noch in diesem advance ab
+        arm(i, now + (uint32_t)(random() % 600) - 100);
+      }
+    });
+    TEST_ASSERT_EQUAL(callbacks, fired);
+    check();
+  }
+
+  void check() {
+    size_t armedCount = 0;
+    for (size_t i = 0; i < TIMERS; i++) {
+      TEST_ASSERT_EQUAL(armed[i], wheel.armed(ids[i]));
+      if (armed[i]) {
+        TEST_ASSERT_FALSE_MESSAGE(isDue(deadlines[i], now), "faelliger Timer nicht abgelaufen");
+        TEST_ASSERT_EQUAL(deadlines[i], wheel.deadline(ids[i]));
+        armedCount++;
+      }
+    }
+    TEST_ASSERT_EQUAL(armedCount, wheel.armedCount());
+  }
+
+  // Zufaellige Folge aus arm, cancel und advance
+  void run(int steps, uint32_t maxDelta, uint32_t maxStep) {
+    for (int step = 0; step < steps; step++) {
+      int operations = random() % 4;
+      for (int op = 0; op < operations; op++) {
+        size_t i = random() % TIMERS;
+        int choice = random() % 10;
+        if (choice == 0) {
+          cancel(i);
+        } else if (choice == 1) {
+          arm(i, now - random() % 50);  // Schon vergangen
+        } else {
+          arm(i, now + random() % maxDelta);
+        }
+      }
+      uint32_t delta = random() % 8 == 0 ? random() % maxStep : random() % 64;
+      advanceTo(now + delta);
+    }
+  }
+};
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_random_short_deadlines() {
+  Harness harness(5000, 1);
+  harness.run(20000, 2 * LEVEL0_SPAN, 300);
+}
+
+void test_random_mixed_levels() {
+  Harness harness(123457, 2);
+  harness.run(20000, LEVEL2_SPAN, 20000);
+}
+
+void test_random_beyond_max_delta() {
+  // Fristen bis 4 x MAX_DELTA, grosse Zeitspruenge
+  Harness harness(99, 3);
+  harness.run(120, 4 * LEVEL3_SPAN, LEVEL3_SPAN + LEVEL2_SPAN);
+}
+
+void test_rearm_from_on_expired() {
+  Harness harness(777, 4);
+  harness.rearmPercent = 70;
+  harness.run(20000, LEVEL1_SPAN, 2000);
+}
+
+void test_level_boundaries() {
+  const uint32_t spans[] = {LEVEL0_SPAN, LEVEL1_SPAN, LEVEL2_SPAN, LEVEL3_SPAN};
+  // Start mitten in einem Umlauf und genau auf einer Grenze aller Ebenen
+  for (uint32_t start : {1000u, 0u, LEVEL3_SPAN}) {
+    for (uint32_t span : spans) {
+      for (int offset = -1; offset <= 1; offset++) {
+        Harness harness(start, span + offset);
+        uint32_t deadline = harness.now + span + offset;
+        harness.arm(0, deadline);
+        harness.advanceTo(deadline - 1);
+        TEST_ASSERT_TRUE(harness.wheel.armed(harness.ids[0]));
+        harness.advanceTo(deadline);
+        TEST_ASSERT_FALSE(harness.wheel.armed(harness.ids[0]));
+      }
+    }
+  }
+}
+
+void test_deadline_beyond_max_delta_fires_on_time() {
+  Harness harness(4242, 5);
+  uint32_t deadline = harness.now + 3 * LEVEL3_SPAN + 17;
+  harness.arm(0, deadline);
+  // Der gekuerzte Timer wird unterwegs neu einsortiert und laeuft erst zur Frist ab
+  for (uint32_t t = harness.now; (int32_t)(deadline - 1 - t) > 0; t += LEVEL3_SPAN / 3) {
+    harness.advanceTo(t);
+  }
+  harness.advanceTo(deadline - 1);
+  TEST_ASSERT_TRUE(harness.wheel.armed(harness.ids[0]));
+  harness.advanceTo(deadline);
+  TEST_ASSERT_FALSE(harness.wheel.armed(harness.ids[0]));
+}
+
+void test_millis_wrap() {
+  // millis() laeuft nach etwa 49 Tagen ueber
+  Harness harness(0xFFFFFFFFu - 3 * LEVEL1_SPAN, 6);
+  harness.rearmPercent = 30;
+  harness.run(20000, LEVEL1_SPAN, 400);
+  TEST_ASSERT_TRUE(harness.now < 0x80000000u);
+
+  // Frist genau auf der 0 und direkt davor
+  Harness edge(0xFFFFFFF0u, 7);
+  edge.arm(0, 0xFFFFFFFFu);
+  edge.arm(1, 0);
+  edge.advanceTo(0xFFFFFFFEu);
+  edge.advanceTo(0xFFFFFFFFu);
+  TEST_ASSERT_FALSE(edge.armed[0]);
+  TEST_ASSERT_TRUE(edge.armed[1]);
+  edge.advanceTo(0);
+  TEST_ASSERT_FALSE(edge.armed[1]);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_random_short_deadlines);
+  RUN_TEST(test_random_mixed_levels);
+  RUN_TEST(test_random_beyond_max_delta);
+  RUN_TEST(test_rearm_from_on_expired);
+  RUN_TEST(test_level_boundaries);
+  RUN_TEST(test_deadline_beyond_max_delta_fires_on_time);
+  RUN_TEST(test_millis_wrap);
+  return UNITY_END();
+}
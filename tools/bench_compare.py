@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Vergleicht zwei Benchmark-Berichte ("key=value"-Zeilen, z.B. aus bench/hotpath_bench.cpp).
+
+  bench_compare.py alt.txt neu.txt [--threshold 10]
+
+Zeilen gelten als gleiche Messung, wenn alle Schluessel ausser den Messwerten
+uebereinstimmen. Ausgegeben wird die Aenderung von ns_per_op und allocs_per_op;
+der Rueckgabewert ist 1, wenn eine Messung um mehr als --threshold Prozent
+langsamer wurde oder mehr allokiert.
+"""
+
+import argparse
+import sys
+
+METRICS = ("ns_per_op", "allocs_per_op", "ops_per_s")
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            fields = dict(item.split("=", 1) for item in line.split() if "=" in item)
+            if "ns_per_op" not in fields:
+                continue
+            key = " ".join(f"{k}={v}" for k, v in fields.items() if k not in METRICS)
+            results[key] = fields
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument("--threshold", type=float, default=10.0, help="Regressionsgrenze in Prozent")
+    args = parser.parse_args()
+
+    old = load(args.old)
+    new = load(args.new)
+    regressions = 0
+    for key, fields in new.items():
+        if key not in old:
+            print(f"{'neu':>8}  {float(fields['ns_per_op']):12.1f} ns  {key}")
+            continue
+        before = float(old[key]["ns_per_op"])
+        after = float(fields["ns_per_op"])
+        change = (after - before) / before * 100 if before > 0 else 0.0
+        allocs_before = float(old[key].get("allocs_per_op", 0))
+        allocs_after = float(fields.get("allocs_per_op", 0))
+        flag = ""
+        if change > args.threshold or allocs_after > allocs_before:
+            flag = "  <-- REGRESSION"
+            regressions += 1
+        print(f"{change:+7.1f}%  {before:12.1f} -> {after:12.1f} ns  "
+              f"allocs {allocs_before:.2f} -> {allocs_after:.2f}  {key}{flag}")
+    for key in old.keys() - new.keys():
+        print(f"{'entfallen':>8}  {key}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
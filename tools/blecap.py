@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""Werkzeug fuer Advertisement-Mitschnitte (.blecap, Format siehe src/AdvertisementCapture.h).
+
+  blecap.py extract serial.log out.blecap   "CAP:"-Zeilen eines Konsolen-Logs in eine Datei
+  blecap.py dump mitschnitt.blecap           Datensaetze lesbar ausgeben
+
+Den Log erzeugt z.B. `pio device monitor | tee serial.log` nach {"capture":true}.
+"""
+
+import base64
+import binascii
+import struct
+import sys
+
+FILE_HEADER = b"BLECAP\x01\x00"
+RECORD_HEADER = struct.Struct("<I6sBbB")
+MAX_PAYLOAD = 62
+
+
+def extract(log_path, out_path):
+    records = skipped = 0
+    with open(log_path, "rb") as log, open(out_path, "wb") as out:
+        out.write(FILE_HEADER)
+        for raw in log:
+            pos = raw.find(b"CAP:")
+            if pos < 0:
+                continue
+            try:
+                record = base64.b64decode(raw[pos + 4:].strip(), validate=True)
+            except (binascii.Error, ValueError):
+                skipped += 1
+                continue
+            # Zerschnittene oder verstuemmelte Zeilen verwerfen
+            if (len(record) < RECORD_HEADER.size
+                    or record[12] > MAX_PAYLOAD
+                    or len(record) != RECORD_HEADER.size + record[12]):
+                skipped += 1
+                continue
+            out.write(record)
+            records += 1
+    print(f"{records} Datensaetze geschrieben, {skipped} fehlerhafte Zeilen verworfen", file=sys.stderr)
+
+
+def read_records(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:7] != FILE_HEADER[:7]:
+        raise SystemExit(f"{path}: keine .blecap-Datei (Version 1)")
+    pos = len(FILE_HEADER)
+    while pos < len(data):
+        if pos + RECORD_HEADER.size > len(data):
+            raise SystemExit(f"{path}: Datensatz bei Offset {pos} abgeschnitten")
+        timestamp, address, addr_type, rssi, length = RECORD_HEADER.unpack_from(data, pos)
+        pos += RECORD_HEADER.size
+        payload = data[pos:pos + length]
+        if len(payload) != length:
+            raise SystemExit(f"{path}: Payload bei Offset {pos} abgeschnitten")
+        pos += length
+        yield timestamp, address, addr_type, rssi, payload
+
+
+def dump(path):
+    for timestamp, address, addr_type, rssi, payload in read_records(path):
+        mac = ":".join(f"{b:02x}" for b in address)
+        print(f"{timestamp:10d} {mac} type={addr_type} rssi={rssi:4d} payload={payload.hex()}")
+
+
+def main(argv):
+    if len(argv) == 4 and argv[1] == "extract":
+        extract(argv[2], argv[3])
+    elif len(argv) == 3 and argv[1] == "dump":
+        dump(argv[2])
+    else:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Referenz-Decoder fuer Beacon-Meldungen des Gateways (Format siehe src/BinaryUplink.h).
+
+  uplink_decode.py [DATEI]   liest Textzeilen (Standard: stdin) und gibt je Beacon
+                             eine JSON-Zeile mit einheitlichen Feldern aus
+
+Versteht beide Uplink-Formate: JSON ({"name":...} bzw. ein Array davon, wenn das
+Gateway mehrere Meldungen eines Sendefensters zusammenfasst) und Base64-Binaerrahmen
+der Versionen 1 und 2 (nach {"target":"BLE001","uplink":"binary"}). Ein
+vorangestellter Absendername, wie ihn Meshtastic-Clients anzeigen ("cb70: ..."),
+wird ignoriert. Zeilen, die keine Beacon-Meldung sind (Quittungen, fremde
+Nachrichten), werden uebersprungen.
+
+decode_line() laesst sich direkt in ein Backend uebernehmen.
+"""
+
+import base64
+import binascii
+import json
+import struct
+import sys
+
+FRAME_VERSION = 1
+BATCH_FRAME_VERSION = 2
+ENTRY = struct.Struct("<B3sHH")
+FLAG_PRESENT = 0x01
+
+
+def decode_entry(data, offset):
+    flags, beacon_id, decimeters, deciseconds = ENTRY.unpack_from(data, offset)
+    return {
+        "beacon_id": ":".join(f"{b:02x}" for b in beacon_id),
+        "distance": decimeters / 10.0,
+        "last_seen": deciseconds / 10.0,
+        "crusher": bool(flags & FLAG_PRESENT),
+    }
+
+
+def decode_frame(frame):
+    """Binaerrahmen -> Liste von dicts, [] wenn es kein gueltiger Rahmen ist."""
+    if len(frame) < 1:
+        return []
+    if frame[0] == FRAME_VERSION:
+        count, offset = 1, 1
+    elif frame[0] == BATCH_FRAME_VERSION and len(frame) >= 2:
+        count, offset = frame[1], 2
+    else:
+        return []
+    end = offset + count * ENTRY.size
+    if len(frame) < end:
+        return []
+    try:
+        gateway = frame[end:].decode("ascii")
+    except UnicodeDecodeError:
+        return []
+    reports = []
+    for i in range(count):
+        report = {"gateway": gateway}
+        report.update(decode_entry(frame, offset + i * ENTRY.size))
+        reports.append(report)
+    return reports
+
+
+def decode_json(text):
+    try:
+        message = json.loads(text)
+    except ValueError:
+        return []
+    entries = message if isinstance(message, list) else [message]
+    reports = []
+    for entry in entries:
+        if not isinstance(entry, dict) or "crusher" not in entry:
+            return []
+        reports.append({
+            "gateway": None,  # Im JSON-Uplink nicht enthalten
+            "name": entry.get("name"),
+            "distance": entry.get("distance"),
+            "last_seen": entry.get("last_seen"),
+            "crusher": entry.get("crusher"),
+        })
+    return reports
+
+
+def decode_line(line):
+    """Eine empfangene Textzeile -> Liste der enthaltenen Beacon-Meldungen (dicts)."""
+    text = line.strip()
+    # Absendername des Meshtastic-Clients entfernen ("cb70: {...}")
+    sender, sep, rest = text.partition(": ")
+    if sep and " " not in sender and not sender.startswith(("{", "[")):
+        text = rest.strip()
+    if text.startswith(("{", "[")):
+        return decode_json(text)
+    try:
+        frame = base64.b64decode(text, validate=True)
+    except (binascii.Error, ValueError):
+        return []
+    return decode_frame(frame)
+
+
+def main():
+    if len(sys.argv) > 2:
+        raise SystemExit(__doc__)
+    source = open(sys.argv[1], encoding="utf-8", errors="replace") if len(sys.argv) == 2 else sys.stdin
+    with source:
+        for line in source:
+            for report in decode_line(line):
+                print(json.dumps(report))
+
+
+if __name__ == "__main__":
+    main()